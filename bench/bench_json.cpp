@@ -0,0 +1,226 @@
+// JSON benchmark over Bitcoin Core reply bodies: for each one, MB/s for
+// json::parse (a heap tree), json::parse_document (what RpcClient builds from
+// a reply) and dump(), the allocations one parse makes and the most heap it
+// holds at once, how many key tables a document's objects share, and the
+// process's peak RSS at the end.
+//
+// The corpora are written into the build tree by bench/corpus/make_corpus.py;
+// see there for what they hold.
+
+#include <CLI/CLI.hpp>
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "format.hpp"
+#include "json.hpp"
+
+#ifndef BENCH_JSON_CORPUS_DIR
+#define BENCH_JSON_CORPUS_DIR "bench/corpus"
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// ============================================================================
+// Heap accounting
+//
+// Every operator new is counted, and prefixed with its size so that the bytes
+// live at once can be followed too. The aligned forms are replaced as well:
+// std::pmr's default resource, which document arenas draw from, uses them.
+// The benchmark is single-threaded.
+// ============================================================================
+namespace {
+struct Heap {
+    uint64_t allocs = 0;
+    size_t   live   = 0;
+    size_t   peak   = 0;
+};
+Heap heap;
+
+constexpr size_t kPrefix = alignof(std::max_align_t);
+
+// The size sits just below the pointer handed out, `prefix` bytes past the
+// start of the block, which keeps the block's alignment.
+void* counted_new(size_t n, size_t prefix = kPrefix) {
+    const size_t total = (n + 2 * prefix - 1) / prefix * prefix; // aligned_alloc wants a multiple
+    void*        block = prefix == kPrefix ? std::malloc(total) : std::aligned_alloc(prefix, total);
+    if (!block)
+        throw std::bad_alloc();
+    auto* p = static_cast<unsigned char*>(block) + prefix;
+    reinterpret_cast<size_t*>(p)[-1] = n;
+    ++heap.allocs;
+    heap.live += n;
+    heap.peak = std::max(heap.peak, heap.live);
+    return p;
+}
+
+void counted_delete(void* ptr, size_t prefix = kPrefix) noexcept {
+    if (!ptr)
+        return;
+    auto* p = static_cast<unsigned char*>(ptr);
+    heap.live -= reinterpret_cast<size_t*>(p)[-1];
+    std::free(p - prefix);
+}
+
+size_t prefix_for(std::align_val_t al) { return std::max(kPrefix, static_cast<size_t>(al)); }
+} // namespace
+
+void* operator new(size_t n) { return counted_new(n); }
+void* operator new[](size_t n) { return counted_new(n); }
+void* operator new(size_t n, std::align_val_t a) { return counted_new(n, prefix_for(a)); }
+void* operator new[](size_t n, std::align_val_t a) { return counted_new(n, prefix_for(a)); }
+void  operator delete(void* p) noexcept { counted_delete(p); }
+void  operator delete[](void* p) noexcept { counted_delete(p); }
+void  operator delete(void* p, size_t) noexcept { counted_delete(p); }
+void  operator delete[](void* p, size_t) noexcept { counted_delete(p); }
+void  operator delete(void* p, std::align_val_t a) noexcept { counted_delete(p, prefix_for(a)); }
+void  operator delete[](void* p, std::align_val_t a) noexcept { counted_delete(p, prefix_for(a)); }
+void  operator delete(void* p, size_t, std::align_val_t a) noexcept {
+    counted_delete(p, prefix_for(a));
+}
+void operator delete[](void* p, size_t, std::align_val_t a) noexcept {
+    counted_delete(p, prefix_for(a));
+}
+
+struct HeapUse {
+    uint64_t allocs = 0; // made by f
+    size_t   peak   = 0; // most held at once beyond what was live before f
+};
+
+template <typename F> static HeapUse heap_use(F&& f) {
+    const uint64_t allocs0 = heap.allocs;
+    const size_t   live0   = heap.live;
+    heap.peak              = live0;
+    f();
+    return {heap.allocs - allocs0, heap.peak - live0};
+}
+
+// MB/s over `bytes` per call of `f`, running it for at least `min_time`.
+template <typename F> static double throughput(size_t bytes, Clock::duration min_time, F&& f) {
+    f(); // warm up
+    int        runs  = 0;
+    const auto start = Clock::now();
+    Clock::duration elapsed{};
+    do {
+        f();
+        ++runs;
+        elapsed = Clock::now() - start;
+    } while (elapsed < min_time);
+    return static_cast<double>(bytes) * runs / std::chrono::duration<double>(elapsed).count() /
+           1e6;
+}
+
+// Objects in `v`, and the key tables they use: objects of a document with the
+// same keys share one, told apart here by where its first key points.
+static void count_objects(const json& v, size_t& objects, std::set<const char*>& key_tables) {
+    if (v.is_array()) {
+        for (const json& e : v)
+            count_objects(e, objects, key_tables);
+        return;
+    }
+    if (!v.is_object())
+        return;
+    ++objects;
+    if (!v.empty())
+        key_tables.insert((*v.items().begin()).first.data());
+    for (const auto& [key, member] : v.items())
+        count_objects(member, objects, key_tables);
+}
+
+int main(int argc, char* argv[]) {
+    CLI::App app{"bench_json — JSON parse/dump speed and memory over Bitcoin Core replies"};
+
+    std::string              corpus_dir = BENCH_JSON_CORPUS_DIR;
+    std::vector<std::string> only;
+    int                      min_ms = 500;
+
+    app.add_option("--corpus", corpus_dir, "Directory of reply bodies (*.json)");
+    app.add_option("--only", only, "Benchmark only these files (e.g. getpeerinfo.json)");
+    app.add_option("--min-time-ms", min_ms, "Minimum time per measurement")
+        ->default_val(500)
+        ->check(CLI::Range(1, 600000));
+    CLI11_PARSE(app, argc, argv);
+
+    std::vector<std::filesystem::path> files;
+    std::error_code                    ec;
+    for (const auto& entry : std::filesystem::directory_iterator(corpus_dir, ec)) {
+        const auto name = entry.path().filename().string();
+        if (entry.path().extension() == ".json" &&
+            (only.empty() || std::find(only.begin(), only.end(), name) != only.end()))
+            files.push_back(entry.path());
+    }
+    if (ec || files.empty()) {
+        std::fprintf(stderr, "bench_json: no corpus files in %s\n", corpus_dir.c_str());
+        return 1;
+    }
+    std::sort(files.begin(), files.end());
+    const auto min_time = std::chrono::milliseconds(min_ms);
+
+    std::printf("bench_json: %zu corpora from %s\n\n", files.size(), corpus_dir.c_str());
+    std::printf("  %-28s %9s %9s %9s %9s %13s %13s %11s %15s\n", "", "", "parse", "document",
+                "dump", "allocs", "allocs", "peak heap", "key tables");
+    std::printf("  %-28s %9s %9s %9s %9s %13s %13s %11s %15s\n", "corpus", "size", "MB/s", "MB/s",
+                "MB/s", "/parse", "/document", "/document", "/objects");
+    for (const auto& path : files) {
+        std::string text;
+        {
+            std::ifstream     in(path, std::ios::binary);
+            std::stringstream ss;
+            ss << in.rdbuf();
+            text = ss.str();
+        }
+        json doc;
+        try {
+            doc = json::parse_document(text);
+        } catch (const json::exception& e) {
+            std::fprintf(stderr, "bench_json: %s: %s\n", path.string().c_str(), e.what());
+            return 1;
+        }
+        const std::string dumped = doc.dump();
+
+        size_t                objects = 0;
+        std::set<const char*> key_tables;
+        count_objects(doc, objects, key_tables);
+        const std::string shared = fmt_int(static_cast<int64_t>(key_tables.size())) + "/" +
+                                   fmt_int(static_cast<int64_t>(objects));
+
+        auto parse     = [&] { const json parsed = json::parse(text); };
+        auto parse_doc = [&] { const json parsed = json::parse_document(text); };
+        auto dump      = [&] { const std::string out = doc.dump(); };
+
+        const double  parse_mbps = throughput(text.size(), min_time, parse);
+        const double  doc_mbps   = throughput(text.size(), min_time, parse_doc);
+        const double  dump_mbps  = throughput(dumped.size(), min_time, dump);
+        const HeapUse parse_heap = heap_use(parse);
+        const HeapUse doc_heap   = heap_use(parse_doc);
+
+        std::printf("  %-28s %9s %9.1f %9.1f %9.1f %13s %13s %11s %15s\n",
+                    path.filename().string().c_str(),
+                    fmt_bytes(static_cast<int64_t>(text.size())).c_str(), parse_mbps, doc_mbps,
+                    dump_mbps, fmt_int(static_cast<int64_t>(parse_heap.allocs)).c_str(),
+                    fmt_int(static_cast<int64_t>(doc_heap.allocs)).c_str(),
+                    fmt_bytes(static_cast<int64_t>(doc_heap.peak)).c_str(), shared.c_str());
+    }
+
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    const int64_t peak_rss = usage.ru_maxrss; // bytes
+#else
+    const int64_t peak_rss = static_cast<int64_t>(usage.ru_maxrss) * 1024; // KiB
+#endif
+    std::printf("\n  peak RSS  %s\n", fmt_bytes(peak_rss).c_str());
+    return 0;
+}
@@ -0,0 +1,164 @@
+// End-to-end benchmark of the poll loop: poll_rpc() drives the real RpcEngine,
+// cache and batching against a FakeBitcoind, and reports how many full poll
+// cycles per second that sustains and how long a cycle takes (p50/p90/p99).
+//
+// --tabs adds clients that call the node in a loop on the same engine, the way
+// Lua tabs do, to measure the poll cycle under contention for the pool.
+
+#include <CLI/CLI.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "fake_bitcoind.hpp"
+#include "format.hpp"
+#include "guarded.hpp"
+#include "poll.hpp"
+#include "rpc_engine.hpp"
+#include "state.hpp"
+
+using Clock = std::chrono::steady_clock;
+using std::chrono::microseconds;
+
+static microseconds percentile(const std::vector<microseconds>& sorted, double q) {
+    if (sorted.empty())
+        return microseconds{0};
+    const auto i = static_cast<size_t>(q * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(i, sorted.size() - 1)];
+}
+
+static microseconds ms_to_us(double ms) {
+    return microseconds(static_cast<int64_t>(ms * 1000.0));
+}
+
+int main(int argc, char* argv[]) {
+    CLI::App app{"bench_poll — poll_rpc() against a fake bitcoind"};
+
+    int    cycles      = 200;
+    int    warmup      = 10;
+    int    connections = 4;
+    int    tabs        = 0;
+    double latency_ms  = 0.0;
+    double jitter_ms   = 0.0;
+    bool   keep_cache  = false;
+    bool   rpc_stats   = false;
+
+    FakeBitcoindConfig node;
+    node.new_block_every = 10;
+
+    app.add_option("-n,--cycles", cycles, "Measured poll cycles")->default_val(200);
+    app.add_option("--warmup", warmup, "Unmeasured cycles first")->default_val(10);
+    app.add_option("--connections", connections, "RpcEngine pool size (--rpc-connections)")
+        ->default_val(4)
+        ->check(CLI::Range(1, 16));
+    app.add_option("--tabs", tabs, "Tab-like clients calling the node concurrently")
+        ->default_val(0);
+    app.add_flag("--cache", keep_cache,
+                 "Keep the RPC cache across cycles (default: clear it, as a 5s refresh would)");
+    app.add_flag("--rpc-stats", rpc_stats, "Print the per-method RPC latency report");
+
+    app.add_option("--latency-ms", latency_ms, "Node latency per HTTP request")->default_val(0.0);
+    app.add_option("--jitter-ms", jitter_ms, "Extra uniform random latency")->default_val(0.0);
+    app.add_option("--peers", node.peers, "getpeerinfo entries")->default_val(10);
+    app.add_option("--mempool-txs", node.mempool_txs, "Mempool size")->default_val(1000);
+    app.add_option("--pad-bytes", node.pad_bytes, "Filler bytes in every object result")
+        ->default_val(0);
+    app.add_option("--error-rate", node.error_rate, "Share of calls failing with an RPC error")
+        ->default_val(0.0)
+        ->check(CLI::Range(0.0, 1.0));
+    app.add_option("--drop-rate", node.drop_rate, "Share of requests dropped unanswered")
+        ->default_val(0.0)
+        ->check(CLI::Range(0.0, 1.0));
+    app.add_option("--new-block-every", node.new_block_every,
+                   "Poll cycles per new block (block stats refetch); 0 keeps the tip fixed")
+        ->default_val(10);
+
+    CLI11_PARSE(app, argc, argv);
+
+    node.latency = ms_to_us(latency_ms);
+    node.jitter  = ms_to_us(jitter_ms);
+
+    FakeBitcoind bitcoind(node);
+    RpcConfig    cfg = bitcoind.rpc_config();
+    cfg.timeout_seconds = 5; // dropped requests must not stall the run for long
+    auto      engine    = std::make_shared<RpcEngine>(cfg, RpcAuth{"bench", "bench"}, connections);
+    RpcClient rpc(engine, {"poll"});
+    Guarded<AppState> state;
+
+    // Tab-like load: each client walks a list of calls back to back until the
+    // measured cycles are done.
+    std::atomic<bool>        done{false};
+    std::vector<std::thread> tab_threads;
+    for (int t = 0; t < tabs; ++t) {
+        tab_threads.emplace_back([&, t] {
+            RpcClient   client(engine, {"tab" + std::to_string(t + 1)});
+            const char* methods[] = {"getblockchaininfo", "getmempoolinfo", "getpeerinfo",
+                                     "getnettotals"};
+            for (size_t i = 0; !done; ++i) {
+                try {
+                    client.call(methods[i % std::size(methods)]);
+                } catch (const RpcError&) { // NOLINT(bugprone-empty-catch) — injected failures
+                }
+            }
+        });
+    }
+
+    std::vector<microseconds> samples;
+    samples.reserve(static_cast<size_t>(cycles));
+    int        failed = 0;
+    const auto tip0   = bitcoind.tip();
+    Clock::time_point start;
+    for (int i = -warmup; i < cycles; ++i) {
+        if (i == 0) {
+            start = Clock::now();
+            engine->stats().reset();
+        }
+        if (!keep_cache)
+            engine->cache().clear();
+        const auto t0 = Clock::now();
+        poll_rpc(rpc, state);
+        const auto dt = std::chrono::duration_cast<microseconds>(Clock::now() - t0);
+        if (i < 0)
+            continue;
+        samples.push_back(dt);
+        if (!state.access([](const auto& s) { return s.connected; }))
+            ++failed;
+    }
+    const auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    done               = true;
+    for (auto& t : tab_threads)
+        t.join();
+
+    std::sort(samples.begin(), samples.end());
+    std::printf("bench_poll: %d cycles against fake bitcoind on 127.0.0.1:%d\n", cycles,
+                bitcoind.port());
+    std::printf("  node    latency %s (+%s jitter), %d peers, %d mempool txs, %s padding, "
+                "%.1f%% errors, %.1f%% drops\n",
+                fmt_latency(node.latency).c_str(), fmt_latency(node.jitter).c_str(), node.peers,
+                node.mempool_txs, fmt_bytes(static_cast<int64_t>(node.pad_bytes)).c_str(),
+                node.error_rate * 100.0, node.drop_rate * 100.0);
+    std::printf("  engine  %d connections, %d tab clients, cache %s\n\n", connections, tabs,
+                keep_cache ? "kept across cycles" : "cleared every cycle");
+    std::printf("  cycles/s  %.1f\n", elapsed > 0 ? cycles / elapsed : 0.0);
+    std::printf("  p50       %s\n", fmt_latency(percentile(samples, 0.50)).c_str());
+    std::printf("  p90       %s\n", fmt_latency(percentile(samples, 0.90)).c_str());
+    std::printf("  p99       %s\n", fmt_latency(percentile(samples, 0.99)).c_str());
+    std::printf("  max       %s\n", fmt_latency(samples.empty() ? microseconds{0}
+                                                                : samples.back()).c_str());
+    std::printf("  failed    %d / %d\n", failed, cycles);
+    std::printf("  node      %llu HTTP requests, %llu calls, %lld new blocks\n",
+                static_cast<unsigned long long>(bitcoind.requests()),
+                static_cast<unsigned long long>(bitcoind.calls()),
+                static_cast<long long>(bitcoind.tip() - tip0));
+    if (rpc_stats)
+        std::printf("\n%s", engine->stats().report().c_str());
+
+    engine->shutdown();
+    // A run where nothing got through is a broken setup, not a slow one.
+    return failed == cycles && cycles > 0 ? 1 : 0;
+}
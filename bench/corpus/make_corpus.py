@@ -0,0 +1,378 @@
+#!/usr/bin/env python3
+"""Writes the bench_json corpora: JSON-RPC reply bodies shaped like Bitcoin
+Core 28's, member for member and in its member order, with amounts printed
+the way Core prints them (8 decimals). Hashes, scripts and addresses are
+random but deterministic, so the files only change when this script does.
+
+    bench/corpus/make_corpus.py [output-dir]
+"""
+
+import os
+import random
+import sys
+
+rng = random.Random(20250101)
+
+
+class Raw(str):
+    """Written as is: a number already formatted the way Core formats it."""
+
+
+def amount(sats):
+    return Raw(f"{'-' if sats < 0 else ''}{abs(sats) // 100_000_000}.{abs(sats) % 100_000_000:08d}")
+
+
+def write(v, out):
+    if isinstance(v, Raw):
+        out.append(v)
+    elif v is None:
+        out.append("null")
+    elif v is True:
+        out.append("true")
+    elif v is False:
+        out.append("false")
+    elif isinstance(v, int):
+        out.append(str(v))
+    elif isinstance(v, float):
+        out.append(repr(v))
+    elif isinstance(v, str):
+        out.append('"' + v.replace("\\", "\\\\").replace('"', '\\"') + '"')
+    elif isinstance(v, list):
+        out.append("[")
+        for i, e in enumerate(v):
+            if i:
+                out.append(",")
+            write(e, out)
+        out.append("]")
+    else:
+        out.append("{")
+        for i, (k, e) in enumerate(v.items()):
+            if i:
+                out.append(",")
+            write(k, out)
+            out.append(":")
+            write(e, out)
+        out.append("}")
+
+
+def reply(result):
+    out = []
+    write({"result": result, "error": None, "id": 1}, out)
+    return "".join(out) + "\n"
+
+
+# Hashes are random; longer hex (scripts, witnesses, raw transactions) is cut
+# from a small pool of random bytes. A parser sees random digits either way,
+# and git stores the multi-megabyte getblock reply compactly.
+POOL = rng.randbytes(4096).hex()
+
+
+def hexstr(nbytes):
+    if nbytes <= 32:
+        return rng.randbytes(nbytes).hex()
+    start = rng.randrange(4096) * 2
+    return (POOL * (nbytes // 4096 + 2))[start:start + 2 * nbytes]
+
+
+BECH32 = "qpzry9x8gf2tvdw0s3jn54khce6mua7l"
+
+
+def bech32(prefix, n):
+    return prefix + "".join(rng.choice(BECH32) for _ in range(n))
+
+
+# ---------------------------------------------------------------------------
+# getpeerinfo
+# ---------------------------------------------------------------------------
+MSG_TYPES = ["addrv2", "block", "blocktxn", "cmpctblock", "feefilter", "getaddr", "getdata",
+             "getheaders", "headers", "inv", "notfound", "ping", "pong", "sendaddrv2",
+             "sendcmpct", "sendheaders", "tx", "verack", "version", "wtxidrelay"]
+
+
+def peer(i, tip):
+    inbound = i % 3 == 0
+    network = rng.choice(["ipv4", "ipv4", "ipv4", "ipv6", "onion"])
+    if network == "ipv4":
+        addr = ".".join(str(rng.randrange(1, 255)) for _ in range(4)) + f":{rng.randrange(1024, 65535) if inbound else 8333}"
+    elif network == "ipv6":
+        addr = "[2a01:" + ":".join(f"{rng.randrange(65536):x}" for _ in range(3)) + "::1]:8333"
+    else:
+        addr = "".join(rng.choice("abcdefghijklmnopqrstuvwxyz234567") for _ in range(56)) + ".onion:8333"
+    per_msg = lambda: {m: rng.randrange(24, 5_000_000) for m in sorted(rng.sample(MSG_TYPES, 12))}
+    p = {
+        "id": 1000 + i,
+        "addr": addr,
+        "addrbind": "10.0.0.2:8333" if inbound else f"10.0.0.2:{rng.randrange(30000, 60000)}",
+        "addrlocal": f"198.51.100.{rng.randrange(1, 255)}:8333",
+        "network": network,
+        "services": "0000000000000c09" if i % 4 else "0000000000000c49",
+        "servicesnames": ["NETWORK", "WITNESS", "NETWORK_LIMITED", "P2P_V2"] if i % 4
+        else ["NETWORK", "BLOOM", "WITNESS", "NETWORK_LIMITED", "P2P_V2"],
+        "relaytxes": i % 10 != 7,
+        "lastsend": 1735689600 + rng.randrange(600),
+        "lastrecv": 1735689600 + rng.randrange(600),
+        "last_transaction": 1735689600 + rng.randrange(600) if i % 5 else 0,
+        "last_block": 1735680000 + rng.randrange(9000) if i % 2 else 0,
+        "bytessent": rng.randrange(10**5, 10**10),
+        "bytesrecv": rng.randrange(10**5, 10**10),
+        "conntime": 1735000000 + rng.randrange(600000),
+        "timeoffset": rng.randrange(-2, 3),
+        "pingtime": round(rng.uniform(0.004, 0.9), 6),
+        "minping": round(rng.uniform(0.003, 0.2), 6),
+        "version": 70016,
+        "subver": rng.choice(["/Satoshi:28.0.0/", "/Satoshi:27.1.0/", "/Satoshi:27.0.0/",
+                              "/Satoshi:26.0.0/", "/Satoshi:25.1.0/", "/Satoshi:28.1.0(node)/"]),
+        "inbound": inbound,
+        "bip152_hb_to": i % 40 == 1,
+        "bip152_hb_from": i % 40 == 2,
+        "startingheight": tip - rng.randrange(1, 5000),
+        "presynced_headers": -1,
+        "synced_headers": tip,
+        "synced_blocks": tip,
+        "inflight": [],
+        "addr_relay_enabled": not inbound or i % 2 == 0,
+        "addr_processed": rng.randrange(0, 60000),
+        "addr_rate_limited": rng.randrange(0, 2000),
+        "permissions": ["noban"] if i == 5 else [],
+        "minfeefilter": amount(rng.choice([1000, 1000, 1000, 2170, 3000, 10000])),
+        "bytessent_per_msg": per_msg(),
+        "bytesrecv_per_msg": per_msg(),
+        "connection_type": "inbound" if inbound else rng.choice(
+            ["outbound-full-relay"] * 8 + ["block-relay-only"] * 2 + ["manual"]),
+        "transport_protocol_type": rng.choice(["v1", "v2"]),
+        "session_id": hexstr(32) if i % 2 else "",
+    }
+    if inbound:
+        del p["addrlocal"]
+    return p
+
+
+# ---------------------------------------------------------------------------
+# Transactions
+# ---------------------------------------------------------------------------
+def script_pubkey():
+    kind = rng.choices(["v0_p2wpkh", "v1_p2tr", "scripthash", "pubkeyhash", "v0_p2wsh", "nulldata"],
+                       weights=[45, 30, 10, 8, 5, 2])[0]
+    if kind == "v0_p2wpkh":
+        h = hexstr(20)
+        return {"asm": "0 " + h, "desc": f"addr({bech32('bc1q', 38)})#{bech32('', 8)}",
+                "hex": "0014" + h, "address": bech32("bc1q", 38), "type": "witness_v0_keyhash"}
+    if kind == "v1_p2tr":
+        h = hexstr(32)
+        return {"asm": "1 " + h, "desc": f"rawtr({h})#{bech32('', 8)}", "hex": "5120" + h,
+                "address": bech32("bc1p", 58), "type": "witness_v1_taproot"}
+    if kind == "v0_p2wsh":
+        h = hexstr(32)
+        return {"asm": "0 " + h, "desc": f"addr({bech32('bc1q', 58)})#{bech32('', 8)}",
+                "hex": "0020" + h, "address": bech32("bc1q", 58), "type": "witness_v0_scripthash"}
+    if kind == "scripthash":
+        h = hexstr(20)
+        return {"asm": f"OP_HASH160 {h} OP_EQUAL", "desc": f"addr(3{bech32('', 33)})#{bech32('', 8)}",
+                "hex": f"a914{h}87", "address": "3" + bech32("", 33), "type": "scripthash"}
+    if kind == "pubkeyhash":
+        h = hexstr(20)
+        return {"asm": f"OP_DUP OP_HASH160 {h} OP_EQUALVERIFY OP_CHECKSIG",
+                "desc": f"addr(1{bech32('', 33)})#{bech32('', 8)}", "hex": f"76a914{h}88ac",
+                "address": "1" + bech32("", 33), "type": "pubkeyhash"}
+    data = hexstr(40)
+    return {"asm": "OP_RETURN " + data, "desc": f"raw(6a28{data})#{bech32('', 8)}",
+            "hex": "6a28" + data, "type": "nulldata"}
+
+
+def tx(coinbase=False, height=0, fee_total=0):
+    nin = 1 if coinbase else rng.choices([1, 2, 3, 5, 12], weights=[60, 20, 10, 7, 3])[0]
+    nout = 2 if coinbase else rng.choices([1, 2, 3, 8], weights=[25, 60, 10, 5])[0]
+    vin = []
+    for _ in range(nin):
+        if coinbase:
+            vin.append({"coinbase": f"03{height.to_bytes(3, 'little').hex()}" + hexstr(40),
+                        "txinwitness": ["00" * 32], "sequence": 4294967295})
+            continue
+        witness = rng.choice([[hexstr(71), hexstr(33)], [hexstr(64)], [hexstr(72), hexstr(33)]])
+        vin.append({"txid": hexstr(32), "vout": rng.randrange(4),
+                    "scriptSig": {"asm": "", "hex": ""}, "txinwitness": witness,
+                    "sequence": rng.choice([4294967293, 4294967295, 4294967294])})
+    vout = []
+    for n in range(nout):
+        spk = script_pubkey()
+        if coinbase:
+            value = 312_500_000 + fee_total if n == 0 else 0
+            if n == 1:
+                spk = {"asm": "OP_RETURN aa21a9ed" + hexstr(32),
+                       "desc": f"raw(6a24aa21a9ed{hexstr(32)})#{bech32('', 8)}",
+                       "hex": "6a24aa21a9ed" + hexstr(32), "type": "nulldata"}
+        else:
+            value = 0 if spk["type"] == "nulldata" else int(rng.lognormvariate(14, 2.5)) + 546
+        vout.append({"value": amount(value), "n": n, "scriptPubKey": spk})
+    base = 10 + 41 * nin + 31 * nout
+    wit = sum(sum(len(w) // 2 + 1 for w in v.get("txinwitness", [])) + 1 for v in vin) + 2
+    size = base + wit
+    weight = base * 4 + wit
+    vsize = (weight + 3) // 4
+    t = {"txid": hexstr(32), "hash": hexstr(32), "version": 1 if coinbase else rng.choice([1, 2, 2, 2]),
+         "size": size, "vsize": vsize, "weight": weight,
+         "locktime": 0 if coinbase or rng.random() < 0.7 else height - 1,
+         "vin": vin, "vout": vout}
+    fee = 0 if coinbase else vsize * rng.choice([2, 3, 4, 5, 8, 12, 20, 45])
+    if not coinbase:
+        t["fee"] = amount(fee)
+    t["hex"] = hexstr(size)
+    return t, weight, fee
+
+
+# ---------------------------------------------------------------------------
+# Blocks
+# ---------------------------------------------------------------------------
+HEIGHT = 877_000
+TIP = HEIGHT + 12
+
+
+def header_fields(height, ntx, size, stripped, weight):
+    return {
+        "hash": "00000000000000000001" + hexstr(22),
+        "confirmations": TIP - height + 1,
+        "height": height,
+        "version": 0x2000E000,
+        "versionHex": "2000e000",
+        "merkleroot": hexstr(32),
+        "time": 1735689600,
+        "mediantime": 1735686000,
+        "nonce": rng.randrange(2**32),
+        "bits": "17029a8a",
+        "target": "00000000000000000002" + "9a8a" + "0" * 40,
+        "difficulty": 108522647629298.2,
+        "chainwork": "0000000000000000000000000000000000000000a" + hexstr(11)[:23],
+        "nTx": ntx,
+        "previousblockhash": "00000000000000000001" + hexstr(22),
+        "nextblockhash": "00000000000000000000" + hexstr(22),
+        "strippedsize": stripped,
+        "size": size,
+        "weight": weight,
+    }
+
+
+def full_block():
+    txs, weight, fees = [], 1000, 0
+    while weight < 3_990_000:
+        t, w, fee = tx()
+        if weight + w > 3_993_000:
+            break
+        txs.append(t)
+        weight += w
+        fees += fee
+    cb, w, _ = tx(coinbase=True, height=HEIGHT, fee_total=fees)
+    txs.insert(0, cb)
+    size = 80 + 3 + sum(t["size"] for t in txs)
+    stripped = (weight - size) // 3
+    return txs, size, stripped, weight + w
+
+
+def block_reply(txs, size, stripped, weight, verbosity):
+    h = header_fields(HEIGHT, len(txs), size, stripped, weight)
+    if verbosity == 1:
+        h["tx"] = [t["txid"] for t in txs]
+    else:
+        h["tx"] = txs
+    # nTx and the size fields come before tx in Core's order already.
+    return h
+
+
+# ---------------------------------------------------------------------------
+# getrawmempool true
+# ---------------------------------------------------------------------------
+def mempool(n):
+    out = {}
+    txids = [hexstr(32) for _ in range(n)]
+    for i, txid in enumerate(txids):
+        vsize = rng.choice([110, 141, 153, 208, 222, 380, 1200, 3500])
+        fee = vsize * rng.choice([1, 2, 3, 4, 5, 7, 10, 25, 60])
+        parents = rng.sample(txids[max(0, i - 50):i], 1) if i and rng.random() < 0.15 else []
+        out[txid] = {
+            "vsize": vsize,
+            "weight": vsize * 4 - rng.randrange(3),
+            "time": 1735689000 + rng.randrange(600),
+            "height": TIP,
+            "descendantcount": 1,
+            "descendantsize": vsize,
+            "ancestorcount": 1 + len(parents),
+            "ancestorsize": vsize + 141 * len(parents),
+            "wtxid": hexstr(32),
+            "fees": {"base": amount(fee), "modified": amount(fee),
+                     "ancestor": amount(fee + 600 * len(parents)), "descendant": amount(fee)},
+            "depends": parents,
+            "spentby": [],
+            "bip125-replaceable": rng.random() < 0.3,
+            "unbroadcast": False,
+        }
+    return out
+
+
+# ---------------------------------------------------------------------------
+# getblockstats, getdeploymentinfo
+# ---------------------------------------------------------------------------
+def blockstats(txs, size, weight):
+    fees = [int(round(float(t["fee"]) * 1e8)) for t in txs[1:]]
+    rates = sorted(f // t["vsize"] for f, t in zip(fees, txs[1:]))
+    pct = lambda q: rates[int(q * (len(rates) - 1))]
+    return {
+        "avgfee": sum(fees) // len(fees), "avgfeerate": sum(fees) * 4 // (weight - 1000),
+        "avgtxsize": (size - 1000) // len(fees), "blockhash": "00000000000000000001" + hexstr(22),
+        "feerate_percentiles": [pct(0.1), pct(0.25), pct(0.5), pct(0.75), pct(0.9)],
+        "height": HEIGHT, "ins": sum(len(t["vin"]) for t in txs[1:]),
+        "maxfee": max(fees), "maxfeerate": rates[-1], "maxtxsize": max(t["size"] for t in txs),
+        "medianfee": sorted(fees)[len(fees) // 2], "mediantime": 1735686000,
+        "mediantxsize": sorted(t["size"] for t in txs)[len(txs) // 2],
+        "minfee": min(fees), "minfeerate": rates[0], "mintxsize": min(t["size"] for t in txs[1:]),
+        "outs": sum(len(t["vout"]) for t in txs), "subsidy": 312500000,
+        "swtotal_size": size - 2000, "swtotal_weight": weight - 5000, "swtxs": len(txs) - 40,
+        "time": 1735689600, "total_out": 1_234_567_890_123, "total_size": size - 300,
+        "total_weight": weight - 800, "totalfee": sum(fees), "txs": len(txs),
+        "utxo_increase": 1234, "utxo_increase_actual": 1180, "utxo_size_inc": 98765,
+        "utxo_size_inc_actual": 94321,
+    }
+
+
+def deploymentinfo():
+    buried = lambda h: {"type": "buried", "active": True, "height": h}
+    return {
+        "hash": "00000000000000000001" + hexstr(22),
+        "height": TIP,
+        "script_flags": ["CHECKLOCKTIMEVERIFY", "CHECKSEQUENCEVERIFY", "DERSIG", "NULLDUMMY",
+                         "P2SH", "TAPROOT", "WITNESS"],
+        "deployments": {
+            "bip34": buried(227931), "bip66": buried(363725), "bip65": buried(388381),
+            "csv": buried(419328), "segwit": buried(481824),
+            "taproot": {"type": "bip9", "height": 709632, "active": True,
+                        "bip9": {"start_time": 1619222400, "timeout": 1628640000,
+                                 "min_activation_height": 709632, "status": "active",
+                                 "since": 709632, "status_next": "active"}},
+            "testdummy": {"type": "bip9", "active": False,
+                          "bip9": {"bit": 28, "start_time": 0, "timeout": 9223372036854775807,
+                                   "min_activation_height": 0, "status": "started",
+                                   "since": 876960, "status_next": "started",
+                                   "statistics": {"period": 2016, "threshold": 1815,
+                                                  "elapsed": 40, "count": 3,
+                                                  "possible": True},
+                                   "signalling": "-#--------#-------------#-----------#----"}},
+        },
+    }
+
+
+def main():
+    out_dir = sys.argv[1] if len(sys.argv) > 1 else os.path.dirname(os.path.abspath(__file__))
+    txs, size, stripped, weight = full_block()
+    files = {
+        "getpeerinfo.json": [peer(i, TIP) for i in range(125)],
+        "getblock-1.json": block_reply(txs, size, stripped, weight, 1),
+        "getblock-2.json": block_reply(txs, size, stripped, weight, 2),
+        "getrawmempool-verbose.json": mempool(5000),
+        "getblockstats.json": blockstats(txs, size, weight),
+        "getdeploymentinfo.json": deploymentinfo(),
+    }
+    for name, result in files.items():
+        with open(os.path.join(out_dir, name), "w", newline="\n") as f:
+            f.write(reply(result))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,628 @@
+#include "fake_bitcoind.hpp"
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "guarded.hpp"
+#include "thread_safety.hpp"
+
+namespace {
+
+// An error Bitcoin Core would report in the response's "error" member.
+struct FakeRpcError {
+    int         code;
+    std::string message;
+};
+
+// Deterministic 64-hex-digit "hash" of (kind, n), so a block or transaction
+// keeps its hash across calls.
+std::string fake_hash(uint64_t kind, uint64_t n) {
+    static constexpr char kHex[] = "0123456789abcdef";
+    std::string           out(64, '0');
+    uint64_t              x = kind * 0x9e3779b97f4a7c15ULL + n;
+    for (size_t i = 0; i < out.size(); ++i) {
+        if (i % 16 == 0) { // splitmix64 step
+            x += 0x9e3779b97f4a7c15ULL;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            x ^= x >> 31;
+        }
+        out[i] = kHex[(x >> ((i % 16) * 4)) & 0xf];
+    }
+    // Block hashes look like real ones: leading zeros from proof of work.
+    if (kind == 0)
+        std::fill_n(out.begin(), 19, '0');
+    return out;
+}
+
+std::string block_hash(int64_t height) { return fake_hash(0, static_cast<uint64_t>(height)); }
+std::string txid(int64_t height, int64_t index) {
+    return fake_hash(1, (static_cast<uint64_t>(height) << 20) + static_cast<uint64_t>(index));
+}
+
+constexpr int64_t kGenesisTime = 1231006505;
+
+int64_t block_time(int64_t height) { return kGenesisTime + height * 600; }
+
+} // namespace
+
+struct FakeBitcoind::Impl {
+    const FakeBitcoindConfig config;
+
+    int                   listen_fd = -1;
+    int                   port      = 0; // bound port, kept for after stop()
+    std::thread           accept_thread;
+    std::atomic<bool>     stopping{false};
+    std::atomic<int64_t>  tip;
+    std::atomic<uint64_t> requests{0};
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> chaininfo_calls{0};
+    Guarded<std::mt19937> rng;
+    std::once_flag        stop_once;
+
+    // Connection sockets and their threads, so stop() can unblock and join them.
+    StdMutex                 conn_mtx;
+    std::set<int>            conn_fds GUARDED_BY(conn_mtx);
+    std::vector<std::thread> conn_threads GUARDED_BY(conn_mtx);
+
+    explicit Impl(FakeBitcoindConfig cfg)
+        : config(std::move(cfg)), tip(config.height), rng(std::mt19937(config.seed)) {}
+
+    void serve() EXCLUSIVE_LOCKS_REQUIRED(!conn_mtx);
+    void handle(int fd);
+    [[nodiscard]] bool chance(double p);
+    [[nodiscard]] json answer(const json& request);
+    [[nodiscard]] json result(const std::string& method, const json& params);
+
+    // Canned results, shaped like Bitcoin Core 29's.
+    [[nodiscard]] json blockchaininfo();
+    [[nodiscard]] json networkinfo() const;
+    [[nodiscard]] json mempoolinfo() const;
+    [[nodiscard]] json peerinfo() const;
+    [[nodiscard]] json blockstats(int64_t height, const json& fields) const;
+    [[nodiscard]] json blockheader(int64_t height) const;
+    [[nodiscard]] json block(int64_t height) const;
+    [[nodiscard]] json mempoolentry(int64_t index) const;
+    [[nodiscard]] json rawmempool(bool verbose) const;
+
+    [[nodiscard]] int64_t height_of(const json& hash) const;
+    void                  pad(json& result) const;
+};
+
+// ============================================================================
+// Canned results
+// ============================================================================
+
+json FakeBitcoind::Impl::blockchaininfo() {
+    if (config.new_block_every > 0 &&
+        ++chaininfo_calls % static_cast<uint64_t>(config.new_block_every) == 0)
+        ++tip;
+    const int64_t h = tip;
+    return {
+        {"chain", "main"},
+        {"blocks", h},
+        {"headers", h},
+        {"bestblockhash", block_hash(h)},
+        {"bits", "17023a04"},
+        {"target", "0000000000000000000233a40000000000000000000000000000000000000000"},
+        {"difficulty", 126411437451912.2},
+        {"time", block_time(h)},
+        {"mediantime", block_time(h) - 3000},
+        {"verificationprogress", 0.9999987},
+        {"initialblockdownload", false},
+        {"chainwork", "0000000000000000000000000000000000000000b1f3b9c1a8d2e4f6a7b8c9d0"},
+        {"size_on_disk", 712345678901LL},
+        {"pruned", false},
+        {"warnings", json::array()},
+    };
+}
+
+json FakeBitcoind::Impl::networkinfo() const {
+    const int in = config.peers / 3;
+    return {
+        {"version", 290000},
+        {"subversion", "/Satoshi:29.0.0/"},
+        {"protocolversion", 70016},
+        {"localservices", "0000000000000c09"},
+        {"localservicesnames", json::array_t{"NETWORK", "WITNESS", "NETWORK_LIMITED", "P2P_V2"}},
+        {"localrelay", true},
+        {"timeoffset", 0},
+        {"networkactive", true},
+        {"connections", config.peers},
+        {"connections_in", in},
+        {"connections_out", config.peers - in},
+        {"networks", json::array_t{
+                         {{"name", "ipv4"}, {"limited", false}, {"reachable", true}},
+                         {{"name", "ipv6"}, {"limited", false}, {"reachable", true}},
+                         {{"name", "onion"}, {"limited", true}, {"reachable", false}},
+                     }},
+        {"relayfee", 0.00001},
+        {"incrementalfee", 0.00001},
+        {"localaddresses", json::array()},
+        {"warnings", json::array()},
+    };
+}
+
+json FakeBitcoind::Impl::mempoolinfo() const {
+    const int64_t n = config.mempool_txs;
+    return {
+        {"loaded", true},
+        {"size", n},
+        {"bytes", n * 310},
+        {"usage", n * 1150},
+        {"total_fee", static_cast<double>(n) * 0.0000125},
+        {"maxmempool", 300000000},
+        {"mempoolminfee", 0.00001},
+        {"minrelaytxfee", 0.00001},
+        {"incrementalrelayfee", 0.00001},
+        {"unbroadcastcount", 0},
+        {"fullrbf", true},
+    };
+}
+
+json FakeBitcoind::Impl::peerinfo() const {
+    json::array_t peers;
+    peers.reserve(static_cast<size_t>(config.peers));
+    for (int i = 0; i < config.peers; ++i) {
+        const bool inbound = i % 3 == 0;
+        const auto addr    = std::to_string(10 + i % 200) + "." + std::to_string(i / 200 % 256) +
+                          ".0." + std::to_string(1 + i % 250) + ":8333";
+        json peer = {
+            {"id", i},
+            {"addr", addr},
+            {"addrbind", "192.168.1.2:8333"},
+            {"network", "ipv4"},
+            {"services", "0000000000000c09"},
+            {"servicesnames", json::array_t{"NETWORK", "WITNESS", "NETWORK_LIMITED"}},
+            {"relaytxes", true},
+            {"lastsend", block_time(tip) + i},
+            {"lastrecv", block_time(tip) + i},
+            {"last_transaction", block_time(tip) - i},
+            {"last_block", block_time(tip) - 600},
+            {"bytessent", 1000000 + i * 7919},
+            {"bytesrecv", 5000000 + i * 104729},
+            {"conntime", block_time(tip) - 3600 * (i + 1)},
+            {"timeoffset", 0},
+            {"pingtime", 0.05 + 0.001 * i},
+            {"minping", 0.04 + 0.001 * i},
+            {"version", 70016},
+            {"subver", "/Satoshi:28.1.0/"},
+            {"inbound", inbound},
+            {"bip152_hb_to", i == 1},
+            {"bip152_hb_from", i == 2},
+            {"startingheight", static_cast<int64_t>(tip) - i},
+            {"presynced_headers", -1},
+            {"synced_headers", static_cast<int64_t>(tip)},
+            {"synced_blocks", static_cast<int64_t>(tip)},
+            {"inflight", json::array()},
+            {"addr_relay_enabled", true},
+            {"addr_processed", 100 + i},
+            {"addr_rate_limited", 0},
+            {"permissions", json::array()},
+            {"minfeefilter", 0.00001},
+            {"connection_type", inbound ? "inbound" : "outbound-full-relay"},
+            {"transport_protocol_type", i % 2 ? "v2" : "v1"},
+            {"session_id", i % 2 ? fake_hash(2, static_cast<uint64_t>(i)) : ""},
+        };
+        pad(peer);
+        peers.push_back(std::move(peer));
+    }
+    return peers;
+}
+
+json FakeBitcoind::Impl::blockstats(int64_t height, const json& fields) const {
+    const int64_t txs = config.block_txs;
+    json          all = {
+        {"avgfee", 2100},
+        {"avgfeerate", 7},
+        {"avgtxsize", 540},
+        {"blockhash", block_hash(height)},
+        {"feerate_percentiles", json::array_t{2, 3, 5, 9, 20}},
+        {"height", height},
+        {"ins", txs * 2},
+        {"maxfee", 450000},
+        {"maxfeerate", 350},
+        {"maxtxsize", 65000},
+        {"medianfee", 900},
+        {"mediantime", block_time(height) - 3000},
+        {"mediantxsize", 250},
+        {"minfee", 110},
+        {"minfeerate", 1},
+        {"mintxsize", 150},
+        {"outs", txs * 3},
+        {"subsidy", 312500000},
+        {"swtotal_size", txs * 500},
+        {"swtotal_weight", txs * 1400},
+        {"swtxs", txs - txs / 10},
+        {"time", block_time(height)},
+        {"total_out", 123456789012LL},
+        {"total_size", txs * 540},
+        {"total_weight", txs * 1590},
+        {"totalfee", txs * 2100},
+        {"txs", txs},
+        {"utxo_increase", txs},
+        {"utxo_size_inc", txs * 80},
+    };
+    if (!fields.is_array() || fields.empty())
+        return all;
+    json::object_t picked;
+    for (const auto& f : fields) {
+        if (!f.is_string() || !all.contains(f.get<std::string>()))
+            throw FakeRpcError{-8, "Invalid selected statistic '" + f.dump() + "'"};
+        picked[f.get<std::string>()] = all[f.get<std::string>()];
+    }
+    return picked;
+}
+
+json FakeBitcoind::Impl::blockheader(int64_t height) const {
+    json header = {
+        {"hash", block_hash(height)},
+        {"confirmations", static_cast<int64_t>(tip) - height + 1},
+        {"height", height},
+        {"version", 536870912},
+        {"versionHex", "20000000"},
+        {"merkleroot", fake_hash(3, static_cast<uint64_t>(height))},
+        {"time", block_time(height)},
+        {"mediantime", block_time(height) - 3000},
+        {"nonce", static_cast<int64_t>(height * 2654435761 % 4294967296)},
+        {"bits", "17023a04"},
+        {"difficulty", 126411437451912.2},
+        {"chainwork", "0000000000000000000000000000000000000000b1f3b9c1a8d2e4f6a7b8c9d0"},
+        {"nTx", config.block_txs},
+    };
+    if (height > 0)
+        header["previousblockhash"] = block_hash(height - 1);
+    if (height < tip)
+        header["nextblockhash"] = block_hash(height + 1);
+    return header;
+}
+
+json FakeBitcoind::Impl::block(int64_t height) const {
+    json          blk = blockheader(height);
+    json::array_t txs;
+    txs.reserve(static_cast<size_t>(config.block_txs));
+    for (int64_t i = 0; i < config.block_txs; ++i)
+        txs.emplace_back(txid(height, i));
+    blk["tx"]           = std::move(txs);
+    blk["strippedsize"] = config.block_txs * 380;
+    blk["size"]         = config.block_txs * 540;
+    blk["weight"]       = config.block_txs * 1590;
+    return blk;
+}
+
+json FakeBitcoind::Impl::mempoolentry(int64_t index) const {
+    json entry = {
+        {"vsize", 141 + index % 400},
+        {"weight", 4 * (141 + index % 400)},
+        {"time", block_time(tip) - index % 3600},
+        {"height", static_cast<int64_t>(tip)},
+        {"descendantcount", 1},
+        {"descendantsize", 141 + index % 400},
+        {"ancestorcount", 1},
+        {"ancestorsize", 141 + index % 400},
+        {"wtxid", fake_hash(4, static_cast<uint64_t>(index))},
+        {"fees",
+         {{"base", 0.00000141 * static_cast<double>(1 + index % 50)},
+          {"modified", 0.00000141 * static_cast<double>(1 + index % 50)},
+          {"ancestor", 0.00000141 * static_cast<double>(1 + index % 50)},
+          {"descendant", 0.00000141 * static_cast<double>(1 + index % 50)}}},
+        {"depends", json::array()},
+        {"spentby", json::array()},
+        {"bip125-replaceable", true},
+        {"unbroadcast", false},
+    };
+    pad(entry);
+    return entry;
+}
+
+json FakeBitcoind::Impl::rawmempool(bool verbose) const {
+    if (!verbose) {
+        json::array_t ids;
+        ids.reserve(static_cast<size_t>(config.mempool_txs));
+        for (int64_t i = 0; i < config.mempool_txs; ++i)
+            ids.emplace_back(txid(-1, i));
+        return ids;
+    }
+    json::object_t entries;
+    for (int64_t i = 0; i < config.mempool_txs; ++i)
+        entries[txid(-1, i)] = mempoolentry(i);
+    return entries;
+}
+
+// Reverse of block_hash() for the heights that exist.
+int64_t FakeBitcoind::Impl::height_of(const json& hash) const {
+    if (hash.is_string()) {
+        const auto s = hash.get<std::string>();
+        for (int64_t h = tip; h >= 0 && h > tip - 10000; --h) {
+            if (block_hash(h) == s)
+                return h;
+        }
+    }
+    throw FakeRpcError{-5, "Block not found"};
+}
+
+void FakeBitcoind::Impl::pad(json& result) const {
+    if (config.pad_bytes > 0 && result.is_object())
+        result["padding"] = std::string(config.pad_bytes, 'x');
+}
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+json FakeBitcoind::Impl::result(const std::string& method, const json& params) {
+    auto param = [&](size_t i) -> const json& {
+        static const json null_val;
+        return params.is_array() && i < params.size() ? params[i] : null_val;
+    };
+    auto height_param = [&](size_t i) {
+        const json& p = param(i);
+        if (p.is_number_integer()) {
+            const auto h = p.get<int64_t>();
+            if (h < 0 || h > tip)
+                throw FakeRpcError{-8, "Target block height " + std::to_string(h) +
+                                           " after current tip " + std::to_string(tip)};
+            return h;
+        }
+        return height_of(p);
+    };
+
+    json out;
+    if (method == "getblockchaininfo")
+        out = blockchaininfo();
+    else if (method == "getnetworkinfo")
+        out = networkinfo();
+    else if (method == "getmempoolinfo")
+        out = mempoolinfo();
+    else if (method == "getpeerinfo")
+        return peerinfo();
+    else if (method == "getblockcount")
+        return static_cast<int64_t>(tip);
+    else if (method == "getbestblockhash")
+        return block_hash(tip);
+    else if (method == "getblockhash")
+        return block_hash(height_param(0));
+    else if (method == "getblockstats")
+        out = blockstats(height_param(0), param(1));
+    else if (method == "getblockheader")
+        out = blockheader(height_param(0));
+    else if (method == "getblock")
+        out = block(height_param(0));
+    else if (method == "getrawmempool")
+        return rawmempool(param(0).is_bool() && param(0).get<bool>());
+    else if (method == "getmempoolentry")
+        out = mempoolentry(0);
+    else if (method == "getconnectioncount")
+        return config.peers;
+    else if (method == "getnettotals")
+        out = {{"totalbytesrecv", 5000000000LL},
+               {"totalbytessent", 1000000000LL},
+               {"timemillis", block_time(tip) * 1000}};
+    else if (method == "getmininginfo")
+        out = {{"blocks", static_cast<int64_t>(tip)},
+               {"difficulty", 126411437451912.2},
+               {"networkhashps", 9.05e20},
+               {"pooledtx", config.mempool_txs},
+               {"chain", "main"},
+               {"warnings", json::array()}};
+    else if (method == "getchaintips")
+        return json::array_t{{{"height", static_cast<int64_t>(tip)},
+                              {"hash", block_hash(tip)},
+                              {"branchlen", 0},
+                              {"status", "active"}}};
+    else if (method == "uptime")
+        return 86400;
+    else if (method == "help")
+        return "Fake bitcoind: canned answers for benchmarks.";
+    else
+        throw FakeRpcError{-32601, "Method not found"};
+    pad(out);
+    return out;
+}
+
+json FakeBitcoind::Impl::answer(const json& request) {
+    ++calls;
+    const json& id     = request["id"];
+    const auto  method = request.value("method", "");
+    try {
+        if (chance(config.error_rate))
+            throw FakeRpcError{-1, "Injected error (fake bitcoind)"};
+        return {{"result", result(method, request["params"])}, {"error", nullptr}, {"id", id}};
+    } catch (const FakeRpcError& e) {
+        return {{"result", nullptr},
+                {"error", {{"code", e.code}, {"message", e.message}}},
+                {"id", id}};
+    } catch (const json::exception& e) {
+        return {{"result", nullptr},
+                {"error", {{"code", -1}, {"message", std::string(e.what())}}},
+                {"id", id}};
+    }
+}
+
+bool FakeBitcoind::Impl::chance(double p) {
+    if (p <= 0.0)
+        return false;
+    return rng.update([&](auto& r) { return std::uniform_real_distribution<>(0.0, 1.0)(r); }) < p;
+}
+
+// ============================================================================
+// HTTP
+// ============================================================================
+
+static void send_all(int fd, std::string_view data) {
+    while (!data.empty()) {
+        const ssize_t n = send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+        if (n <= 0)
+            return;
+        data.remove_prefix(static_cast<size_t>(n));
+    }
+}
+
+static constexpr const char* kParseError =
+    R"({"result":null,"error":{"code":-32700,"message":"Parse error"},"id":null})";
+
+static void send_response(int fd, int status, const std::string& reason, const std::string& body) {
+    send_all(fd, "HTTP/1.1 " + std::to_string(status) + " " + reason +
+                     "\r\nContent-Type: application/json\r\nContent-Length: " +
+                     std::to_string(body.size()) + "\r\n\r\n" + body);
+}
+
+void FakeBitcoind::Impl::serve() {
+    while (!stopping) {
+        const int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0)
+            return;
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        STDLOCK(conn_mtx);
+        if (stopping) {
+            close(fd);
+            return;
+        }
+        conn_fds.insert(fd);
+        conn_threads.emplace_back([this, fd] {
+            handle(fd);
+            STDLOCK(conn_mtx);
+            conn_fds.erase(fd);
+            close(fd);
+        });
+    }
+}
+
+void FakeBitcoind::Impl::handle(int fd) {
+    std::string buf;
+    char        tmp[64 * 1024];
+    for (;;) {
+        size_t hdr_end;
+        while ((hdr_end = buf.find("\r\n\r\n")) == std::string::npos) {
+            const ssize_t n = recv(fd, tmp, sizeof(tmp), 0);
+            if (n <= 0)
+                return;
+            buf.append(tmp, static_cast<size_t>(n));
+        }
+        size_t       len    = 0;
+        const size_t cl_pos = buf.find("Content-Length: ");
+        if (cl_pos < hdr_end)
+            len = std::stoul(buf.substr(cl_pos + 16));
+        while (buf.size() < hdr_end + 4 + len) {
+            const ssize_t n = recv(fd, tmp, sizeof(tmp), 0);
+            if (n <= 0)
+                return;
+            buf.append(tmp, static_cast<size_t>(n));
+        }
+        const std::string line = buf.substr(0, buf.find("\r\n"));
+        const std::string body = buf.substr(hdr_end + 4, len);
+        buf.erase(0, hdr_end + 4 + len);
+        ++requests;
+
+        if (chance(config.drop_rate))
+            return;
+        auto delay = config.latency;
+        if (config.jitter.count() > 0) {
+            delay += std::chrono::microseconds(rng.update([&](auto& r) {
+                return std::uniform_int_distribution<int64_t>(0, config.jitter.count())(r);
+            }));
+        }
+        if (delay.count() > 0)
+            std::this_thread::sleep_for(delay);
+
+        if (!line.starts_with("POST ")) {
+            send_response(fd, 404, "Not Found", "");
+            continue;
+        }
+        json req;
+        try {
+            req = json::parse(body);
+        } catch (const json::exception&) {
+            send_response(fd, 500, "Internal Server Error", kParseError);
+            continue;
+        }
+        if (req.is_array()) {
+            json::array_t replies;
+            replies.reserve(req.size());
+            for (const auto& r : req)
+                replies.push_back(answer(r));
+            send_response(fd, 200, "OK", json(std::move(replies)).dump());
+            continue;
+        }
+        // Legacy JSON-RPC: a single failed call comes back as HTTP 500.
+        const json reply = answer(req);
+        if (reply["error"].is_null())
+            send_response(fd, 200, "OK", reply.dump());
+        else
+            send_response(fd, 500, "Internal Server Error", reply.dump());
+    }
+}
+
+// ============================================================================
+// Public interface
+// ============================================================================
+
+FakeBitcoind::FakeBitcoind(FakeBitcoindConfig config)
+    : impl_(std::make_unique<Impl>(std::move(config))) {
+    impl_->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (impl_->listen_fd < 0)
+        throw RpcError("fake bitcoind: socket() failed");
+    int one = 1;
+    setsockopt(impl_->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port        = htons(static_cast<uint16_t>(impl_->config.port));
+    if (bind(impl_->listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(impl_->listen_fd, 64) != 0) {
+        close(impl_->listen_fd);
+        throw RpcError("fake bitcoind: cannot listen on 127.0.0.1:" +
+                       std::to_string(impl_->config.port));
+    }
+    socklen_t len = sizeof(addr);
+    getsockname(impl_->listen_fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    impl_->port          = ntohs(addr.sin_port);
+    impl_->accept_thread = std::thread([impl = impl_.get()] { impl->serve(); });
+}
+
+FakeBitcoind::~FakeBitcoind() { stop(); }
+
+void FakeBitcoind::stop() {
+    std::call_once(impl_->stop_once, [this] {
+        impl_->stopping = true;
+        shutdown(impl_->listen_fd, SHUT_RDWR);
+        close(impl_->listen_fd);
+        impl_->accept_thread.join();
+        std::vector<std::thread> threads;
+        {
+            STDLOCK(impl_->conn_mtx);
+            for (int fd : impl_->conn_fds)
+                shutdown(fd, SHUT_RDWR);
+            threads.swap(impl_->conn_threads);
+        }
+        for (auto& t : threads)
+            t.join();
+    });
+}
+
+int FakeBitcoind::port() const { return impl_->port; }
+
+RpcConfig FakeBitcoind::rpc_config() const {
+    RpcConfig cfg;
+    cfg.port = port();
+    return cfg;
+}
+
+uint64_t FakeBitcoind::requests() const { return impl_->requests.load(); }
+uint64_t FakeBitcoind::calls() const { return impl_->calls.load(); }
+int64_t  FakeBitcoind::tip() const { return impl_->tip.load(); }
+
+json FakeBitcoind::answer(const json& request) { return impl_->answer(request); }
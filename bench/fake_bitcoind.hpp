@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "json.hpp"
+#include "rpc_client.hpp"
+
+// Behaviour of a FakeBitcoind. The defaults answer instantly and never fail.
+struct FakeBitcoindConfig {
+    int port = 0; // 0 picks a free loopback port
+
+    // Added before every HTTP response, plus a uniform 0..jitter on top.
+    std::chrono::microseconds latency{0};
+    std::chrono::microseconds jitter{0};
+
+    // Payload size: entries in getpeerinfo, getrawmempool and getblock, and
+    // filler bytes added to every object result.
+    int    peers       = 10;
+    int    mempool_txs = 1000;
+    int    block_txs   = 3000;
+    size_t pad_bytes   = 0;
+
+    // Error injection: the share of calls answered with an RPC error, and of
+    // HTTP requests whose connection is closed without a reply.
+    double   error_rate = 0.0;
+    double   drop_rate  = 0.0;
+    uint32_t seed       = 1; // for jitter and error injection
+
+    int64_t height          = 900'000; // initial tip
+    int     new_block_every = 0;       // getblockchaininfo calls per new tip; 0 keeps it fixed
+};
+
+// In-process stand-in for bitcoind's JSON-RPC server: canned, deterministic
+// answers shaped like Bitcoin Core's for the calls the TUI and its Lua tabs
+// make (getblockchaininfo, getpeerinfo, getblockstats, getblock, …), over
+// HTTP/1.1 keep-alive on 127.0.0.1. Batches are supported; credentials are
+// accepted unchecked. REST is answered 404, as by a node without `-rest`.
+//
+// Each connection is served on its own thread, so `latency` overlaps between
+// concurrent requests the way a node with enough -rpcthreads would.
+class FakeBitcoind {
+  public:
+    explicit FakeBitcoind(FakeBitcoindConfig config = {});
+    ~FakeBitcoind(); // calls stop()
+
+    FakeBitcoind(const FakeBitcoind&)            = delete;
+    FakeBitcoind& operator=(const FakeBitcoind&) = delete;
+
+    [[nodiscard]] int       port() const;
+    [[nodiscard]] RpcConfig rpc_config() const; // points an RpcClient/RpcEngine here
+
+    [[nodiscard]] uint64_t requests() const; // HTTP requests received
+    [[nodiscard]] uint64_t calls() const;    // JSON-RPC calls, counting each batch element
+    [[nodiscard]] int64_t  tip() const;
+
+    // The JSON-RPC response object for one request object, as sent on the wire.
+    [[nodiscard]] json answer(const json& request);
+
+    // Close the listening socket and every connection, then join their threads.
+    // Idempotent.
+    void stop();
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
@@ -0,0 +1,80 @@
+// Standalone fake bitcoind: serves FakeBitcoind on a fixed port until Ctrl-C, so
+// bitcoin-tui itself (including Lua tabs) can be profiled against a node with
+// controlled latency, payload size and failure rate:
+//
+//   fake-bitcoind --latency-ms 20 --peers 125 &
+//   bitcoin-tui --regtest -u fake -P fake      # 'D' shows the RPC diagnostics
+
+#include <CLI/CLI.hpp>
+
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+
+#include "fake_bitcoind.hpp"
+
+int main(int argc, char* argv[]) {
+    CLI::App app{"fake-bitcoind — canned Bitcoin Core JSON-RPC server for benchmarking"};
+
+    double latency_ms = 0.0;
+    double jitter_ms  = 0.0;
+
+    FakeBitcoindConfig node;
+    node.port            = 18443; // regtest, so a real mainnet node is never shadowed
+    node.new_block_every = 60;
+
+    app.add_option("-p,--port", node.port, "Listening port on 127.0.0.1")
+        ->default_val(18443)
+        ->check(CLI::Range(0, 65535));
+    app.add_option("--latency-ms", latency_ms, "Latency per HTTP request")->default_val(0.0);
+    app.add_option("--jitter-ms", jitter_ms, "Extra uniform random latency")->default_val(0.0);
+    app.add_option("--peers", node.peers, "getpeerinfo entries")->default_val(10);
+    app.add_option("--mempool-txs", node.mempool_txs, "Mempool size")->default_val(1000);
+    app.add_option("--block-txs", node.block_txs, "Transactions per block")->default_val(3000);
+    app.add_option("--pad-bytes", node.pad_bytes, "Filler bytes in every object result")
+        ->default_val(0);
+    app.add_option("--error-rate", node.error_rate, "Share of calls failing with an RPC error")
+        ->default_val(0.0)
+        ->check(CLI::Range(0.0, 1.0));
+    app.add_option("--drop-rate", node.drop_rate, "Share of requests dropped unanswered")
+        ->default_val(0.0)
+        ->check(CLI::Range(0.0, 1.0));
+    app.add_option("--new-block-every", node.new_block_every,
+                   "getblockchaininfo calls per new block; 0 keeps the tip fixed")
+        ->default_val(60);
+
+    CLI11_PARSE(app, argc, argv);
+
+    node.latency = std::chrono::microseconds(static_cast<int64_t>(latency_ms * 1000.0));
+    node.jitter  = std::chrono::microseconds(static_cast<int64_t>(jitter_ms * 1000.0));
+
+    // Block the signals before the server starts its threads so they inherit
+    // the mask and only sigwait() below sees them.
+    sigset_t stop_signals;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop_signals, nullptr);
+
+    try {
+        FakeBitcoind bitcoind(node);
+        std::printf("fake-bitcoind listening on 127.0.0.1:%d (any credentials), Ctrl-C to stop\n",
+                    bitcoind.port());
+        std::fflush(stdout);
+
+        int sig = 0;
+        sigwait(&stop_signals, &sig);
+
+        bitcoind.stop();
+        std::printf("served %llu HTTP requests, %llu calls; tip at height %lld\n",
+                    static_cast<unsigned long long>(bitcoind.requests()),
+                    static_cast<unsigned long long>(bitcoind.calls()),
+                    static_cast<long long>(bitcoind.tip()));
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "fake-bitcoind: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,258 @@
+#include "consensus.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Bounds-checked little-endian cursor over a serialized buffer.
+class Reader {
+  public:
+    explicit Reader(std::string_view data) : data_(data) {}
+
+    [[nodiscard]] size_t pos() const { return pos_; }
+    [[nodiscard]] size_t remaining() const { return data_.size() - pos_; }
+
+    std::string_view take(size_t n) {
+        if (n > remaining())
+            throw ConsensusError("Truncated consensus data");
+        auto out = data_.substr(pos_, n);
+        pos_ += n;
+        return out;
+    }
+
+    uint64_t uint(size_t n) {
+        auto     b = take(n);
+        uint64_t v = 0;
+        for (size_t i = 0; i < n; ++i)
+            v |= static_cast<uint64_t>(static_cast<unsigned char>(b[i])) << (8 * i);
+        return v;
+    }
+
+    uint8_t  u8() { return static_cast<uint8_t>(uint(1)); }
+    uint32_t u32() { return static_cast<uint32_t>(uint(4)); }
+    int32_t  i32() { return static_cast<int32_t>(u32()); }
+    int64_t  i64() { return static_cast<int64_t>(uint(8)); }
+
+    Hash256 hash() {
+        Hash256 h;
+        std::memcpy(h.bytes.data(), take(32).data(), 32);
+        return h;
+    }
+
+    // CompactSize length prefix.
+    uint64_t compact_size() {
+        const uint8_t first = u8();
+        if (first < 0xfd)
+            return first;
+        if (first == 0xfd)
+            return uint(2);
+        if (first == 0xfe)
+            return uint(4);
+        return uint(8);
+    }
+
+    // An element count whose elements take at least `min_bytes` each; rejects
+    // counts the remaining data cannot hold before anything is allocated.
+    size_t count(size_t min_bytes) {
+        const uint64_t n = compact_size();
+        if (n > remaining() / std::max<size_t>(min_bytes, 1))
+            throw ConsensusError("Truncated consensus data");
+        return static_cast<size_t>(n);
+    }
+
+    std::string_view var_bytes() { return take(count(1)); }
+
+    void expect_end() const {
+        if (pos_ != data_.size())
+            throw ConsensusError("Unexpected trailing bytes in consensus data");
+    }
+
+  private:
+    std::string_view data_;
+    size_t           pos_ = 0;
+};
+
+BlockHeader read_header(Reader& r) {
+    BlockHeader h;
+    h.version     = r.i32();
+    h.prev_hash   = r.hash();
+    h.merkle_root = r.hash();
+    h.time        = r.u32();
+    h.bits        = r.u32();
+    h.nonce       = r.u32();
+    return h;
+}
+
+// One transaction. Per BIP144, an empty input list followed by a non-zero flag
+// byte marks the extended (segwit) serialization.
+Transaction read_tx(Reader& r) {
+    const size_t start         = r.pos();
+    size_t       witness_bytes = 0;
+
+    Transaction tx;
+    tx.version   = r.i32();
+    size_t  n_in = r.count(41); // outpoint + empty script + sequence
+    uint8_t flag = 0;
+    if (n_in == 0) {
+        flag = r.u8();
+        if (flag == 0)
+            throw ConsensusError("Transaction has no inputs");
+        if (flag != 1)
+            throw ConsensusError("Unknown transaction serialization flag");
+        witness_bytes += 2;
+        n_in = r.count(41);
+    }
+
+    tx.vin.resize(n_in);
+    for (auto& in : tx.vin) {
+        in.prev_txid  = r.hash();
+        in.prev_vout  = r.u32();
+        in.script_sig = r.var_bytes();
+        in.sequence   = r.u32();
+    }
+    tx.vout.resize(r.count(9)); // value + empty script
+    for (auto& out : tx.vout) {
+        out.value         = r.i64();
+        out.script_pubkey = r.var_bytes();
+    }
+    if (flag) {
+        const size_t witness_start = r.pos();
+        for (size_t i = 0; i < n_in; ++i) {
+            for (size_t items = r.count(1); items > 0; --items)
+                r.var_bytes();
+        }
+        witness_bytes += r.pos() - witness_start;
+    }
+    tx.locktime = r.u32();
+
+    tx.size          = r.pos() - start;
+    tx.stripped_size = tx.size - witness_bytes;
+    return tx;
+}
+
+} // namespace
+
+// ============================================================================
+// Hash256
+// ============================================================================
+std::string Hash256::hex() const {
+    std::string reversed(bytes.rbegin(), bytes.rend());
+    return to_hex(reversed);
+}
+
+std::optional<Hash256> Hash256::from_hex(std::string_view hex) {
+    if (hex.size() != 64)
+        return std::nullopt;
+    auto nibble = [](char c) {
+        return (c >= '0' && c <= '9')   ? c - '0'
+               : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+               : (c >= 'A' && c <= 'F') ? c - 'A' + 10
+                                        : -1;
+    };
+    Hash256 h;
+    for (size_t i = 0; i < 32; ++i) {
+        const int hi = nibble(hex[2 * i]);
+        const int lo = nibble(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0)
+            return std::nullopt;
+        h.bytes[31 - i] = static_cast<unsigned char>(hi << 4 | lo);
+    }
+    return h;
+}
+
+bool TxIn::is_coinbase() const {
+    return prev_vout == 0xffffffff &&
+           std::all_of(prev_txid.bytes.begin(), prev_txid.bytes.end(),
+                       [](unsigned char b) { return b == 0; });
+}
+
+// ============================================================================
+// Decoders
+// ============================================================================
+BlockHeader decode_header(std::string_view data) {
+    Reader r(data);
+    auto   h = read_header(r);
+    r.expect_end();
+    return h;
+}
+
+std::vector<BlockHeader> decode_headers(std::string_view data) {
+    if (data.size() % BlockHeader::kSize != 0)
+        throw ConsensusError("Header data is not a multiple of 80 bytes");
+    Reader                   r(data);
+    std::vector<BlockHeader> headers;
+    headers.reserve(data.size() / BlockHeader::kSize);
+    while (r.remaining() > 0)
+        headers.push_back(read_header(r));
+    return headers;
+}
+
+Transaction decode_transaction(std::string_view data) {
+    Reader r(data);
+    auto   tx = read_tx(r);
+    r.expect_end();
+    return tx;
+}
+
+Block decode_block(std::string_view data) {
+    Reader r(data);
+    Block  blk;
+    blk.header = read_header(r);
+    blk.txs.resize(r.count(60)); // smallest possible transaction
+    size_t witness_bytes = 0;
+    for (auto& tx : blk.txs) {
+        tx = read_tx(r);
+        witness_bytes += tx.size - tx.stripped_size;
+    }
+    r.expect_end();
+    blk.size          = data.size();
+    blk.stripped_size = data.size() - witness_bytes;
+    return blk;
+}
+
+// ============================================================================
+// Derived values
+// ============================================================================
+double difficulty_from_bits(uint32_t bits) {
+    int    shift = static_cast<int>((bits >> 24) & 0xff);
+    double diff  = static_cast<double>(0x0000ffff) / static_cast<double>(bits & 0x00ffffff);
+    while (shift < 29) {
+        diff *= 256.0;
+        ++shift;
+    }
+    while (shift > 29) {
+        diff /= 256.0;
+        --shift;
+    }
+    return diff;
+}
+
+std::optional<int64_t> bip34_height(std::string_view script_sig) {
+    if (script_sig.empty())
+        return std::nullopt;
+    const auto op = static_cast<unsigned char>(script_sig[0]);
+    if (op == 0x00) // OP_0
+        return 0;
+    if (op >= 0x51 && op <= 0x60) // OP_1 .. OP_16
+        return op - 0x50;
+    if (op > 5 || script_sig.size() <= op) // CScriptNum push of at most 5 bytes
+        return std::nullopt;
+    int64_t height = 0;
+    for (size_t i = 0; i < op; ++i)
+        height |= static_cast<int64_t>(static_cast<unsigned char>(script_sig[1 + i])) << (8 * i);
+    if (static_cast<unsigned char>(script_sig[op]) & 0x80)
+        return std::nullopt; // negative
+    return height;
+}
+
+std::string to_hex(std::string_view bytes) {
+    static const char* digits = "0123456789abcdef";
+    std::string        out;
+    out.reserve(bytes.size() * 2);
+    for (unsigned char c : bytes) {
+        out += digits[c >> 4];
+        out += digits[c & 0x0f];
+    }
+    return out;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ============================================================================
+// Bitcoin consensus (wire) serialization decoder
+//
+// Decodes the binary blocks, transactions and headers served by Bitcoin Core's
+// REST interface (`/rest/.../*.bin`). Only what the TUI displays is kept:
+// scripts are views into the decoded buffer and witness data is skipped (but
+// counted, so sizes and weights match what the node reports).
+// ============================================================================
+
+class ConsensusError : public std::runtime_error {
+  public:
+    explicit ConsensusError(const std::string& msg) : std::runtime_error(msg) {}
+};
+
+// A double-SHA256 hash in internal (little-endian) byte order, as serialized.
+struct Hash256 {
+    std::array<unsigned char, 32> bytes{};
+
+    // Display form: byte-reversed hex, as printed by bitcoind and block explorers.
+    [[nodiscard]] std::string hex() const;
+
+    // Parse the display form. Returns nullopt unless `hex` is 64 hex digits.
+    static std::optional<Hash256> from_hex(std::string_view hex);
+
+    bool operator==(const Hash256&) const = default;
+};
+
+struct BlockHeader {
+    int32_t  version = 0;
+    Hash256  prev_hash;
+    Hash256  merkle_root;
+    uint32_t time  = 0;
+    uint32_t bits  = 0;
+    uint32_t nonce = 0;
+
+    static constexpr size_t kSize = 80;
+};
+
+struct TxIn {
+    Hash256          prev_txid;
+    uint32_t         prev_vout = 0;
+    std::string_view script_sig; // view into the decoded buffer
+    uint32_t         sequence = 0;
+
+    // Coinbase inputs spend the null outpoint.
+    [[nodiscard]] bool is_coinbase() const;
+};
+
+struct TxOut {
+    int64_t          value = 0;     // satoshis
+    std::string_view script_pubkey; // view into the decoded buffer
+};
+
+struct Transaction {
+    int32_t            version = 0;
+    std::vector<TxIn>  vin;
+    std::vector<TxOut> vout;
+    uint32_t           locktime      = 0;
+    size_t             size          = 0; // serialized bytes, witness included
+    size_t             stripped_size = 0; // serialized bytes without witness data
+
+    [[nodiscard]] int64_t weight() const {
+        return static_cast<int64_t>(stripped_size * 3 + size);
+    }
+};
+
+struct Block {
+    BlockHeader              header;
+    std::vector<Transaction> txs;
+    size_t                   size          = 0;
+    size_t                   stripped_size = 0;
+
+    [[nodiscard]] int64_t weight() const {
+        return static_cast<int64_t>(stripped_size * 3 + size);
+    }
+};
+
+// Each decoder consumes the whole buffer and throws ConsensusError on
+// truncated or trailing data. Decoded scripts point into `data`, which must
+// outlive the result.
+BlockHeader              decode_header(std::string_view data);
+std::vector<BlockHeader> decode_headers(std::string_view data); // concatenated headers
+Transaction              decode_transaction(std::string_view data);
+Block                    decode_block(std::string_view data);
+
+// Difficulty for a compact target, computed as bitcoind's GetDifficulty() does.
+double difficulty_from_bits(uint32_t bits);
+
+// Height committed in a coinbase scriptSig (BIP34). Only meaningful for blocks
+// at or above the chain's BIP34 activation height; older coinbases start with
+// arbitrary data.
+std::optional<int64_t> bip34_height(std::string_view coinbase_script_sig);
+
+// Lowercase hex of raw bytes (e.g. a scriptSig for extract_miner()).
+std::string to_hex(std::string_view bytes);
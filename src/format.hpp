@@ -43,6 +43,18 @@ inline std::string fmt_bytes(int64_t b) {
     return ss.str();
 }
 
+inline std::string fmt_latency(std::chrono::microseconds d) {
+    std::ostringstream ss;
+    const auto         us = d.count();
+    if (us >= 1'000'000)
+        ss << std::fixed << std::setprecision(2) << static_cast<double>(us) / 1e6 << " s";
+    else if (us >= 1'000)
+        ss << std::fixed << std::setprecision(1) << static_cast<double>(us) / 1e3 << " ms";
+    else
+        ss << us << " \u00b5s";
+    return ss.str();
+}
+
 inline std::string fmt_difficulty(double d) {
     std::ostringstream ss;
     ss << std::fixed << std::setprecision(2);
@@ -4,22 +4,385 @@
 // Supported operations:
 //   parse, dump, operator[], contains, value, get<T>,
 //   is_null/bool/number/string/array/object, begin/end, size,
-//   initializer-list construction (object detection), json::array()
+//   initializer-list construction (object detection), json::array(),
+//   json::incremental_parser (push parsing of a text that arrives in pieces),
+//   json::sax_parse / json::sax_parser (events instead of a document),
+//   json::parse_document (a whole document in one arena, strings left in place),
+//   json::cursor (reading fields out of a text on demand, without a document),
+//   json_binding / json_bind (objects read straight into plain structs)
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
 #include <cmath>
 #include <concepts>
 #include <cstdint>
 #include <cstdio>
-#include <iomanip>
+#include <cstring>
+#include <functional>
+#include <iterator>
 #include <map>
-#include <sstream>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <optional>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define JSON_SIMD_SSE2 1
+#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define JSON_SIMD_NEON 1
+#endif
+
+class json;
+
+namespace json_detail {
+
+// Storage of json::object_t: the members in a vector sorted by key, found by
+// binary search with any string-like key, so a lookup allocates nothing and
+// iteration walks contiguous memory. A template only so that it can be
+// defined ahead of json, whose values it holds.
+template <typename Value> class flat_object {
+  public:
+    using value_type     = std::pair<std::string, Value>;
+    using iterator       = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+    [[nodiscard]] iterator       begin() { return members_.begin(); }
+    [[nodiscard]] iterator       end() { return members_.end(); }
+    [[nodiscard]] const_iterator begin() const { return members_.begin(); }
+    [[nodiscard]] const_iterator end() const { return members_.end(); }
+    [[nodiscard]] size_t         size() const { return members_.size(); }
+    [[nodiscard]] bool           empty() const { return members_.empty(); }
+
+    void reserve(size_t n) { members_.reserve(n); }
+    void clear() { members_.clear(); }
+
+    [[nodiscard]] iterator find(std::string_view key) {
+        auto it = lower_bound(key);
+        return it != members_.end() && it->first == key ? it : members_.end();
+    }
+    [[nodiscard]] const_iterator find(std::string_view key) const {
+        return const_cast<flat_object*>(this)->find(key);
+    }
+    [[nodiscard]] bool contains(std::string_view key) const { return find(key) != end(); }
+
+    Value& operator[](std::string_view key) {
+        auto it = lower_bound(key);
+        if (it == members_.end() || it->first != key)
+            it = members_.emplace(it, std::string(key), Value());
+        return it->second;
+    }
+
+    void insert_or_assign(std::string key, Value v) {
+        auto it = lower_bound(key);
+        if (it != members_.end() && it->first == key)
+            it->second = std::move(v);
+        else
+            members_.emplace(it, std::move(key), std::move(v));
+    }
+
+  private:
+    friend class ::json;
+
+    std::vector<value_type> members_;
+
+    static bool key_less(const value_type& a, const value_type& b) { return a.first < b.first; }
+
+    iterator lower_bound(std::string_view key) {
+        return std::lower_bound(
+            members_.begin(), members_.end(), key,
+            [](const value_type& m, std::string_view k) { return std::string_view(m.first) < k; });
+    }
+
+    // For parsers: members go in in text order, then sort() puts them in
+    // order once the object is complete. No lookups in between.
+    void append(std::string key, Value v) { members_.emplace_back(std::move(key), std::move(v)); }
+
+    // Sorted by key; of duplicate keys the last one appended wins.
+    void sort() {
+        const auto unordered = [](const value_type& a, const value_type& b) {
+            return !key_less(a, b);
+        };
+        if (std::adjacent_find(members_.begin(), members_.end(), unordered) == members_.end())
+            return;
+        std::stable_sort(members_.begin(), members_.end(), key_less);
+        auto out = members_.begin();
+        for (auto it = members_.begin(); it != members_.end(); ++it) {
+            const auto next = std::next(it);
+            if (next != members_.end() && next->first == it->first)
+                continue;
+            if (out != it)
+                *out = std::move(*it);
+            ++out;
+        }
+        members_.erase(out, members_.end());
+    }
+};
+
+// The number in [first, last) as a double, read without allocating; false
+// unless all of it is a number.
+[[nodiscard]] inline bool parse_double(const char* first, const char* last, double& out) {
+#if defined(__cpp_lib_to_chars)
+    const auto r = std::from_chars(first, last, out);
+    return r.ec == std::errc{} && r.ptr == last;
+#else
+    // No floating-point from_chars (libc++ before 20): strtod wants a
+    // terminated string, which a number token fits on the stack.
+    char         buf[64];
+    const size_t n = static_cast<size_t>(last - first);
+    if (n >= sizeof(buf))
+        return false;
+    std::memcpy(buf, first, n);
+    buf[n]    = '\0';
+    char* end = nullptr;
+    out       = std::strtod(buf, &end);
+    return n > 0 && end == buf + n;
+#endif
+}
+
+// Appends the shortest text that reads back as `v`, which is finite.
+inline void write_double(std::string& out, double v) {
+    char buf[32];
+#if defined(__cpp_lib_to_chars)
+    out.append(buf, std::to_chars(buf, buf + sizeof(buf), v).ptr);
+#else
+    // %g drops trailing zeros, so the first precision that reads back gives
+    // the fewest digits; 17 always does.
+    for (int precision = 15;; ++precision) {
+        const int n = std::snprintf(buf, sizeof(buf), "%.*g", precision, v);
+        if (precision == 17 || std::strtod(buf, nullptr) == v) {
+            out.append(buf, static_cast<size_t>(n));
+            return;
+        }
+    }
+#endif
+}
+
+// Scanning kernels: 16 bytes at a time with SSE2 (x86-64) or NEON (ARM64),
+// which every CPU of those architectures has, a byte at a time elsewhere.
+// They never read at or past `end`.
+
+[[nodiscard]] inline bool is_ws(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Ends a run of string contents: a quote, a backslash or a control byte.
+[[nodiscard]] inline bool is_string_special(char c) {
+    return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+}
+
+#ifdef JSON_SIMD_NEON
+// One nibble per byte of a comparison result, as a 64-bit mask.
+[[nodiscard]] inline uint64_t neon_mask(uint8x16_t m) {
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+}
+#endif
+
+// The first byte in [p, end) that is not whitespace, or end.
+[[nodiscard]] inline const char* skip_ws(const char* p, const char* end) {
+    if (p == end || !is_ws(*p)) // the common case in the compact text nodes send
+        return p;
+#ifdef JSON_SIMD_SSE2
+    const __m128i sp = _mm_set1_epi8(' '), nl = _mm_set1_epi8('\n');
+    const __m128i tab = _mm_set1_epi8('\t'), cr = _mm_set1_epi8('\r');
+    for (; end - p >= 16; p += 16) {
+        const __m128i  v     = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i  space = _mm_or_si128(_mm_cmpeq_epi8(v, sp), _mm_cmpeq_epi8(v, nl));
+        const __m128i  ws    = _mm_or_si128(space, _mm_or_si128(_mm_cmpeq_epi8(v, tab),
+                                                                _mm_cmpeq_epi8(v, cr)));
+        const unsigned other = ~static_cast<unsigned>(_mm_movemask_epi8(ws)) & 0xFFFFu;
+        if (other)
+            return p + std::countr_zero(other);
+    }
+#elif defined(JSON_SIMD_NEON)
+    const uint8x16_t sp = vdupq_n_u8(' '), nl = vdupq_n_u8('\n');
+    const uint8x16_t tab = vdupq_n_u8('\t'), cr = vdupq_n_u8('\r');
+    for (; end - p >= 16; p += 16) {
+        const uint8x16_t v     = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+        const uint8x16_t ws    = vorrq_u8(vorrq_u8(vceqq_u8(v, sp), vceqq_u8(v, nl)),
+                                          vorrq_u8(vceqq_u8(v, tab), vceqq_u8(v, cr)));
+        const uint64_t   other = ~neon_mask(ws);
+        if (other)
+            return p + std::countr_zero(other) / 4;
+    }
+#endif
+    while (p < end && is_ws(*p))
+        ++p;
+    return p;
+}
+
+// The first quote, backslash or control byte in [p, end), or end.
+[[nodiscard]] inline const char* find_string_special(const char* p, const char* end) {
+#ifdef JSON_SIMD_SSE2
+    const __m128i quote = _mm_set1_epi8('"'), slash = _mm_set1_epi8('\\');
+    const __m128i max_control = _mm_set1_epi8(0x1F);
+    for (; end - p >= 16; p += 16) {
+        const __m128i v       = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(v, max_control), v); // v <= 0x1F
+        const __m128i special =
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, slash)), control);
+        if (const unsigned m = static_cast<unsigned>(_mm_movemask_epi8(special)))
+            return p + std::countr_zero(m);
+    }
+#elif defined(JSON_SIMD_NEON)
+    const uint8x16_t quote = vdupq_n_u8('"'), slash = vdupq_n_u8('\\');
+    const uint8x16_t min_printable = vdupq_n_u8(0x20);
+    for (; end - p >= 16; p += 16) {
+        const uint8x16_t v       = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+        const uint8x16_t special = vorrq_u8(vorrq_u8(vceqq_u8(v, quote), vceqq_u8(v, slash)),
+                                            vcltq_u8(v, min_printable));
+        if (const uint64_t m = neon_mask(special))
+            return p + std::countr_zero(m) / 4;
+    }
+#endif
+    while (p < end && !is_string_special(*p))
+        ++p;
+    return p;
+}
+
+// Opens or closes a string or a container.
+[[nodiscard]] inline bool is_nesting(char c) {
+    return c == '"' || c == '[' || c == ']' || c == '{' || c == '}';
+}
+
+// The first quote or bracket in [p, end), or end.
+[[nodiscard]] inline const char* find_nesting(const char* p, const char* end) {
+    // '[' and ']' are '{' and '}' without bit 5, so two compares find all four.
+#ifdef JSON_SIMD_SSE2
+    const __m128i quote = _mm_set1_epi8('"'), bit5 = _mm_set1_epi8(0x20);
+    const __m128i open = _mm_set1_epi8('{'), close = _mm_set1_epi8('}');
+    for (; end - p >= 16; p += 16) {
+        const __m128i v       = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const __m128i folded  = _mm_or_si128(v, bit5);
+        const __m128i bracket = _mm_or_si128(_mm_cmpeq_epi8(folded, open),
+                                             _mm_cmpeq_epi8(folded, close));
+        const __m128i nesting = _mm_or_si128(bracket, _mm_cmpeq_epi8(v, quote));
+        if (const unsigned m = static_cast<unsigned>(_mm_movemask_epi8(nesting)))
+            return p + std::countr_zero(m);
+    }
+#elif defined(JSON_SIMD_NEON)
+    const uint8x16_t quote = vdupq_n_u8('"'), bit5 = vdupq_n_u8(0x20);
+    const uint8x16_t open = vdupq_n_u8('{'), close = vdupq_n_u8('}');
+    for (; end - p >= 16; p += 16) {
+        const uint8x16_t v       = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+        const uint8x16_t folded  = vorrq_u8(v, bit5);
+        const uint8x16_t nesting = vorrq_u8(
+            vorrq_u8(vceqq_u8(folded, open), vceqq_u8(folded, close)), vceqq_u8(v, quote));
+        if (const uint64_t m = neon_mask(nesting))
+            return p + std::countr_zero(m) / 4;
+    }
+#endif
+    while (p < end && !is_nesting(*p))
+        ++p;
+    return p;
+}
+
+#if defined(JSON_SIMD_SSE2) || defined(JSON_SIMD_NEON)
+// Bit i set where p[i] is a quote, a backslash, an opening or a closing bracket.
+struct nesting_masks {
+    unsigned quote, slash, open, close;
+};
+
+[[nodiscard]] inline nesting_masks nesting_block(const char* p) {
+#ifdef JSON_SIMD_SSE2
+    const __m128i v      = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i folded = _mm_or_si128(v, _mm_set1_epi8(0x20));
+    auto mask = [](__m128i m) { return static_cast<unsigned>(_mm_movemask_epi8(m)); };
+    return {mask(_mm_cmpeq_epi8(v, _mm_set1_epi8('"'))),
+            mask(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))),
+            mask(_mm_cmpeq_epi8(folded, _mm_set1_epi8('{'))),
+            mask(_mm_cmpeq_epi8(folded, _mm_set1_epi8('}')))};
+#else
+    static constexpr uint8_t kBits[16] = {1, 2, 4, 8, 16, 32, 64, 128,
+                                          1, 2, 4, 8, 16, 32, 64, 128};
+    const uint8x16_t         v         = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+    const uint8x16_t         folded    = vorrq_u8(v, vdupq_n_u8(0x20));
+    const uint8x16_t         bits      = vld1q_u8(kBits);
+    auto                     mask      = [&](uint8x16_t m) {
+        const uint8x16_t t = vandq_u8(m, bits);
+        return static_cast<unsigned>(vaddv_u8(vget_low_u8(t))) |
+               static_cast<unsigned>(vaddv_u8(vget_high_u8(t))) << 8;
+    };
+    return {mask(vceqq_u8(v, vdupq_n_u8('"'))), mask(vceqq_u8(v, vdupq_n_u8('\\'))),
+            mask(vceqq_u8(folded, vdupq_n_u8('{'))), mask(vceqq_u8(folded, vdupq_n_u8('}')))};
+#endif
+}
+#endif
+
+// Past the bracket closing the container opened at `p`, or null if the text
+// ends first. Blocks without a backslash are read from their masks alone: a
+// prefix XOR of the quote bits marks what lies inside strings, leaving only
+// the brackets outside them to look at.
+[[nodiscard]] inline const char* skip_container(const char* p, const char* end) {
+    size_t depth     = 0;
+    bool   in_string = false;
+    bool   escaped   = false;
+    auto   step      = [&](char c) { // true at the closing bracket
+        if (in_string) {
+            if (escaped)
+                escaped = false;
+            else if (c == '\\')
+                escaped = true;
+            else if (c == '"')
+                in_string = false;
+        } else if (c == '"') {
+            in_string = true;
+        } else if (c == '{' || c == '[') {
+            ++depth;
+        } else if (c == '}' || c == ']') {
+            return --depth == 0;
+        }
+        return false;
+    };
+    while (p < end) {
+#if defined(JSON_SIMD_SSE2) || defined(JSON_SIMD_NEON)
+        if (end - p >= 16 && !escaped) {
+            const nesting_masks m = nesting_block(p);
+            if (m.slash) { // escapes: byte by byte
+                for (const char* block_end = p + 16; p < block_end; ++p) {
+                    if (step(*p))
+                        return p + 1;
+                }
+                continue;
+            }
+            unsigned inside = m.quote;
+            inside ^= inside << 1;
+            inside ^= inside << 2;
+            inside ^= inside << 4;
+            inside ^= inside << 8;
+            if (in_string)
+                inside = ~inside;
+            for (unsigned b = (m.open | m.close) & ~inside & 0xFFFFu; b; b &= b - 1) {
+                const int i = std::countr_zero(b);
+                if (m.open >> i & 1u)
+                    ++depth;
+                else if (--depth == 0)
+                    return p + i + 1;
+            }
+            in_string = in_string != ((std::popcount(m.quote) & 1) != 0);
+            p += 16;
+            continue;
+        }
+#endif
+        if (step(*p++))
+            return p;
+    }
+    return nullptr;
+}
+
+} // namespace json_detail
+
 class json {
   public:
     // -----------------------------------------------------------------------
@@ -30,35 +393,155 @@ class json {
         explicit exception(const std::string& msg) : std::runtime_error(msg) {}
     };
 
-    using object_t = std::map<std::string, json>;
+    using object_t = json_detail::flat_object<json>;
     using array_t  = std::vector<json>;
 
+    class sax_handler;
+    class sax_parser;
+    class incremental_parser;
+    class items_view;
+    class cursor;
+
   private:
-    enum class Kind { Null, Bool, Int, Float, String, Array, Object };
+    enum class Kind : uint8_t { Null, Bool, Int, Float, String, Array, Object, Shared };
+
+    struct document;
+    struct document_builder;
+    struct member;       // an object member while a document is built: {key, value}
+    struct object_block; // an object of a document: its shared key table, then its values
+
+    // Kind::Shared: a handle to a node of a document, keeping the document alive.
+    struct Ref {
+        std::shared_ptr<const document> doc;
+        const json*                     node;
+    };
+
+    // A tagged union: 16 bytes whatever the kind. Strings and containers live
+    // on the heap, owned by the node, unless the node belongs to a document
+    // (see parse_document): then arena_ is set, the node owns nothing, and its
+    // string, elements or members are the len_ entries at str_, items_ or
+    // object_, all in the document's arena.
+    Kind     kind_  = Kind::Null;
+    bool     arena_ = false;
+    uint32_t len_   = 0;
+    union {
+        bool                bval_;
+        int64_t             ival_ = 0;
+        double              fval_;
+        std::string*        sval_;
+        array_t*            aval_;
+        object_t*           oval_;
+        const char*         str_;
+        const json*         items_;
+        const object_block* object_;
+        Ref*                ref_;
+    };
 
-    Kind        kind_ = Kind::Null;
-    bool        bval_ = false;
-    int64_t     ival_ = 0;
-    double      fval_ = 0.0;
-    std::string sval_;
-    array_t     aval_;
-    object_t    oval_;
+    // Takes over o's value, leaving o null.
+    void take(json& o) noexcept {
+        kind_  = o.kind_;
+        arena_ = o.arena_;
+        len_   = o.len_;
+        switch (kind_) {
+        case Kind::Null:
+        case Kind::Int:
+            ival_ = o.ival_;
+            break;
+        case Kind::Bool:
+            bval_ = o.bval_;
+            break;
+        case Kind::Float:
+            fval_ = o.fval_;
+            break;
+        case Kind::String:
+            if (arena_)
+                str_ = o.str_;
+            else
+                sval_ = o.sval_;
+            break;
+        case Kind::Array:
+            if (arena_)
+                items_ = o.items_;
+            else
+                aval_ = o.aval_;
+            break;
+        case Kind::Object:
+            if (arena_)
+                object_ = o.object_;
+            else
+                oval_ = o.oval_;
+            break;
+        case Kind::Shared:
+            ref_ = o.ref_;
+            break;
+        }
+        o.kind_  = Kind::Null;
+        o.arena_ = false;
+    }
+
+    void destroy() noexcept {
+        if (!arena_) {
+            switch (kind_) {
+            case Kind::String:
+                delete sval_;
+                break;
+            case Kind::Array:
+                delete aval_;
+                break;
+            case Kind::Object:
+                delete oval_;
+                break;
+            case Kind::Shared:
+                delete ref_;
+                break;
+            default:
+                break;
+            }
+        }
+        kind_  = Kind::Null;
+        arena_ = false;
+    }
+
+    // The node a handle refers to; any other node is its own target.
+    [[nodiscard]] const json& target() const noexcept {
+        return kind_ == Kind::Shared ? *ref_->node : *this;
+    }
+
+    // Handles are read-only: non-const access through one throws rather than
+    // copy the document out of its arena behind the caller's back.
+    void writable() const {
+        if (kind_ == Kind::Shared)
+            throw exception("Document is read-only: read it through a const json&, or copy()");
+    }
+
+    // Contents of a string or array node, not of a handle.
+    [[nodiscard]] std::string_view str() const {
+        return arena_ ? std::string_view(str_, len_) : std::string_view(*sval_);
+    }
+
+    [[nodiscard]] std::span<const json> elements() const {
+        if (kind_ != Kind::Array)
+            return {};
+        return arena_ ? std::span<const json>(items_, len_) : std::span<const json>(*aval_);
+    }
+
+    // The member `key` of an object, or nullptr.
+    [[nodiscard]] const json* find(std::string_view key) const noexcept;
+
+    // A heap copy of the members of a document's object.
+    [[nodiscard]] static object_t* copy_members(const json& o);
 
     // -----------------------------------------------------------------------
     // Recursive-descent parser
     // -----------------------------------------------------------------------
     struct Parser {
-        const std::string& src;
-        size_t             pos = 0;
+        std::string_view src; // not owned: parse() reads the caller's buffer in place
+        size_t           pos = 0;
 
         void skip_ws() {
-            while (pos < src.size()) {
-                char c = src[pos];
-                if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
-                    ++pos;
-                else
-                    break;
-            }
+            const char* begin = src.data();
+            const char* end   = begin + src.size();
+            pos               = static_cast<size_t>(json_detail::skip_ws(begin + pos, end) - begin);
         }
 
         [[nodiscard]] char peek() {
@@ -82,7 +565,17 @@ class json {
         std::string parse_string_val() {
             expect('"');
             std::string out;
+            const char* begin = src.data();
+            const char* end   = begin + src.size();
             while (pos < src.size()) {
+                // Copy the run up to the next quote, backslash or control byte
+                // in one go; control bytes are taken as they are.
+                const char* run  = begin + pos;
+                const char* stop = json_detail::find_string_special(run, end);
+                out.append(run, stop);
+                pos = static_cast<size_t>(stop - begin);
+                if (stop == end)
+                    break;
                 char c = src[pos++];
                 if (c == '"')
                     return out;
@@ -176,32 +669,32 @@ class json {
                 while (pos < src.size() && src[pos] >= '0' && src[pos] <= '9')
                     ++pos;
             }
-            const std::string num = src.substr(start, pos - start);
-            json              j;
-            if (is_float) {
-                j.kind_ = Kind::Float;
-                j.fval_ = std::stod(num);
-            } else {
-                j.kind_ = Kind::Int;
-                j.ival_ = std::stoll(num);
+            const char* first = src.data() + start;
+            const char* last  = src.data() + pos;
+            json        j;
+            if (!is_float) {
+                const auto r = std::from_chars(first, last, j.ival_);
+                if (r.ec == std::errc{} && r.ptr == last) {
+                    j.kind_ = Kind::Int;
+                    return j;
+                }
+                // An integer past the range of int64_t is kept as a double.
             }
+            if (!json_detail::parse_double(first, last, j.fval_))
+                throw exception("Bad number: " + std::string(first, last));
+            j.kind_ = Kind::Float;
             return j;
         }
 
         [[nodiscard]] json parse_value() {
             const char c = peek();
 
-            if (c == '"') {
-                json j;
-                j.kind_ = Kind::String;
-                j.sval_ = parse_string_val();
-                return j;
-            }
+            if (c == '"')
+                return json(parse_string_val());
 
             if (c == '{') {
                 consume();
-                json j;
-                j.kind_ = Kind::Object;
+                json j = object();
                 if (peek() == '}') {
                     consume();
                     return j;
@@ -209,7 +702,7 @@ class json {
                 while (true) {
                     std::string key = parse_string_val();
                     expect(':');
-                    j.oval_[key]   = parse_value();
+                    j.oval_->append(std::move(key), parse_value());
                     const char sep = peek();
                     if (sep == '}') {
                         consume();
@@ -221,19 +714,19 @@ class json {
                     }
                     throw exception("Expected ',' or '}'");
                 }
+                j.oval_->sort();
                 return j;
             }
 
             if (c == '[') {
                 consume();
-                json j;
-                j.kind_ = Kind::Array;
+                json j = array();
                 if (peek() == ']') {
                     consume();
                     return j;
                 }
                 while (true) {
-                    j.aval_.push_back(parse_value());
+                    j.aval_->push_back(parse_value());
                     const char sep = peek();
                     if (sep == ']') {
                         consume();
@@ -282,113 +775,65 @@ class json {
     // -----------------------------------------------------------------------
     // Serialization helpers
     // -----------------------------------------------------------------------
-    [[nodiscard]] static std::string quote(const std::string& s) {
-        std::string out = "\"";
-        for (unsigned char c : s) {
-            switch (c) {
-            case '"':
-                out += "\\\"";
-                break;
-            case '\\':
-                out += "\\\\";
-                break;
-            case '\b':
-                out += "\\b";
-                break;
-            case '\f':
-                out += "\\f";
-                break;
-            case '\n':
-                out += "\\n";
-                break;
-            case '\r':
-                out += "\\r";
-                break;
-            case '\t':
-                out += "\\t";
-                break;
-            default:
-                if (c < 0x20) {
-                    char buf[8];
-                    std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<int>(c));
-                    out += buf;
-                } else {
-                    out += static_cast<char>(c);
-                }
-            }
-        }
-        out += '"';
-        return out;
+    // Everything is appended to the caller's buffer: runs of a string that
+    // need no escaping are copied whole and numbers are formatted in place.
+    static void write_newline(std::string& out, int indent, int depth) {
+        out += '\n';
+        out.append(static_cast<size_t>(depth * indent), ' ');
     }
 
-    [[nodiscard]] std::string dump_impl(int indent, int depth) const {
-        const bool pretty = indent >= 0;
+    void write(std::string& out, int indent, int depth) const {
         switch (kind_) {
         case Kind::Null:
-            return "null";
+            out += "null";
+            return;
         case Kind::Bool:
-            return bval_ ? "true" : "false";
-        case Kind::Int:
-            return std::to_string(ival_);
-        case Kind::Float: {
-            if (!std::isfinite(fval_))
-                return "null";
-            std::ostringstream ss;
-            ss << std::setprecision(17) << fval_;
-            return ss.str();
+            out += bval_ ? "true" : "false";
+            return;
+        case Kind::Int: {
+            char buf[24];
+            out.append(buf, std::to_chars(buf, buf + sizeof(buf), ival_).ptr);
+            return;
         }
+        case Kind::Float:
+            if (std::isfinite(fval_))
+                json_detail::write_double(out, fval_);
+            else
+                out += "null";
+            return;
         case Kind::String:
-            return quote(sval_);
+            dump_string(out, str());
+            return;
         case Kind::Array: {
-            if (aval_.empty())
-                return "[]";
-            std::string out = "[";
-            for (size_t i = 0; i < aval_.size(); ++i) {
+            const auto items = elements();
+            if (items.empty()) {
+                out += "[]";
+                return;
+            }
+            out += '[';
+            for (size_t i = 0; i < items.size(); ++i) {
                 if (i)
                     out += ',';
-                if (pretty) {
-                    out += '\n';
-                    out += std::string(static_cast<size_t>((depth + 1) * indent), ' ');
-                }
-                out += aval_[i].dump_impl(indent, depth + 1);
-            }
-            if (pretty) {
-                out += '\n';
-                out += std::string(static_cast<size_t>(depth * indent), ' ');
+                if (indent >= 0)
+                    write_newline(out, indent, depth + 1);
+                items[i].write(out, indent, depth + 1);
             }
+            if (indent >= 0)
+                write_newline(out, indent, depth);
             out += ']';
-            return out;
-        }
-        case Kind::Object: {
-            if (oval_.empty())
-                return "{}";
-            std::string out   = "{";
-            bool        first = true;
-            for (const auto& [k, v] : oval_) {
-                if (!first)
-                    out += ',';
-                if (pretty) {
-                    out += '\n';
-                    out += std::string(static_cast<size_t>((depth + 1) * indent), ' ');
-                }
-                out += quote(k);
-                out += ':';
-                if (pretty)
-                    out += ' ';
-                out += v.dump_impl(indent, depth + 1);
-                first = false;
-            }
-            if (pretty) {
-                out += '\n';
-                out += std::string(static_cast<size_t>(depth * indent), ' ');
-            }
-            out += '}';
-            return out;
+            return;
         }
+        case Kind::Object:
+            write_object(out, indent, depth);
+            return;
+        case Kind::Shared:
+            ref_->node->write(out, indent, depth);
+            return;
         }
-        return "null"; // unreachable
     }
 
+    void write_object(std::string& out, int indent, int depth) const;
+
   public:
     // -----------------------------------------------------------------------
     // Constructors
@@ -396,6 +841,55 @@ class json {
     json() = default;
     json(std::nullptr_t) {}
 
+    // A copy of a document's node is an ordinary heap value; a copy of a
+    // handle shares the document.
+    json(const json& o) : kind_(o.kind_) {
+        switch (kind_) {
+        case Kind::String:
+            sval_ = new std::string(o.str());
+            break;
+        case Kind::Array: {
+            const auto items = o.elements();
+            aval_            = new array_t(items.begin(), items.end());
+            break;
+        }
+        case Kind::Object:
+            oval_ = o.arena_ ? copy_members(o) : new object_t(*o.oval_);
+            break;
+        case Kind::Shared:
+            ref_ = new Ref(*o.ref_);
+            break;
+        case Kind::Bool:
+            bval_ = o.bval_;
+            break;
+        case Kind::Float:
+            fval_ = o.fval_;
+            break;
+        case Kind::Null:
+        case Kind::Int:
+            ival_ = o.ival_;
+            break;
+        }
+    }
+
+    json(json&& o) noexcept { take(o); }
+
+    // Through a temporary, so assigning a node its own descendant is safe.
+    json& operator=(const json& o) {
+        json copy(o);
+        destroy();
+        take(copy);
+        return *this;
+    }
+    json& operator=(json&& o) noexcept {
+        json moved(std::move(o));
+        destroy();
+        take(moved);
+        return *this;
+    }
+
+    ~json() { destroy(); }
+
     // Bool must come before the integral concept to take precedence
     json(bool v) : kind_(Kind::Bool), bval_(v) {}
 
@@ -408,52 +902,61 @@ class json {
     template <std::floating_point T>
     json(T v) : kind_(Kind::Float), fval_(static_cast<double>(v)) {}
 
-    json(const char* v) : kind_(Kind::String), sval_(v ? v : "") {}
-    json(const std::string& v) : kind_(Kind::String), sval_(v) {}
-    json(std::string&& v) : kind_(Kind::String), sval_(std::move(v)) {}
+    json(const char* v) : kind_(Kind::String), sval_(new std::string(v ? v : "")) {}
+    json(const std::string& v) : kind_(Kind::String), sval_(new std::string(v)) {}
+    json(std::string&& v) : kind_(Kind::String), sval_(new std::string(std::move(v))) {}
 
-    json(array_t v) : kind_(Kind::Array), aval_(std::move(v)) {}
-    json(object_t v) : kind_(Kind::Object), oval_(std::move(v)) {}
+    json(array_t v) : kind_(Kind::Array), aval_(new array_t(std::move(v))) {}
+    json(object_t v) : kind_(Kind::Object), oval_(new object_t(std::move(v))) {}
 
     // Initializer-list: {{"key",val},{"key2",val2}} → object
     //                   {val1, val2, …}             → array
     json(std::initializer_list<json> init) {
         bool all_pairs = true;
         for (const auto& el : init) {
-            if (!el.is_array() || el.aval_.size() != 2 || !el.aval_[0].is_string()) {
+            const auto pair = el.target().elements();
+            if (pair.size() != 2 || !pair[0].is_string()) {
                 all_pairs = false;
                 break;
             }
         }
 
         if (all_pairs) {
+            object_t members;
+            members.reserve(init.size());
+            for (const auto& el : init) {
+                const auto pair = el.target().elements();
+                members.append(std::string(pair[0].str()), pair[1]);
+            }
+            members.sort();
+            oval_ = new object_t(std::move(members));
             kind_ = Kind::Object;
-            for (const auto& el : init)
-                oval_[el.aval_[0].sval_] = el.aval_[1];
         } else {
+            aval_ = new array_t(init);
             kind_ = Kind::Array;
-            aval_ = array_t(init);
         }
     }
 
     // -----------------------------------------------------------------------
     // Type queries
     // -----------------------------------------------------------------------
-    [[nodiscard]] bool is_null() const noexcept { return kind_ == Kind::Null; }
-    [[nodiscard]] bool is_bool() const noexcept { return kind_ == Kind::Bool; }
+    [[nodiscard]] bool is_null() const noexcept { return target().kind_ == Kind::Null; }
+    [[nodiscard]] bool is_bool() const noexcept { return target().kind_ == Kind::Bool; }
     [[nodiscard]] bool is_number() const noexcept {
-        return kind_ == Kind::Int || kind_ == Kind::Float;
+        return target().kind_ == Kind::Int || target().kind_ == Kind::Float;
     }
-    [[nodiscard]] bool is_number_integer() const noexcept { return kind_ == Kind::Int; }
-    [[nodiscard]] bool is_number_float() const noexcept { return kind_ == Kind::Float; }
-    [[nodiscard]] bool is_string() const noexcept { return kind_ == Kind::String; }
-    [[nodiscard]] bool is_array() const noexcept { return kind_ == Kind::Array; }
-    [[nodiscard]] bool is_object() const noexcept { return kind_ == Kind::Object; }
+    [[nodiscard]] bool is_number_integer() const noexcept { return target().kind_ == Kind::Int; }
+    [[nodiscard]] bool is_number_float() const noexcept { return target().kind_ == Kind::Float; }
+    [[nodiscard]] bool is_string() const noexcept { return target().kind_ == Kind::String; }
+    [[nodiscard]] bool is_array() const noexcept { return target().kind_ == Kind::Array; }
+    [[nodiscard]] bool is_object() const noexcept { return target().kind_ == Kind::Object; }
 
     // -----------------------------------------------------------------------
     // Typed get<T>  (uses concepts in if constexpr for clarity)
     // -----------------------------------------------------------------------
     template <typename T> [[nodiscard]] T get() const {
+        if (kind_ == Kind::Shared)
+            return ref_->node->get<T>();
         if constexpr (std::same_as<T, bool>) {
             if (kind_ != Kind::Bool)
                 throw exception("get<bool> on non-bool");
@@ -473,113 +976,136 @@ class json {
         } else if constexpr (std::same_as<T, std::string>) {
             if (kind_ != Kind::String)
                 throw exception("get<string> on non-string");
-            return sval_;
+            return std::string(str());
+        } else if constexpr (std::same_as<T, std::string_view>) {
+            // Valid as long as this value is, and not modified.
+            if (kind_ != Kind::String)
+                throw exception("get<string> on non-string");
+            return str();
         }
         throw exception("get: unsupported type");
     }
 
+    // A BTC amount as an exact number of satoshis, e.g. 0.00001234 -> 1234,
+    // without the rounding error of multiplying by 1e8 (0.29 * 1e8 is
+    // 28999999.999999996). Exact for every amount Bitcoin Core prints: at most
+    // 8 decimals, less than 2^25 BTC in magnitude. Throws json::exception for
+    // non-numbers and larger amounts.
+    [[nodiscard]] int64_t get_sats() const;
+
     // -----------------------------------------------------------------------
     // Access operators
     // -----------------------------------------------------------------------
-    json& operator[](const std::string& key) {
-        if (kind_ == Kind::Null)
+    // Non-const access to a handle into a document throws json::exception
+    // (see parse_document). On a temporary, such as a reply straight from
+    // RpcClient::call, it is a read: a handle to the member, or the member
+    // itself moved out.
+    json& operator[](std::string_view key) & {
+        writable();
+        if (kind_ == Kind::Null) {
+            oval_ = new object_t;
             kind_ = Kind::Object;
+        }
         if (kind_ != Kind::Object)
             throw exception("operator[string] on non-object");
-        return oval_[key];
+        return (*oval_)[key];
+    }
+
+    [[nodiscard]] json operator[](std::string_view key) && {
+        if (kind_ == Kind::Shared)
+            return share(std::as_const(*this)[key]);
+        return std::move((*this)[key]);
     }
 
-    [[nodiscard]] const json& operator[](const std::string& key) const {
+    [[nodiscard]] const json& operator[](std::string_view key) const& {
         static const json null_val{};
-        if (kind_ != Kind::Object)
-            return null_val;
-        auto it = oval_.find(key);
-        return it != oval_.end() ? it->second : null_val;
+        const json*       v = target().find(key);
+        return v ? *v : null_val;
     }
 
-    json& operator[](size_t i) {
+    json& operator[](size_t i) & {
+        writable();
         if (kind_ != Kind::Array)
             throw exception("operator[size_t] on non-array");
-        return aval_[i];
+        return (*aval_)[i];
     }
-    [[nodiscard]] const json& operator[](size_t i) const {
-        if (kind_ != Kind::Array)
+    [[nodiscard]] json operator[](size_t i) && {
+        if (kind_ == Kind::Shared)
+            return share(std::as_const(*this)[i]);
+        return std::move((*this)[i]);
+    }
+    [[nodiscard]] const json& operator[](size_t i) const& {
+        const json& t = target();
+        if (t.kind_ != Kind::Array)
             throw exception("operator[size_t] on non-array");
-        return aval_[i];
+        return t.elements()[i];
     }
 
-    [[nodiscard]] bool contains(const std::string& key) const noexcept {
-        return kind_ == Kind::Object && oval_.contains(key);
+    [[nodiscard]] bool contains(std::string_view key) const noexcept {
+        return target().find(key) != nullptr;
     }
 
     // value() with typed default (bool, integral, float)
-    template <typename T> [[nodiscard]] T value(const std::string& key, const T& def) const {
-        if (kind_ != Kind::Object)
-            return def;
-        auto it = oval_.find(key);
-        if (it == oval_.end() || it->second.is_null())
+    template <typename T> [[nodiscard]] T value(std::string_view key, const T& def) const {
+        const json* v = target().find(key);
+        if (!v || v->is_null())
             return def;
         try {
-            return it->second.get<T>();
+            return v->get<T>();
         } catch (...) {
             return def;
         }
     }
 
     // value() with const char* default → returns std::string
-    [[nodiscard]] std::string value(const std::string& key, const char* def) const {
+    [[nodiscard]] std::string value(std::string_view key, const char* def) const {
         const char* fallback = def ? def : "";
-        if (kind_ != Kind::Object)
-            return fallback;
-        auto it = oval_.find(key);
-        if (it == oval_.end() || it->second.is_null())
+        const json* v        = target().find(key);
+        if (!v || v->kind_ != Kind::String)
             return fallback;
-        if (it->second.kind_ != Kind::String)
-            return fallback;
-        return it->second.sval_;
+        return std::string(v->str());
     }
 
     [[nodiscard]] size_t size() const noexcept {
-        if (kind_ == Kind::Array)
-            return aval_.size();
-        if (kind_ == Kind::Object)
-            return oval_.size();
+        const json& t = target();
+        if (t.kind_ == Kind::Array)
+            return t.elements().size();
+        if (t.kind_ == Kind::Object)
+            return t.arena_ ? t.len_ : t.oval_->size();
         return 0;
     }
     [[nodiscard]] bool empty() const noexcept { return size() == 0; }
 
     // -----------------------------------------------------------------------
-    // Iteration (arrays)
+    // Iteration (arrays) — anything else iterates as empty
     // -----------------------------------------------------------------------
-    auto begin() { return aval_.begin(); }
-    auto end() { return aval_.end(); }
-    auto begin() const { return aval_.begin(); }
-    auto end() const { return aval_.end(); }
+    auto begin() {
+        writable();
+        return kind_ == Kind::Array ? aval_->begin() : array_t::iterator{};
+    }
+    auto end() {
+        writable();
+        return kind_ == Kind::Array ? aval_->end() : array_t::iterator{};
+    }
+    [[nodiscard]] const json* begin() const { return target().elements().data(); }
+    [[nodiscard]] const json* end() const {
+        const auto items = target().elements();
+        return items.data() + items.size();
+    }
 
     // -----------------------------------------------------------------------
-    // Iteration (objects) — returns reference to underlying map so callers
-    // can iterate with range-for and access .first/.second (key/value).
+    // Iteration (objects) — (key, value) pairs in key order, for range-for
+    // with structured bindings: for (const auto& [key, value] : j.items())
     // -----------------------------------------------------------------------
-    [[nodiscard]] const object_t& items() const {
-        static const object_t empty_map{};
-        return kind_ == Kind::Object ? oval_ : empty_map;
-    }
+    [[nodiscard]] items_view items() const;
 
     // -----------------------------------------------------------------------
     // Static factories
     // -----------------------------------------------------------------------
-    [[nodiscard]] static json array() {
-        json j;
-        j.kind_ = Kind::Array;
-        return j;
-    }
-    [[nodiscard]] static json object() {
-        json j;
-        j.kind_ = Kind::Object;
-        return j;
-    }
+    [[nodiscard]] static json array() { return json(array_t{}); }
+    [[nodiscard]] static json object() { return json(object_t{}); }
 
-    [[nodiscard]] static json parse(const std::string& s) {
+    [[nodiscard]] static json parse(std::string_view s) {
         Parser p{s};
         json   result = p.parse_value();
         p.skip_ws();
@@ -588,8 +1114,1287 @@ class json {
         return result;
     }
 
+    // Parse `s` as a document: every node goes into one arena, and strings and
+    // keys without escapes stay in `s`, which the document keeps. The result is
+    // a handle to it; copies share the document, which is freed in one go with
+    // the last of them. Lookups in objects are binary searches over their
+    // members, sorted once when the object is complete.
+    //
+    // Meant for responses that are read and then dropped: reading costs the
+    // same as for a parse()d value. The handle is read-only; non-const access
+    // through it throws json::exception, and copy() gives a value that can be
+    // changed.
+    [[nodiscard]] static json parse_document(std::string s);
+
+    // A value for `part`, a node reached from this one: a handle sharing the
+    // document if this is one, a copy otherwise. Lets a piece of a document
+    // outlive the handle it came from without being copied out of it.
+    [[nodiscard]] json share(const json& part) const;
+
+    // An ordinary heap value equal to this one, which can be changed: for a
+    // handle, a copy of its node out of the document.
+    [[nodiscard]] json copy() const { return json(target()); }
+
+    // Parse `s` into events on `handler` instead of a document (see sax_handler).
+    static void sax_parse(std::string_view s, sax_handler& handler);
+
     // -----------------------------------------------------------------------
     // Serialization
     // -----------------------------------------------------------------------
-    [[nodiscard]] std::string dump(int indent = -1) const { return dump_impl(indent, 0); }
+    [[nodiscard]] std::string dump(int indent = -1) const {
+        std::string out;
+        write(out, indent, 0);
+        return out;
+    }
+
+    // Appends what dump() returns to `out`, so a larger text (a request, a
+    // batch of them) is written into one buffer instead of pieced together.
+    void dump_to(std::string& out, int indent = -1) const { write(out, indent, 0); }
+
+    // Appends `s` as a JSON string.
+    static void dump_string(std::string& out, std::string_view s) {
+        out += '"';
+        const char* p   = s.data();
+        const char* end = p + s.size();
+        while (p != end) {
+            const char* special = json_detail::find_string_special(p, end);
+            out.append(p, special);
+            if (special == end)
+                break;
+            switch (*special) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\b':
+                out += "\\b";
+                break;
+            case '\f':
+                out += "\\f";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default: {
+                static constexpr char kHex[] = "0123456789abcdef";
+                const auto            c      = static_cast<unsigned char>(*special);
+                out += "\\u00";
+                out += kHex[c >> 4];
+                out += kHex[c & 15];
+            }
+            }
+            p = special + 1;
+        }
+        out += '"';
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Objects
+// ---------------------------------------------------------------------------
+struct json::member {
+    std::string_view key;
+    json             value;
+};
+
+// Keys are kept apart from values so that the objects of an array of like
+// records, such as getpeerinfo's peers, can all point to one key table.
+struct json::object_block {
+    const std::string_view* keys; // sorted
+
+    [[nodiscard]] json*       values() { return reinterpret_cast<json*>(this + 1); }
+    [[nodiscard]] const json* values() const { return reinterpret_cast<const json*>(this + 1); }
 };
+
+// The members of an object as (key, value) pairs, in key order; empty for
+// anything else. Keys are views of the object's own, valid as long as it is.
+class json::items_view {
+  public:
+    using value_type = std::pair<std::string_view, const json&>;
+
+    class iterator {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = items_view::value_type;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = value_type;
+        using pointer           = void;
+
+        iterator() = default;
+
+        value_type operator*() const {
+            return heap_ ? value_type(it_->first, it_->second) : value_type(*k_, *v_);
+        }
+        iterator& operator++() {
+            if (heap_) {
+                ++it_;
+            } else {
+                ++k_;
+                ++v_;
+            }
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator prev = *this;
+            ++*this;
+            return prev;
+        }
+        bool operator==(const iterator& o) const { return heap_ ? it_ == o.it_ : k_ == o.k_; }
+
+      private:
+        friend class items_view;
+
+        object_t::const_iterator it_{}; // heap object
+        const std::string_view*  k_    = nullptr;
+        const json*              v_    = nullptr;
+        bool                     heap_ = false;
+    };
+
+    [[nodiscard]] iterator begin() const { return at(true); }
+    [[nodiscard]] iterator end() const { return at(false); }
+    [[nodiscard]] size_t   size() const { return heap_ ? heap_->size() : len_; }
+    [[nodiscard]] bool     empty() const { return size() == 0; }
+
+  private:
+    friend class json;
+
+    const object_t*     heap_   = nullptr;
+    const object_block* object_ = nullptr;
+    size_t              len_    = 0;
+
+    [[nodiscard]] iterator at(bool first) const {
+        iterator i;
+        i.heap_ = heap_ != nullptr;
+        if (heap_) {
+            i.it_ = first ? heap_->begin() : heap_->end();
+        } else if (object_) {
+            const size_t n = first ? 0 : len_;
+            i.k_           = object_->keys + n;
+            i.v_           = object_->values() + n;
+        }
+        return i;
+    }
+};
+
+inline json::items_view json::items() const {
+    const json& t = target();
+    items_view  v;
+    if (t.kind_ == Kind::Object) {
+        if (t.arena_) {
+            v.object_ = t.object_;
+            v.len_    = t.len_;
+        } else {
+            v.heap_ = t.oval_;
+        }
+    }
+    return v;
+}
+
+inline const json* json::find(std::string_view key) const noexcept {
+    if (kind_ != Kind::Object)
+        return nullptr;
+    if (!arena_) {
+        auto it = oval_->find(key);
+        return it != oval_->end() ? &it->second : nullptr;
+    }
+    const std::string_view* keys = object_->keys;
+    const std::string_view* end  = keys + len_;
+    const std::string_view* k    = std::lower_bound(keys, end, key);
+    return k != end && *k == key ? &object_->values()[k - keys] : nullptr;
+}
+
+inline int64_t json::get_sats() const {
+    constexpr int64_t kCoin    = 100'000'000;
+    constexpr int64_t kMaxCoin = int64_t{1} << 25;
+    const json&       t        = target();
+    if (t.kind_ == Kind::Int) {
+        if (t.ival_ >= kMaxCoin || t.ival_ <= -kMaxCoin)
+            throw exception("get_sats: amount out of range");
+        return t.ival_ * kCoin;
+    }
+    if (t.kind_ != Kind::Float)
+        throw exception("get_sats on non-number");
+    if (!(std::fabs(t.fval_) < static_cast<double>(kMaxCoin))) // NaN too
+        throw exception("get_sats: amount out of range");
+    // The whole coins and the fraction split exactly. The fraction is within
+    // 2^-29 of the decimal's, so scaled to satoshis it is within 0.2 of it and
+    // rounds back to it.
+    const double whole = std::trunc(t.fval_);
+    return static_cast<int64_t>(whole) * kCoin + std::llround((t.fval_ - whole) * kCoin);
+}
+
+inline json::object_t* json::copy_members(const json& o) {
+    auto* out = new object_t;
+    out->reserve(o.len_);
+    for (const auto& [k, v] : o.items())
+        out->append(std::string(k), v); // already in order
+    return out;
+}
+
+inline void json::write_object(std::string& out, int indent, int depth) const {
+    const auto members = items();
+    if (members.empty()) {
+        out += "{}";
+        return;
+    }
+    out += '{';
+    bool first = true;
+    for (const auto& [k, v] : members) {
+        if (!first)
+            out += ',';
+        if (indent >= 0)
+            write_newline(out, indent, depth + 1);
+        dump_string(out, k);
+        out += indent >= 0 ? ": " : ":";
+        v.write(out, indent, depth + 1);
+        first = false;
+    }
+    if (indent >= 0)
+        write_newline(out, indent, depth);
+    out += '}';
+}
+
+// ---------------------------------------------------------------------------
+// SAX-style events
+// ---------------------------------------------------------------------------
+// Receives a JSON text as a sequence of events, in document order, so a caller
+// can build its own structures without allocating json nodes. Every member of
+// an object is a key() followed by its value. The string_view payloads are
+// unescaped and only valid for the duration of the call. Unhandled events are
+// ignored; an exception thrown from a handler aborts the parse.
+class json::sax_handler {
+  public:
+    virtual ~sax_handler() = default;
+
+    virtual void null() {}
+    virtual void boolean(bool) {}
+    virtual void number_integer(int64_t) {}
+    virtual void number_float(double) {}
+    virtual void string(std::string_view) {}
+    virtual void key(std::string_view) {}
+    virtual void start_object() {}
+    virtual void end_object() {}
+    virtual void start_array() {}
+    virtual void end_array() {}
+};
+
+// Validates a JSON text that arrives in pieces, e.g. straight off a socket, and
+// reports it to a sax_handler: feed() each piece as it comes, then finish().
+// Tokens are parsed in place in the piece that holds them; only a token cut in
+// two by a piece boundary is copied, so memory is the nesting depth plus one
+// token, never the text. Malformed input throws json::exception.
+class json::sax_parser {
+  public:
+    explicit sax_parser(sax_handler& handler) : handler_(handler) {}
+
+    void feed(std::string_view piece) {
+        if (!partial_.empty())
+            piece.remove_prefix(complete_partial(piece));
+        scan(piece);
+    }
+
+    // End of input; throws json::exception if the text is incomplete.
+    void finish() {
+        if (!partial_.empty()) {
+            if (partial_.front() == '"')
+                throw exception("Unterminated string");
+            const std::string token = std::move(partial_);
+            partial_.clear();
+            scalar(token);
+        }
+        if (!done())
+            throw exception("Unexpected end of input");
+    }
+
+    // The root value is complete (a number at the very end needs finish()).
+    [[nodiscard]] bool done() const { return expect_ == Expect::End; }
+
+    // Containers open around the current event.
+    [[nodiscard]] size_t depth() const { return stack_.size(); }
+
+  private:
+    enum class Expect { Value, ValueOrEnd, Key, KeyOrEnd, Colon, CommaOrEnd, End };
+
+    sax_handler&      handler_;
+    std::vector<bool> stack_; // open containers, true for objects
+    Expect            expect_ = Expect::Value;
+    std::string       partial_;         // token cut short by the end of the last piece
+    bool              escaped_ = false; // partial_ ends in the backslash of an escape
+    std::string       unescaped_;       // payload of the last string with escapes
+
+    // Where a number or literal ends.
+    static bool ends_token(char c) {
+        return json_detail::is_ws(c) || c == ',' || c == ':' || c == ']' || c == '}' ||
+               c == '[' || c == '{' || c == '"';
+    }
+
+    // Index of the quote closing a string whose contents start at s[from], or
+    // npos. escaped_ carries a backslash at the end of `s` over to the next piece.
+    size_t string_end(std::string_view s, size_t from) {
+        size_t i = from;
+        if (escaped_ && i < s.size()) {
+            escaped_ = false;
+            ++i;
+        }
+        const char* begin = s.data();
+        const char* end   = begin + s.size();
+        while (i < s.size()) {
+            i = static_cast<size_t>(json_detail::find_string_special(begin + i, end) - begin);
+            if (i == s.size())
+                break;
+            if (s[i] == '"')
+                return i;
+            if (s[i] != '\\') { // a control byte, taken as it is
+                ++i;
+                continue;
+            }
+            if (i + 1 == s.size()) {
+                escaped_ = true;
+                break;
+            }
+            i += 2;
+        }
+        return std::string_view::npos;
+    }
+
+    // Completes the token in partial_ from the start of `piece`; returns the
+    // bytes of `piece` used.
+    size_t complete_partial(std::string_view piece) {
+        size_t end = 0;
+        if (partial_.front() == '"') {
+            end = string_end(piece, 0);
+            if (end == std::string_view::npos) {
+                partial_.append(piece);
+                return piece.size();
+            }
+            ++end; // the closing quote
+        } else {
+            while (end < piece.size() && !ends_token(piece[end]))
+                ++end;
+            if (end == piece.size()) {
+                partial_.append(piece);
+                return piece.size();
+            }
+        }
+        partial_.append(piece.substr(0, end));
+        const std::string token = std::move(partial_);
+        partial_.clear();
+        if (token.front() == '"')
+            string_token(token);
+        else
+            scalar(token);
+        return end;
+    }
+
+    void scan(std::string_view s) {
+        size_t i = 0;
+        while (i < s.size()) {
+            const char c = s[i];
+            if (json_detail::is_ws(c)) {
+                i = static_cast<size_t>(json_detail::skip_ws(s.data() + i, s.data() + s.size()) -
+                                        s.data());
+                continue;
+            }
+            if (expect_ == Expect::End)
+                throw exception("Trailing content after JSON value");
+            switch (c) {
+            case '"': {
+                const size_t end = string_end(s, i + 1);
+                if (end == std::string_view::npos) {
+                    partial_.assign(s.substr(i));
+                    return;
+                }
+                string_token(s.substr(i, end + 1 - i));
+                i = end + 1;
+                break;
+            }
+            case '{':
+            case '[':
+                open(c == '{');
+                ++i;
+                break;
+            case '}':
+            case ']':
+                close(c == '}');
+                ++i;
+                break;
+            case ':':
+                if (expect_ != Expect::Colon)
+                    throw exception("Unexpected ':'");
+                expect_ = Expect::Value;
+                ++i;
+                break;
+            case ',':
+                if (expect_ != Expect::CommaOrEnd)
+                    throw exception("Unexpected ','");
+                expect_ = stack_.back() ? Expect::Key : Expect::Value;
+                ++i;
+                break;
+            default: {
+                size_t end = i + 1;
+                while (end < s.size() && !ends_token(s[end]))
+                    ++end;
+                if (end == s.size()) {
+                    partial_.assign(s.substr(i));
+                    return;
+                }
+                scalar(s.substr(i, end - i));
+                i = end;
+                break;
+            }
+            }
+        }
+    }
+
+    // The contents of a string token (quotes included), unescaped: a view of
+    // the token itself unless it has escapes.
+    std::string_view unescape(std::string_view token) {
+        const std::string_view contents = token.substr(1, token.size() - 2);
+        if (contents.find('\\') == std::string_view::npos)
+            return contents;
+        Parser p{token};
+        unescaped_ = p.parse_string_val();
+        return unescaped_;
+    }
+
+    void string_token(std::string_view token) {
+        if (expect_ == Expect::Key || expect_ == Expect::KeyOrEnd) {
+            handler_.key(unescape(token));
+            expect_ = Expect::Colon;
+            return;
+        }
+        expect_value();
+        handler_.string(unescape(token));
+        value_done();
+    }
+
+    // A number, true, false or null.
+    void scalar(std::string_view token) {
+        expect_value();
+        if (token == "true" || token == "false") {
+            handler_.boolean(token == "true");
+        } else if (token == "null") {
+            handler_.null();
+        } else {
+            Parser p{token};
+            json   v = p.parse_value();
+            if (p.pos != token.size() || !v.is_number())
+                throw exception("Invalid literal: " + std::string(token.substr(0, 32)));
+            if (v.is_number_integer())
+                handler_.number_integer(v.ival_);
+            else
+                handler_.number_float(v.fval_);
+        }
+        value_done();
+    }
+
+    void expect_value() const {
+        if (expect_ != Expect::Value && expect_ != Expect::ValueOrEnd)
+            throw exception(expect_ == Expect::Colon ? "Expected ':'" : "Unexpected value");
+    }
+
+    void value_done() { expect_ = stack_.empty() ? Expect::End : Expect::CommaOrEnd; }
+
+    void open(bool object) {
+        expect_value();
+        stack_.push_back(object);
+        expect_ = object ? Expect::KeyOrEnd : Expect::ValueOrEnd;
+        if (object)
+            handler_.start_object();
+        else
+            handler_.start_array();
+    }
+
+    void close(bool object) {
+        const char c = object ? '}' : ']';
+        if (stack_.empty() || stack_.back() != object ||
+            (expect_ != Expect::CommaOrEnd &&
+             expect_ != (object ? Expect::KeyOrEnd : Expect::ValueOrEnd)))
+            throw exception(std::string("Unexpected '") + c + "'");
+        stack_.pop_back();
+        if (object)
+            handler_.end_object();
+        else
+            handler_.end_array();
+        value_done();
+    }
+};
+
+inline void json::sax_parse(std::string_view s, sax_handler& handler) {
+    sax_parser p(handler);
+    p.feed(s);
+    p.finish();
+}
+
+// ---------------------------------------------------------------------------
+// Documents
+// ---------------------------------------------------------------------------
+// Everything parse_document() builds: the text, kept when strings can point
+// into it, and an arena holding every node, string copy and member table.
+// Nothing in it is freed before the whole document is.
+struct json::document {
+    explicit document(size_t arena_hint) : arena(std::max<size_t>(arena_hint, 1024)) {}
+
+    std::string                         text;
+    std::pmr::monotonic_buffer_resource arena;
+    json                                root;
+};
+
+// sax_handler building a document. Values wait in `scratch` until their
+// container closes, then move into an array of exactly their number, objects'
+// sorted by key; scratch is reused, so the heap sees a handful of allocations
+// per document rather than one per node.
+//
+// Objects share key tables by shape: the keys of an object, in the order of
+// the text. An object whose keys come in the same order as a recent one's
+// takes that one's sorted keys and skips sorting its own, so the peers of
+// getpeerinfo or the entries of getrawmempool true hold only their values.
+struct json::document_builder final : sax_handler {
+    explicit document_builder(document& d) : doc(d) {}
+
+    struct Frame {
+        size_t           start; // of its values in scratch
+        bool             object;
+        std::string_view key; // its own, in the container around it
+    };
+
+    struct Shape {
+        uint32_t                size;   // members in the text, duplicate keys included
+        uint32_t                unique; // keys
+        const std::string_view* keys;   // sorted
+        const uint32_t*         rank;   // for each member in the text, its key in `keys`
+    };
+
+    // Recent shapes, by a hash of their size and first and last keys.
+    static constexpr size_t kShapeSlots = 64;
+
+    document&                             doc;
+    std::vector<member>                   scratch;
+    std::vector<Frame>                    stack;
+    std::vector<uint32_t>                 order; // sorting scratch space for objects
+    std::string_view                      pending_key;
+    std::array<const Shape*, kShapeSlots> shapes{};
+
+    void null() override { add(json()); }
+    void boolean(bool v) override { add(json(v)); }
+    void number_integer(int64_t v) override { add(json(v)); }
+    void number_float(double v) override { add(json(v)); }
+    void string(std::string_view v) override {
+        const std::string_view s = keep(v);
+        json                   j;
+        j.kind_  = Kind::String;
+        j.arena_ = true;
+        j.len_   = static_cast<uint32_t>(s.size());
+        j.str_   = s.data();
+        add(std::move(j));
+    }
+    void key(std::string_view k) override { pending_key = keep(k); }
+    void start_object() override { open(true); }
+    void start_array() override { open(false); }
+    void end_object() override { close(); }
+    void end_array() override { close(); }
+
+    // `s` itself if it lies in the document's text, else a copy in the arena.
+    std::string_view keep(std::string_view s) {
+        if (s.size() > UINT32_MAX)
+            throw exception("String too long");
+        const char* text = doc.text.data();
+        if (s.data() >= text && s.data() + s.size() <= text + doc.text.size())
+            return s;
+        if (s.empty())
+            return {};
+        auto* p = static_cast<char*>(doc.arena.allocate(s.size(), 1));
+        std::memcpy(p, s.data(), s.size());
+        return {p, s.size()};
+    }
+
+    template <typename T> T* allocate(size_t n) {
+        return static_cast<T*>(doc.arena.allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void add(json v) {
+        if (stack.empty()) {
+            doc.root.take(v);
+            return;
+        }
+        scratch.push_back({pending_key, std::move(v)});
+        pending_key = {};
+    }
+
+    void open(bool object) {
+        stack.push_back({scratch.size(), object, pending_key});
+        pending_key = {};
+    }
+
+    void close() {
+        const Frame  f = stack.back();
+        const size_t n = scratch.size() - f.start;
+        stack.pop_back();
+        if (n > UINT32_MAX)
+            throw exception("Container too large");
+        json j;
+        j.arena_ = true;
+        if (!f.object) {
+            json* items = allocate<json>(n);
+            for (size_t i = 0; i < n; ++i)
+                new (items + i) json(std::move(scratch[f.start + i].value));
+            j.kind_  = Kind::Array;
+            j.len_   = static_cast<uint32_t>(n);
+            j.items_ = items;
+        } else {
+            const Shape& shape = shape_of(scratch.data() + f.start, n);
+            auto*        block = static_cast<object_block*>(doc.arena.allocate(
+                sizeof(object_block) + shape.unique * sizeof(json), alignof(json)));
+            block->keys  = shape.keys;
+            json* values = block->values();
+            for (uint32_t i = 0; i < shape.unique; ++i)
+                new (values + i) json();
+            // Of duplicate keys the last one wins, as it does in parse().
+            for (size_t i = 0; i < n; ++i)
+                values[shape.rank[i]].take(scratch[f.start + i].value);
+            j.kind_   = Kind::Object;
+            j.len_    = shape.unique;
+            j.object_ = block;
+        }
+        scratch.resize(f.start);
+        pending_key = f.key;
+        add(std::move(j));
+    }
+
+    // The shape of the n members at m: a recent one if its keys match, else a
+    // new one.
+    const Shape& shape_of(const member* m, size_t n) {
+        uint64_t h = n;
+        if (n > 0) {
+            for (const char c : m[0].key)
+                h = (h ^ static_cast<unsigned char>(c)) * 0x100000001b3;
+            for (const char c : m[n - 1].key)
+                h = (h ^ static_cast<unsigned char>(c)) * 0x100000001b3;
+        }
+        const Shape*& slot = shapes[(h ^ (h >> 32)) % kShapeSlots];
+        if (slot && slot->size == n) {
+            size_t i = 0;
+            while (i < n && m[i].key == slot->keys[slot->rank[i]])
+                ++i;
+            if (i == n)
+                return *slot;
+        }
+
+        // Sorted by key, equal keys in the order of the text.
+        order.resize(n);
+        for (uint32_t i = 0; i < n; ++i)
+            order[i] = i;
+        std::sort(order.begin(), order.end(), [m](uint32_t a, uint32_t b) {
+            const int c = m[a].key.compare(m[b].key);
+            return c < 0 || (c == 0 && a < b);
+        });
+        size_t unique = n;
+        for (size_t i = 1; i < n; ++i)
+            unique -= m[order[i - 1]].key == m[order[i]].key;
+        auto*  keys = allocate<std::string_view>(unique);
+        auto*  rank = allocate<uint32_t>(n);
+        size_t out  = 0;
+        for (size_t i = 0; i < n; ++i) {
+            rank[order[i]] = static_cast<uint32_t>(out);
+            if (i + 1 < n && m[order[i]].key == m[order[i + 1]].key)
+                continue;
+            new (keys + out++) std::string_view(m[order[i]].key);
+        }
+        auto* shape = allocate<Shape>(1);
+        new (shape) Shape{static_cast<uint32_t>(n), static_cast<uint32_t>(unique), keys, rank};
+        slot = shape;
+        return *shape;
+    }
+};
+
+inline json json::parse_document(std::string s) {
+    auto doc  = std::make_shared<document>(s.size());
+    doc->text = std::move(s);
+    document_builder builder(*doc);
+    sax_parser       parser(builder);
+    parser.feed(doc->text);
+    parser.finish();
+    json handle;
+    handle.kind_ = Kind::Shared;
+    handle.ref_  = new Ref{doc, &doc->root};
+    return handle;
+}
+
+inline json json::share(const json& part) const {
+    if (kind_ != Kind::Shared)
+        return part;
+    json handle;
+    handle.kind_ = Kind::Shared;
+    handle.ref_  = new Ref{ref_->doc, &part.target()};
+    return handle;
+}
+
+// ---------------------------------------------------------------------------
+// Incremental (push) parser
+// ---------------------------------------------------------------------------
+// Builds a document from a JSON text that arrives in pieces: a sax_parser whose
+// events assemble json values. Memory is the document being built plus one
+// token, never the text. The result is a document as parse_document() makes
+// them, except that strings are copied into its arena, the text being gone.
+//
+// stream() hands the elements of one container to a callback as each one
+// completes instead of adding them to the document, so a consumer can work
+// through a huge result while it is still downloading without ever holding
+// all of it. The elements and the rest of the document are then ordinary
+// heap values.
+class json::incremental_parser {
+  public:
+    // Array elements come with an empty key.
+    using element_handler = std::function<void(std::string_view key, json&& value)>;
+
+    incremental_parser() = default;
+    incremental_parser(const incremental_parser&)            = delete;
+    incremental_parser& operator=(const incremental_parser&) = delete;
+
+    // Stream the elements of the root object's member `key`, or of the root
+    // itself if `key` is empty. The container stays in the document, empty.
+    // Call before the first feed().
+    void stream(std::string key, element_handler fn) {
+        builder_.stream_key = std::move(key);
+        builder_.handler    = std::move(fn);
+    }
+
+    void feed(std::string_view piece) { parser().feed(piece); }
+
+    // End of input: the document, or json::exception if it is incomplete.
+    [[nodiscard]] json finish() {
+        parser().finish();
+        if (!doc_)
+            return std::move(builder_.root);
+        json handle;
+        handle.kind_ = Kind::Shared;
+        handle.ref_  = new Ref{doc_, &doc_->root};
+        return handle;
+    }
+
+    [[nodiscard]] bool done() const { return parser_ && parser_->done(); }
+
+  private:
+    struct Builder : sax_handler {
+        struct Frame {
+            json        value;            // the container being filled
+            std::string key;              // member awaiting its value (objects)
+            bool        streamed = false; // elements go to `handler`
+        };
+
+        std::vector<Frame> stack;
+        json               root;
+        std::string        stream_key;
+        element_handler    handler;
+
+        void null() override { add(json()); }
+        void boolean(bool v) override { add(json(v)); }
+        void number_integer(int64_t v) override { add(json(v)); }
+        void number_float(double v) override { add(json(v)); }
+        void string(std::string_view v) override { add(json(std::string(v))); }
+        void key(std::string_view k) override { stack.back().key.assign(k); }
+        void start_object() override { open(json::object()); }
+        void start_array() override { open(json::array()); }
+        void end_object() override { close(); }
+        void end_array() override { close(); }
+
+        void open(json container) {
+            Frame f;
+            f.streamed = handler && (stream_key.empty()
+                                         ? stack.empty()
+                                         : stack.size() == 1 && stack[0].value.is_object() &&
+                                               stack[0].key == stream_key);
+            f.value    = std::move(container);
+            stack.push_back(std::move(f));
+        }
+
+        void close() {
+            json v = std::move(stack.back().value);
+            stack.pop_back();
+            if (v.is_object())
+                v.oval_->sort();
+            add(std::move(v));
+        }
+
+        // A complete value: into its container, to the handler, or as the root.
+        void add(json v) {
+            if (stack.empty()) {
+                root = std::move(v);
+                return;
+            }
+            Frame& f = stack.back();
+            if (f.streamed)
+                handler(f.key, std::move(v));
+            else if (f.value.is_object())
+                f.value.oval_->append(std::move(f.key), std::move(v));
+            else
+                f.value.aval_->push_back(std::move(v));
+            f.key.clear();
+        }
+    };
+
+    Builder                         builder_;
+    std::shared_ptr<document>       doc_;
+    std::optional<document_builder> doc_builder_;
+    std::optional<sax_parser>       parser_; // set up by the first feed()
+
+    sax_parser& parser() {
+        if (!parser_) {
+            if (builder_.handler) {
+                parser_.emplace(builder_);
+            } else {
+                doc_ = std::make_shared<document>(0);
+                doc_builder_.emplace(*doc_);
+                parser_.emplace(*doc_builder_);
+            }
+        }
+        return *parser_;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// On-demand reading
+// ---------------------------------------------------------------------------
+// A read-only view of a JSON value inside a text, parsed only as far as it is
+// read: a lookup skips the members and elements before the one it wants
+// without building them, and a scalar is converted when asked for. Only what
+// a read passes over is checked, so a malformed text throws json::exception
+// when (and if) a read reaches the damage. For replies of which a few fields
+// are wanted, e.g. the 18 of getpeerinfo's 40-odd per peer or the first of
+// getblock's 3000 txids.
+//
+// Like a std::string_view, a cursor does not own the text, which must outlive
+// it. Members read in the order the text has them are found in one pass:
+// each lookup starts after the member the previous one found, wrapping around.
+//
+// A missing value (a member that is not there) reads as null, as it does
+// through json's const operator[].
+class json::cursor {
+  public:
+    class iterator;
+
+    cursor() = default;
+    explicit cursor(std::string_view text)
+        : cursor(json_detail::skip_ws(text.data(), text.data() + text.size()),
+                 text.data() + text.size()) {
+        if (p_ == end_)
+            throw exception("Unexpected end of input");
+    }
+
+    [[nodiscard]] bool is_null() const noexcept { return !p_ || *p_ == 'n'; }
+    [[nodiscard]] bool is_bool() const noexcept { return p_ && (*p_ == 't' || *p_ == 'f'); }
+    [[nodiscard]] bool is_number() const noexcept {
+        return p_ && (*p_ == '-' || (*p_ >= '0' && *p_ <= '9'));
+    }
+    [[nodiscard]] bool is_string() const noexcept { return p_ && *p_ == '"'; }
+    [[nodiscard]] bool is_array() const noexcept { return p_ && *p_ == '['; }
+    [[nodiscard]] bool is_object() const noexcept { return p_ && *p_ == '{'; }
+
+    // The member `key`, or a missing value if there is none or this is not an
+    // object.
+    [[nodiscard]] cursor operator[](std::string_view key) const {
+        const char* v = find(key);
+        return v ? cursor(v, end_) : cursor();
+    }
+
+    [[nodiscard]] cursor operator[](size_t i) const;
+
+    [[nodiscard]] bool contains(std::string_view key) const { return find(key) != nullptr; }
+
+    // Elements of an array, or members of an object; 0 for anything else.
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] bool   empty() const;
+
+    // As json::get<T>() (and json::get_sats()) on the value, which is parsed
+    // on the spot: only scalars are worth reading this way.
+    template <typename T> [[nodiscard]] T get() const {
+        static_assert(!std::same_as<T, std::string_view>, "would view a temporary");
+        return to_json().get<T>();
+    }
+    [[nodiscard]] int64_t get_sats() const { return to_json().get_sats(); }
+
+    // As json::value().
+    template <typename T> [[nodiscard]] T value(std::string_view key, const T& def) const {
+        const cursor v = (*this)[key];
+        if (v.is_null())
+            return def;
+        try {
+            return v.get<T>();
+        } catch (const exception&) {
+            return def;
+        }
+    }
+    [[nodiscard]] std::string value(std::string_view key, const char* def) const {
+        const cursor v = (*this)[key];
+        if (!v.is_string())
+            return def ? def : "";
+        return v.get<std::string>();
+    }
+
+    // The value as a json, validated in full; null for a missing value.
+    [[nodiscard]] json to_json() const {
+        if (!p_)
+            return json();
+        Parser p{raw()};
+        return p.parse_value();
+    }
+
+    // Calls f(key, value) for each member of an object, in the order of the
+    // text; nothing for anything else. Values f does not read are only skipped.
+    template <typename F> void for_each_member(F&& f) const {
+        if (!is_object())
+            return;
+        std::string unescaped;
+        for (const char* m = first_member(); m;) {
+            const char* key_end = skip_string(m + 1);
+            const char* v       = nullptr;
+            const char* next    = next_member(key_end, &v);
+            f(key_of(m, key_end, unescaped), cursor(v, end_));
+            m = next;
+        }
+    }
+
+    // The text of the value; empty for a missing value.
+    [[nodiscard]] std::string_view raw() const {
+        if (!p_)
+            return {};
+        return {p_, static_cast<size_t>(skip_value(p_) - p_)};
+    }
+
+    // The elements of an array; nothing for anything else.
+    [[nodiscard]] iterator begin() const;
+    [[nodiscard]] iterator end() const;
+
+  private:
+    const char*         p_      = nullptr; // first byte of the value; null if missing
+    const char*         end_    = nullptr; // end of the whole text
+    mutable const char* resume_ = nullptr; // objects: where the next lookup starts
+
+    cursor(const char* p, const char* end) : p_(p), end_(end) {}
+
+    [[nodiscard]] const char* ws(const char* p) const { return json_detail::skip_ws(p, end_); }
+
+    [[nodiscard]] const char* expect(const char* p, char c) const {
+        p = ws(p);
+        if (p == end_ || *p != c)
+            throw exception(p == end_ ? std::string("Unexpected end of input")
+                                      : std::string("Expected '") + c + "', got '" + *p + "'");
+        return p + 1;
+    }
+
+    // Past the closing quote of the string whose contents start at `p`.
+    [[nodiscard]] const char* skip_string(const char* p) const {
+        for (;;) {
+            p = json_detail::find_string_special(p, end_);
+            if (p == end_)
+                throw exception("Unterminated string");
+            if (*p == '"')
+                return p + 1;
+            p += *p == '\\' ? 2 : 1; // an escape, or a control byte taken as it is
+        }
+    }
+
+    // Past the value starting at `p`, which is checked no further than it
+    // takes to find its end.
+    [[nodiscard]] const char* skip_value(const char* p) const {
+        if (*p == '"')
+            return skip_string(p + 1);
+        if (*p != '{' && *p != '[') {
+            while (p < end_ && !json_detail::is_ws(*p) && *p != ',' && *p != ']' && *p != '}' &&
+                   *p != ':')
+                ++p;
+            return p;
+        }
+        if (const char* after = json_detail::skip_container(p, end_))
+            return after;
+        throw exception("Unexpected end of input");
+    }
+
+    // Members are walked by the position of their key's opening quote; null
+    // past the last one.
+    [[nodiscard]] const char* first_member() const {
+        const char* p = ws(p_ + 1);
+        if (p != end_ && *p == '}')
+            return nullptr;
+        if (p == end_ || *p != '"')
+            throw exception("Expected a member name");
+        return p;
+    }
+
+    // The member after the one whose key ends at `key_end` (past the closing
+    // quote); sets `*value` to where that member's value starts.
+    [[nodiscard]] const char* next_member(const char* key_end, const char** value) const {
+        const char* v = ws(expect(key_end, ':'));
+        if (v == end_)
+            throw exception("Unexpected end of input");
+        if (value)
+            *value = v;
+        const char* p = ws(skip_value(v));
+        if (p != end_ && *p == '}')
+            return nullptr;
+        p = ws(expect(p, ','));
+        if (p == end_ || *p != '"')
+            throw exception("Expected a member name");
+        return p;
+    }
+
+    // The key from the opening quote at `m` to `key_end`: in place, or
+    // unescaped into `unescaped` if it has escapes.
+    [[nodiscard]] static std::string_view key_of(const char* m, const char* key_end,
+                                                 std::string& unescaped) {
+        const std::string_view raw(m + 1, static_cast<size_t>(key_end - m - 2));
+        if (raw.find('\\') == std::string_view::npos)
+            return raw;
+        Parser p{std::string_view(m, static_cast<size_t>(key_end - m))};
+        unescaped = p.parse_string_val();
+        return unescaped;
+    }
+
+    [[nodiscard]] static bool key_is(const char* m, const char* key_end, std::string_view key) {
+        std::string unescaped;
+        return key_of(m, key_end, unescaped) == key;
+    }
+
+    // Where the value of member `key` starts, or null.
+    [[nodiscard]] const char* find(std::string_view key) const {
+        if (!is_object())
+            return nullptr;
+        const char* first = first_member();
+        const char* start = resume_ ? resume_ : first;
+        // From where the last lookup ended to the end, then from the start.
+        for (const char* stop : {static_cast<const char*>(nullptr), start}) {
+            for (const char* m = stop ? first : start; m != stop;) {
+                const char* key_end = skip_string(m + 1);
+                const char* v       = nullptr;
+                const char* next    = next_member(key_end, &v);
+                if (key_is(m, key_end, key)) {
+                    resume_ = next ? next : first;
+                    return v;
+                }
+                m = next;
+            }
+        }
+        return nullptr;
+    }
+};
+
+// A forward iterator over the elements of an array.
+class json::cursor::iterator {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = cursor;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = void;
+    using reference         = cursor;
+
+    iterator() = default;
+
+    cursor operator*() const { return cursor(p_, array_.end_); }
+    iterator& operator++() {
+        const char* p = array_.ws(array_.skip_value(p_));
+        if (p != array_.end_ && *p == ']') {
+            p_ = nullptr;
+            return *this;
+        }
+        p_ = array_.ws(array_.expect(p, ','));
+        if (p_ == array_.end_)
+            throw exception("Unexpected end of input");
+        return *this;
+    }
+    iterator operator++(int) {
+        iterator old = *this;
+        ++*this;
+        return old;
+    }
+    bool operator==(const iterator& o) const { return p_ == o.p_; }
+
+  private:
+    friend class cursor;
+    cursor      array_;
+    const char* p_ = nullptr; // the current element; null past the last one
+
+    iterator(const cursor& array, const char* p) : array_(array.p_, array.end_), p_(p) {}
+};
+
+inline json::cursor::iterator json::cursor::begin() const {
+    if (!is_array())
+        return {};
+    const char* p = ws(p_ + 1);
+    if (p == end_)
+        throw exception("Unexpected end of input");
+    return {*this, *p == ']' ? nullptr : p};
+}
+
+inline json::cursor::iterator json::cursor::end() const { return {}; }
+
+inline json::cursor json::cursor::operator[](size_t i) const {
+    if (!is_array())
+        throw exception("operator[size_t] on non-array");
+    for (auto it = begin(); it != end(); ++it, --i) {
+        if (i == 0)
+            return *it;
+    }
+    throw exception("operator[size_t] out of range");
+}
+
+inline size_t json::cursor::size() const {
+    size_t n = 0;
+    if (is_array()) {
+        for (auto it = begin(); it != end(); ++it)
+            ++n;
+    } else if (is_object()) {
+        for (const char* m = first_member(); m; m = next_member(skip_string(m + 1), nullptr))
+            ++n;
+    }
+    return n;
+}
+
+inline bool json::cursor::empty() const {
+    if (is_array())
+        return begin() == end();
+    return !is_object() || !first_member();
+}
+
+// ---------------------------------------------------------------------------
+// Typed binding
+// ---------------------------------------------------------------------------
+// A struct is read straight out of a JSON object by specialising json_binding
+// with the members it takes:
+//
+//   template <> struct json_binding<BlockStat> {
+//       static constexpr std::array fields = {
+//           json_member<&BlockStat::height>("height"),
+//           json_member<&BlockStat::hash>("blockhash"),
+//       };
+//   };
+//
+// json_bind() then walks the object's members once, looking each name up in a
+// perfect hash built at compile time: a member the struct does not take costs
+// one hash, and a value is only converted for the members it does.
+template <typename T> struct json_field {
+    std::string_view key;
+    void (*read)(T&, const json&); // the member's value, never a missing one
+};
+
+template <typename T> struct json_binding;
+
+namespace json_detail {
+
+template <typename> struct member_of;
+template <typename T, typename M> struct member_of<M T::*> {
+    using type = T;
+};
+
+// As json::value(): a value of another type leaves `m` as it was.
+template <typename M> void read_member(M& m, const json& v) {
+    if constexpr (std::same_as<M, bool>) {
+        if (v.is_bool())
+            m = v.get<bool>();
+    } else if constexpr (std::same_as<M, std::string>) {
+        if (v.is_string())
+            m = v.get<std::string>();
+    } else {
+        if (v.is_number())
+            m = v.get<M>();
+    }
+}
+
+[[nodiscard]] constexpr uint32_t key_hash(std::string_view key, uint32_t seed) {
+    uint32_t h = 2166136261u ^ seed; // FNV-1a
+    for (const char c : key)
+        h = (h ^ static_cast<unsigned char>(c)) * 16777619u;
+    return h ^ (h >> 16);
+}
+
+template <typename T> class field_table {
+    static constexpr const auto& fields = json_binding<T>::fields;
+    static constexpr size_t      kSlots = std::bit_ceil(fields.size() * 4);
+    static_assert(fields.size() < 255, "json_binding: too many fields");
+
+    // The first seed that gives every field a slot of its own.
+    static constexpr uint32_t find_seed() {
+        for (size_t i = 0; i < fields.size(); ++i) {
+            for (size_t j = i + 1; j < fields.size(); ++j) {
+                if (fields[i].key == fields[j].key)
+                    return UINT32_MAX;
+            }
+        }
+        for (uint32_t seed = 0;; ++seed) {
+            std::array<bool, kSlots> used{};
+            bool                     ok = true;
+            for (const auto& f : fields) {
+                bool& slot = used[key_hash(f.key, seed) & (kSlots - 1)];
+                ok         = ok && !slot;
+                slot       = true;
+            }
+            if (ok)
+                return seed;
+        }
+    }
+
+    static constexpr uint32_t kSeed = find_seed();
+    static_assert(kSeed != UINT32_MAX, "json_binding: a field is named twice");
+
+    // 1 + the index of the field hashing to each slot; 0 for none.
+    static constexpr std::array<uint8_t, kSlots> kSlotField = [] {
+        std::array<uint8_t, kSlots> out{};
+        for (size_t i = 0; i < fields.size(); ++i)
+            out[key_hash(fields[i].key, kSeed) & (kSlots - 1)] = static_cast<uint8_t>(i + 1);
+        return out;
+    }();
+
+  public:
+    [[nodiscard]] static const json_field<T>* find(std::string_view key) {
+        const uint8_t i = kSlotField[key_hash(key, kSeed) & (kSlots - 1)];
+        return i != 0 && fields[i - 1].key == key ? &fields[i - 1] : nullptr;
+    }
+};
+
+} // namespace json_detail
+
+// A field read into `Member` as json::value() would read it.
+template <auto Member> constexpr auto json_member(std::string_view key) {
+    using T = typename json_detail::member_of<decltype(Member)>::type;
+    return json_field<T>{key, [](T& t, const json& v) { json_detail::read_member(t.*Member, v); }};
+}
+
+// Reads the members of `object` that T takes into `out`; other members, and
+// a value that is not an object, leave it as it was.
+template <typename T> void json_bind(const json& object, T& out) {
+    if (!object.is_object())
+        return;
+    for (const auto& [key, value] : object.items()) {
+        if (const auto* f = json_detail::field_table<T>::find(key))
+            f->read(out, value);
+    }
+}
+
+// The same from a text: only the values of members T takes are parsed.
+template <typename T> void json_bind(const json::cursor& object, T& out) {
+    object.for_each_member([&](std::string_view key, const json::cursor& value) {
+        if (const auto* f = json_detail::field_table<T>::find(key))
+            f->read(out, value.to_json());
+    });
+}
+
+// The elements of an array, each read into a default T; empty for a value
+// that is not an array.
+template <typename T, typename Value> std::vector<T> json_bind_array(const Value& array) {
+    std::vector<T> out;
+    if (!array.is_array())
+        return out;
+    for (const auto& element : array) {
+        T t;
+        json_bind(element, t);
+        out.push_back(std::move(t));
+    }
+    return out;
+}
@@ -0,0 +1,199 @@
+#include "lua_json.hpp"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "lua.h"
+}
+
+void push_json(lua_State* L, const json& j) {
+    if (j.is_bool())
+        lua_pushboolean(L, j.get<bool>());
+    else if (j.is_number_integer())
+        lua_pushinteger(L, static_cast<lua_Integer>(j.get<int64_t>()));
+    else if (j.is_number_float())
+        lua_pushnumber(L, j.get<double>());
+    else if (j.is_string()) {
+        const auto s = j.get<std::string_view>();
+        lua_pushlstring(L, s.data(), s.size());
+    } else if (j.is_array()) {
+        lua_createtable(L, static_cast<int>(j.size()), 0);
+        for (size_t i = 0; i < j.size(); ++i) {
+            push_json(L, j[i]);
+            lua_rawseti(L, -2, static_cast<lua_Integer>(i) + 1);
+        }
+    } else if (j.is_object()) {
+        lua_createtable(L, 0, static_cast<int>(j.size()));
+        for (const auto& [k, v] : j.items()) {
+            lua_pushlstring(L, k.data(), k.size());
+            push_json(L, v);
+            lua_rawset(L, -3);
+        }
+    } else {
+        lua_pushnil(L);
+    }
+}
+
+namespace {
+
+// sax_handler building the same Lua values as push_json straight from a JSON
+// text. Values wait on L's stack until their container closes, so a table is
+// created at its final size; past kMaxPending stack slots the table is created
+// at the size reached so far and the rest go in as they come, since a Lua
+// stack holds at most LUAI_MAXSTACK (a million) slots. Keys come from a small
+// cache of Lua strings, as RPC results repeat the same few keys in every
+// object.
+class LuaJsonBuilder final : public json::sax_handler {
+  public:
+    // Even, so that a flush never splits a key from its value.
+    static constexpr int kMaxPending = 4096;
+
+    explicit LuaJsonBuilder(lua_State* L) : L_(L) {
+        room(1);
+        lua_createtable(L_, kKeySlots, 0);
+        keys_ = lua_gettop(L_);
+    }
+
+    // Once the text is parsed: leaves its value on top of the stack.
+    void finish() {
+        lua_copy(L_, -1, keys_);
+        lua_settop(L_, keys_);
+    }
+
+    void null() override {
+        room(1);
+        lua_pushnil(L_);
+        added();
+    }
+    void boolean(bool v) override {
+        room(1);
+        lua_pushboolean(L_, v);
+        added();
+    }
+    void number_integer(int64_t v) override {
+        room(1);
+        lua_pushinteger(L_, static_cast<lua_Integer>(v));
+        added();
+    }
+    void number_float(double v) override {
+        room(1);
+        lua_pushnumber(L_, v);
+        added();
+    }
+    void string(std::string_view v) override {
+        room(1);
+        lua_pushlstring(L_, v.data(), v.size());
+        added();
+    }
+    void key(std::string_view k) override {
+        room(2);
+        const size_t slot   = slot_of(k);
+        std::string& cached = key_text_[slot];
+        if (!k.empty() && cached == k) {
+            lua_rawgeti(L_, keys_, static_cast<lua_Integer>(slot) + 1);
+            return;
+        }
+        lua_pushlstring(L_, k.data(), k.size());
+        lua_pushvalue(L_, -1);
+        lua_rawseti(L_, keys_, static_cast<lua_Integer>(slot) + 1);
+        cached.assign(k);
+    }
+    void start_object() override { open_.push_back({lua_gettop(L_), true}); }
+    void start_array() override { open_.push_back({lua_gettop(L_), false}); }
+    void end_object() override { close(); }
+    void end_array() override { close(); }
+
+  private:
+    static constexpr int kKeySlots = 128;
+
+    // A container being parsed. Its table, once created, sits at base + 1,
+    // with the values still pending above it.
+    struct Open {
+        int         base; // stack top below the container
+        bool        object;
+        bool        table = false;
+        lua_Integer count = 0; // array elements already in the table
+    };
+
+    lua_State*                         L_;
+    int                                keys_; // stack index of the table of cached keys
+    std::array<std::string, kKeySlots> key_text_;
+    std::vector<Open>                  open_;
+
+    // Reads four bytes of the key rather than all of them; enough to keep the
+    // few dozen keys of an RPC result apart.
+    static size_t slot_of(std::string_view k) {
+        if (k.empty())
+            return 0;
+        const auto at = [k](size_t i) { return static_cast<size_t>(static_cast<uint8_t>(k[i])); };
+        return (k.size() * 131 + at(0) * 31 + at(k.size() / 2) * 7 + at(k.size() - 1)) &
+               (kKeySlots - 1);
+    }
+
+    void room(int n) {
+        if (!lua_checkstack(L_, n))
+            throw json::exception("JSON value too deeply nested for the Lua stack");
+    }
+
+    // A value is complete on top of the stack.
+    void added() {
+        if (open_.empty())
+            return;
+        Open& f = open_.back();
+        if (lua_gettop(L_) - f.base - (f.table ? 1 : 0) >= kMaxPending)
+            flush(f);
+    }
+
+    void close() {
+        Open f = open_.back();
+        open_.pop_back();
+        flush(f);
+        added();
+    }
+
+    // Moves the values pending above `f`'s table into it, creating the table
+    // at their count if there is none yet. Members go in in text order, so of
+    // duplicate keys the last one wins, as in json::parse().
+    void flush(Open& f) {
+        const int below = f.base + (f.table ? 1 : 0);
+        const int n     = lua_gettop(L_) - below;
+        room(3);
+        if (f.table)
+            lua_pushvalue(L_, f.base + 1);
+        else if (f.object)
+            lua_createtable(L_, 0, n / 2);
+        else
+            lua_createtable(L_, n, 0);
+        if (f.object) {
+            for (int i = 0; i < n / 2; ++i) {
+                lua_pushvalue(L_, below + 2 * i + 1);
+                lua_pushvalue(L_, below + 2 * i + 2);
+                lua_rawset(L_, -3);
+            }
+        } else {
+            for (int i = 1; i <= n; ++i) {
+                lua_pushvalue(L_, below + i);
+                lua_rawseti(L_, -2, ++f.count);
+            }
+        }
+        lua_copy(L_, -1, f.base + 1);
+        lua_settop(L_, f.base + 1);
+        f.table = true;
+    }
+};
+
+} // namespace
+
+void push_json_result(lua_State* L, std::string_view reply) {
+    const std::string_view result = json::cursor(reply)["result"].raw();
+    if (result.empty()) {
+        lua_pushnil(L);
+        return;
+    }
+    LuaJsonBuilder builder(L);
+    json::sax_parse(result, builder);
+    builder.finish();
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+// JSON to Lua values, for RPC results handed to Lua tabs.
+
+#include <string_view>
+
+#include "json.hpp"
+
+struct lua_State;
+
+// Push a json value onto L's stack as the equivalent Lua value.
+void push_json(lua_State* L, const json& j);
+
+// Push the "result" of a JSON-RPC reply text onto L's stack as the equivalent
+// Lua value, parsed straight from the text with no json tree in between; nil
+// if there is none. Malformed text throws json::exception, leaving L's stack
+// as it is mid-value.
+void push_json_result(lua_State* L, std::string_view reply);
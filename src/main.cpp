@@ -30,7 +30,10 @@ static void ensure_terminal();
 #include "paths.hpp"
 #include "poll.hpp"
 #include "render.hpp"
+#include "rest_client.hpp"
 #include "rpc_client.hpp"
+#include "rpc_engine.hpp"
+#include "rpc_recording.hpp"
 #include "state.hpp"
 #include "tabs/dashboard.hpp"
 #include "tabs/luatab.hpp"
@@ -102,6 +105,72 @@ static void apply_cookie(RpcAuth& auth, const std::string& path) {
     auth.password = line.substr(colon + 1);
 }
 
+// ============================================================================
+// RPC diagnostics overlay
+// ============================================================================
+
+// Slowest (caller, method) rows first. The overlay shows the phases that matter
+// most; the file written with 'w' has all of them.
+static ftxui::Element rpc_stats_overlay(RpcEngine& engine, const std::string& status) {
+    using namespace ftxui;
+    constexpr size_t kMaxRows = 20;
+
+    const auto snap = engine.stats().snapshot();
+
+    std::vector<const std::pair<const RpcStats::Key, RpcMethodStats>*> sorted;
+    for (const auto& kv : snap)
+        sorted.push_back(&kv);
+    std::ranges::sort(sorted, [](const auto* a, const auto* b) {
+        return a->second.wall.total() > b->second.wall.total();
+    });
+
+    auto cell = [](const std::string& s, int w) { return text(s) | size(WIDTH, EQUAL, w); };
+    auto p50  = [](const LatencyHistogram& h) {
+        return h.count() ? fmt_latency(h.percentile(0.5)) : std::string("-");
+    };
+
+    Elements rows;
+    rows.push_back(hbox({cell(" Caller", 12), cell("Method", 28), cell("Calls", 7),
+                         cell("Err", 5), cell("p50", 10), cell("p90", 10), cell("Max", 10),
+                         cell("TTFB p50", 10), cell("Parse p50", 10), cell("Received", 10)}) |
+                   color(Color::GrayDark));
+    for (size_t i = 0; i < sorted.size() && i < kMaxRows; ++i) {
+        const auto& [key, st] = *sorted[i];
+        rows.push_back(hbox({
+            cell(" " + (key.first.empty() ? std::string("other") : key.first), 12),
+            cell(key.second, 28) | color(Color::White),
+            cell(std::to_string(st.calls), 7),
+            cell(std::to_string(st.errors), 5) | color(st.errors ? Color::Red : Color::Default),
+            cell(fmt_latency(st.wall.percentile(0.5)), 10),
+            cell(fmt_latency(st.wall.percentile(0.9)), 10),
+            cell(fmt_latency(st.wall.max()), 10),
+            cell(p50(st.phase(RpcPhase::FirstByte)), 10),
+            cell(p50(st.phase(RpcPhase::Parse)), 10),
+            cell(fmt_bytes(static_cast<int64_t>(st.bytes_received)), 10),
+        }));
+    }
+    if (sorted.empty())
+        rows.push_back(text(" No RPC calls recorded yet") | color(Color::GrayDark));
+    else if (sorted.size() > kMaxRows)
+        rows.push_back(text(" \u2026 " + std::to_string(sorted.size() - kMaxRows) +
+                            " more rows in the written report") |
+                       color(Color::GrayDark));
+
+    const auto conn  = engine.connection_stats();
+    const auto cache = engine.cache().stats();
+    rows.push_back(separator());
+    rows.push_back(text(" Connections: " + fmt_int(static_cast<int64_t>(conn.fresh)) +
+                        " opened, " + fmt_int(static_cast<int64_t>(conn.reused)) +
+                        " reused   Cache: " + fmt_int(static_cast<int64_t>(cache.hits)) +
+                        " hits, " + fmt_int(static_cast<int64_t>(cache.coalesced)) +
+                        " coalesced") |
+                   color(Color::GrayDark));
+    rows.push_back(hbox({text(" [w] write  [r] reset  [Esc] close") | color(Color::GrayDark),
+                         filler(), text(status + " ") | color(Color::Green)}));
+
+    return center_overlay(build_titled_panel(" RPC Diagnostics ", "", std::move(rows), 116));
+}
+
 // ============================================================================
 // Application entry point
 // ============================================================================
@@ -118,8 +187,9 @@ class Application {
 
     RpcConfig                cfg;
     mutable Guarded<RpcAuth> auth;
-    int                      refresh_secs = 5;
-    std::string              network      = "main";
+    int                      refresh_secs    = 5;
+    int                      rpc_connections = 4; // RpcEngine pool size shared by all tabs
+    std::string              network         = "main";
     std::string              cookie_file;
     std::string              datadir;
     bool                     explicit_creds = false;
@@ -130,6 +200,10 @@ class Application {
     bool                     debug_enabled = false;
     std::string              debug_file;
     mutable std::ofstream    debug_out;
+    std::string              rpc_stats_file;  // --rpc-stats-file: RpcStats::report() target
+    std::string              record_rpc_file; // --record-rpc: append every RPC exchange here
+    std::string              replay_rpc_file; // --replay-rpc: answer RPCs from this recording
+    double                   replay_speed = 1.0;
     std::vector<std::string> lua_tabs;
     std::vector<std::string> extra_rpcs;
     std::string              lua_dir;      // --lua-dir / config override for the tab script dir
@@ -143,6 +217,10 @@ class Application {
     bool        show_settings_tab{true};
     std::string settings_tab_path; // resolved settings.lua path (for reload gating)
 
+    // Opened by configure(), attached to the RpcEngine by run().
+    std::shared_ptr<RpcRecorder> rpc_recorder; // --record-rpc
+    std::shared_ptr<RpcReplay>   rpc_replay;   // --replay-rpc
+
     // Shared state
     mutable Guarded<AppState> state;
     mutable std::atomic<bool> running{false};
@@ -161,6 +239,10 @@ class Application {
     // Run the application with thread-safe state
     int run() const;
 
+    // --rpc-stats-file, or rpc-stats.txt in the config directory.
+    [[nodiscard]] std::string rpc_stats_path() const;
+    bool                      write_rpc_stats(RpcEngine& engine) const;
+
   public:
     static int run(int argc, char* argv[]) {
         Application app;
@@ -173,6 +255,25 @@ class Application {
     }
 };
 
+std::string Application::rpc_stats_path() const {
+    if (!rpc_stats_file.empty())
+        return rpc_stats_file;
+    return (std::filesystem::path(default_config_dir()) / "rpc-stats.txt").string();
+}
+
+bool Application::write_rpc_stats(RpcEngine& engine) const {
+    const std::string path = rpc_stats_path();
+    std::error_code   ec;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+    std::ofstream f(path);
+    if (!f)
+        return false;
+    f << engine.stats().report();
+    f.close();
+    paths::chown_to_invoking_user(path);
+    return static_cast<bool>(f);
+}
+
 int Application::configure(int argc, char* argv[]) {
     CLI::App app{"bitcoin-tui — Terminal UI for Bitcoin Core"};
 
@@ -191,6 +292,11 @@ int Application::configure(int argc, char* argv[]) {
                          ->default_val(8332)
                          ->check(CLI::Range(1, 65535))
                          ->group("Connection");
+    app.add_option("--rpc-connections", rpc_connections,
+                   "Max concurrent RPC connections shared by all tabs")
+        ->default_val(4)
+        ->check(CLI::Range(1, 16))
+        ->group("Connection");
 
     // Authentication (cookie auth is used by default)
     std::string user_str, pass_str;
@@ -247,6 +353,23 @@ int Application::configure(int argc, char* argv[]) {
                                           "File to write debug output to (requires --debug)")
                                ->group("Debug");
     debug_flag->needs(debug_file_opt);
+    app.add_option("--rpc-stats-file", rpc_stats_file,
+                   "Write RPC latency stats here on exit and on 'w' in the diagnostics "
+                   "overlay (default <config dir>/rpc-stats.txt, 'w' only)")
+        ->group("Debug");
+    auto* record_opt =
+        app.add_option("--record-rpc", record_rpc_file,
+                       "Append every RPC request and response, with timestamps, to this file")
+            ->group("Debug");
+    auto* replay_opt = app.add_option("--replay-rpc", replay_rpc_file,
+                                      "Answer RPCs from a --record-rpc file instead of the node")
+                           ->group("Debug");
+    app.add_option("--replay-speed", replay_speed,
+                   "Divide recorded latencies by this when replaying (0 = answer at once)")
+        ->default_val(1.0)
+        ->check(CLI::NonNegativeNumber)
+        ->group("Debug");
+    record_opt->excludes(replay_opt);
 
     // clang-format off
     app.footer(
@@ -255,6 +378,7 @@ int Application::configure(int argc, char* argv[]) {
         "      /                                 Activate txid search\n"
         "      Enter                             Submit search\n"
         "      Escape                            Cancel input / dismiss result / quit\n"
+        "      D                                 RPC diagnostics (latency per caller/method)\n"
         "      q                                 Quit"
     );
     // clang-format on
@@ -380,6 +504,20 @@ int Application::configure(int argc, char* argv[]) {
         }
     }
 
+    try {
+        if (!record_rpc_file.empty()) {
+            rpc_recorder = std::make_shared<RpcRecorder>(record_rpc_file);
+            paths::chown_to_invoking_user(record_rpc_file);
+        }
+        if (!replay_rpc_file.empty()) {
+            rpc_replay = RpcReplay::load(replay_rpc_file, replay_speed);
+            can_launch = false; // there is no node to start
+        }
+    } catch (const RpcError& e) {
+        std::fprintf(stderr, "bitcoin-tui: %s\n", e.what());
+        return 1;
+    }
+
     // Locate the directory holding Lua tab scripts (settings.lua etc.).
     //   1. --lua-dir / `lua-dir` in config.toml takes precedence. It names the
     //      lua/ root (the folder containing tabs/); the tab scripts are read
@@ -472,14 +610,27 @@ int Application::run() const {
     std::string global_search_str;
     bool        global_search_active = false;
 
+    // RPC diagnostics overlay ('D')
+    bool        rpc_stats_open = false;
+    std::string rpc_stats_status; // outcome of the last write/reset
+
     int tab_index = 0;
 
+    // One bounded connection pool for the whole process: the poll thread and
+    // every tab submit their RPCs here, so bitcoind sees at most rpc_connections
+    // sockets no matter how many Lua tabs are loaded.
+    auto rpc_engine = std::make_shared<RpcEngine>(cfg, auth.get(), rpc_connections);
+    if (rpc_recorder)
+        rpc_engine->record_to(rpc_recorder);
+    if (rpc_replay)
+        rpc_engine->replay_from(rpc_replay);
+
     // Tab objects (mempool first — tools captures a reference to it via lambda)
-    DashboardTab dashboard_tab(cfg, auth, screen, running, state, refresh_secs);
-    MempoolTab   mempool_tab(cfg, auth, screen, running, state, refresh_secs);
-    PeersTab     peers_tab(cfg, auth, screen, running, state, refresh_secs);
+    DashboardTab dashboard_tab(rpc_engine, screen, running, state, refresh_secs);
+    MempoolTab   mempool_tab(rpc_engine, screen, running, state, refresh_secs);
+    PeersTab     peers_tab(rpc_engine, screen, running, state, refresh_secs);
     ToolsTab     tools_tab(
-        cfg, auth, screen, running, state, refresh_secs,
+        rpc_engine, screen, running, state, refresh_secs,
         [&](const std::string& q, bool sw) { mempool_tab.trigger_search(q, sw, tab_index); });
 
     std::string debug_log = debug_log_file.empty()
@@ -511,7 +662,7 @@ int Application::run() const {
     auto make_lua_tab = [&](json options) -> std::unique_ptr<LuaTab> {
         if (!options.contains("script") || options["script"].get<std::string>().empty())
             throw std::runtime_error("--tab: missing script path");
-        return std::make_unique<LuaTab>(cfg, auth, screen, running, state, refresh_secs, debug_log,
+        return std::make_unique<LuaTab>(rpc_engine, screen, running, state, refresh_secs, debug_log,
                                         std::move(options), extra_rpcs,
                                         debug_enabled ? &debug_out : nullptr);
     };
@@ -726,6 +877,23 @@ int Application::run() const {
             });
         }
 
+        // RPC backlog per submitter, only while requests are waiting for a connection
+        {
+            std::string backlog;
+            for (const auto& [tag, depth] : rpc_engine->queue_depth()) {
+                if (depth.queued == 0)
+                    continue;
+                backlog += (backlog.empty() ? "" : ", ") + (tag.empty() ? "other" : tag) + " " +
+                           std::to_string(depth.queued);
+            }
+            if (!backlog.empty())
+                status_left =
+                    hbox({status_left, text("  RPC queue: " + backlog) | color(Color::Yellow)});
+        }
+
+        if (rpc_stats_open && snap.connected)
+            tab_content = rpc_stats_overlay(*rpc_engine, rpc_stats_status);
+
         // Connection overlay (shown when disconnected)
         auto content = snap.connected ? tab_content | flex : [&]() -> Element {
             Elements conn_rows;
@@ -935,6 +1103,27 @@ int Application::run() const {
             return false;
         }
 
+        // RPC diagnostics overlay: swallows character keys while open
+        if (rpc_stats_open) {
+            if (event == Event::Escape || event == Event::Character('D')) {
+                rpc_stats_open = false;
+            } else if (event == Event::Character('w')) {
+                rpc_stats_status = write_rpc_stats(*rpc_engine)
+                                       ? "Written to " + rpc_stats_path()
+                                       : "Cannot write " + rpc_stats_path();
+            } else if (event == Event::Character('r')) {
+                rpc_engine->stats().reset();
+                rpc_stats_status = "Reset";
+            } else if (event == Event::Character('q')) {
+                screen.ExitLoopClosure()();
+                return true;
+            } else {
+                return event.is_character();
+            }
+            screen.Post(Event::Custom);
+            return true;
+        }
+
         // Tab-specific event dispatch (priority order — see MEMORY.md CatchEvent note)
         if (tools_tab.handle_tools_input(event))
             return true;
@@ -965,6 +1154,12 @@ int Application::run() const {
             screen.ExitLoopClosure()();
             return true;
         }
+        if (event == Event::Character('D')) {
+            rpc_stats_open = true;
+            rpc_stats_status.clear();
+            screen.Post(Event::Custom);
+            return true;
+        }
         if (event == Event::Character('q')) {
             screen.ExitLoopClosure()();
             return true;
@@ -974,22 +1169,23 @@ int Application::run() const {
 
     auto wake_screen = [&] { screen.Post(Event::Custom); };
 
-    // Background polling thread
+    // Background polling thread. Cancelled at shutdown, which cuts short both the
+    // refresh interval and any poll cycle still in progress.
+    auto        poll_cancel = std::make_shared<RpcCancelToken>();
     std::thread poll_thread([&] {
-        RpcClient rpc(cfg, auth);
+        RpcClient  rpc(rpc_engine, {"poll", {}, {}, poll_cancel});
+        RestClient rest(rpc_engine, {"poll", {}, {}, poll_cancel}); // block stats fast path (-rest)
 
         state.update([](auto& s) { s.refreshing = true; });
         screen.Post(Event::Custom);
 
-        poll_rpc(rpc, state, wake_screen);
+        poll_rpc(rpc, state, wake_screen, &rest);
 
         state.update([](auto& s) { s.refreshing = false; });
         screen.Post(Event::Custom);
 
         while (running) {
-            for (int i = 0; i < refresh_secs * 10 && running; ++i)
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-            if (!running)
+            if (poll_cancel->wait_for(std::chrono::seconds(refresh_secs)) || !running)
                 break;
 
             state.update([](auto& s) { s.refreshing = true; });
@@ -1003,14 +1199,14 @@ int Application::run() const {
                     auth.update([&](auto& a) {
                         try {
                             apply_cookie(a, path);
-                            rpc = RpcClient(cfg, a);
+                            rpc_engine->set_auth(a);
                         } catch (...) { // NOLINT(bugprone-empty-catch)
                         }
                     });
                 }
             }
 
-            poll_rpc(rpc, state, wake_screen);
+            poll_rpc(rpc, state, wake_screen, &rest);
 
             state.update([](auto& s) { s.refreshing = false; });
             screen.Post(Event::Custom);
@@ -1040,6 +1236,10 @@ int Application::run() const {
     screen.Loop(event_handler);
 
     running = false;
+    poll_cancel->cancel();
+    // Fail whatever is still queued and run every pending completion while the
+    // tabs they reference are still alive.
+    rpc_engine->shutdown();
     for (auto tab : tabs)
         tab->join();
     for (auto& p : dead_lua_tabs)
@@ -1049,6 +1249,10 @@ int Application::run() const {
     poll_thread.join();
     anim_thread.join();
 
+    if (!rpc_stats_file.empty() && !write_rpc_stats(*rpc_engine))
+        std::fprintf(stderr, "bitcoin-tui: cannot write RPC stats to %s\n",
+                     rpc_stats_file.c_str());
+
     return 0;
 }
 } // anonymous namespace
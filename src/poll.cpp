@@ -1,27 +1,107 @@
+#include <algorithm>
+#include <future>
+#include <map>
 #include <vector>
 
 #include "format.hpp"
 #include "poll.hpp"
 
+static constexpr int kRecentBlocks = 20;
+
+// ============================================================================
+// Recent-block stats over REST
+//
+// Two small requests (a hash by height, then 80-byte headers) map the window
+// to block hashes; only blocks not already on screen are downloaded, so a new
+// tip usually costs one binary block instead of 20 getblockstats calls. Returns
+// false if the window moved underneath us, leaving JSON-RPC to answer.
+// ============================================================================
+static bool recent_blocks_rest(RestClient& rest, int64_t tip, const std::string& tip_hash,
+                               const std::vector<BlockStat>& known, std::vector<BlockStat>& out) {
+    const int64_t low     = std::max<int64_t>(0, tip - (kRecentBlocks - 1));
+    const int64_t count   = tip - low + 1;
+    const auto    headers = rest.headers(static_cast<int>(count), rest.blockhash_by_height(low));
+    if (static_cast<int64_t>(headers.size()) != count)
+        return false;
+
+    // A header's hash is the next header's prev_hash; the tip's comes from
+    // getblockchaininfo and is checked against the downloaded block below.
+    std::vector<std::string> hashes(headers.size());
+    for (size_t i = 0; i + 1 < headers.size(); ++i)
+        hashes[i] = headers[i + 1].prev_hash.hex();
+    hashes.back() = tip_hash;
+
+    std::map<std::string, BlockStat> reusable;
+    for (const auto& b : known) {
+        if (!b.hash.empty())
+            reusable[b.hash] = b;
+    }
+
+    // Start every missing download before waiting on any of them.
+    std::map<size_t, std::future<std::string>> downloads;
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        if (!reusable.count(hashes[i]))
+            downloads[i] = rest.block_async(hashes[i]);
+    }
+
+    out.clear();
+    for (size_t i = headers.size(); i-- > 0;) { // newest first
+        auto it = downloads.find(i);
+        if (it == downloads.end()) {
+            out.push_back(reusable[hashes[i]]);
+            continue;
+        }
+        const std::string raw = it->second.get();
+        const Block       blk = decode_block(raw);
+        if (blk.header.prev_hash != headers[i].prev_hash ||
+            blk.header.merkle_root != headers[i].merkle_root)
+            return false; // reorg between the header and block requests
+
+        // getblockstats leaves the coinbase out of its size totals.
+        BlockStat stat;
+        stat.height = low + static_cast<int64_t>(i);
+        stat.txs    = static_cast<int64_t>(blk.txs.size());
+        for (size_t t = 1; t < blk.txs.size(); ++t) {
+            stat.total_size += static_cast<int64_t>(blk.txs[t].size);
+            stat.total_weight += blk.txs[t].weight();
+        }
+        stat.time = blk.header.time;
+        stat.hash = hashes[i];
+        out.push_back(std::move(stat));
+    }
+    return true;
+}
+
 // ============================================================================
 // RPC polling
 // ============================================================================
 void poll_rpc(RpcClient& rpc, Guarded<AppState>& state,
-              const std::function<void()>& on_core_ready) {
+              const std::function<void()>& on_core_ready, RestClient* rest) {
     // Read cached tip height so we can skip re-fetching block stats when tip hasn't moved.
     int64_t cached_tip = state.access([](const auto& s) { return s.blocks_fetched_at; });
 
     try {
-        // ── Phase 1: fast calls ──────────────────────────────────────────────
-        auto bc  = rpc.call("getblockchaininfo")["result"];
-        auto net = rpc.call("getnetworkinfo")["result"];
-        auto mp  = rpc.call("getmempoolinfo")["result"];
-        auto pi  = rpc.call("getpeerinfo")["result"];
+        // ── Phase 1: fast calls, one batched round trip ──────────────────────
+        auto phase1 = rpc.call_batch({
+            {"getblockchaininfo"},
+            {"getnetworkinfo"},
+            {"getmempoolinfo"},
+            {"getpeerinfo"},
+            {"getprivatebroadcastinfo"},
+        });
+        for (size_t i = 0; i < 4; ++i) {
+            if (!phase1[i].ok())
+                throw RpcError(phase1[i].error);
+        }
+        const json& bc  = phase1[0].result;
+        const json& net = phase1[1].result;
+        const json& mp  = phase1[2].result;
+        const json& pi  = phase1[3].result;
 
-        int64_t new_tip = bc.value("blocks", 0LL);
+        int64_t               new_tip = bc.value("blocks", 0LL);
+        std::vector<PeerInfo> peers   = json_bind_array<PeerInfo>(pi);
 
         // Commit core state immediately so the UI can render before block stats arrive.
-        // TODO: build peers list outside the lock to reduce hold time
         state.update([&](auto& s) {
             // Blockchain
             s.chain         = bc.value("chain", "—");
@@ -55,57 +135,20 @@ void poll_rpc(RpcClient& rpc, Guarded<AppState>& state,
             s.network_hashps = bc.value("difficulty", 0.0) * 4294967296.0 / 600.0;
 
             // Peers
-            s.peers.clear();
-            for (const auto& p : pi) {
-                PeerInfo peer;
-                peer.id              = p.value("id", 0);
-                peer.addr            = p.value("addr", "");
-                peer.network         = p.value("network", "");
-                peer.subver          = p.value("subver", "");
-                peer.inbound         = p.value("inbound", false);
-                peer.bytes_sent      = p.value("bytessent", 0LL);
-                peer.bytes_recv      = p.value("bytesrecv", 0LL);
-                peer.version         = p.value("version", 0);
-                peer.synced_blocks   = p.value("synced_blocks", 0LL);
-                peer.conntime        = p.value("conntime", 0LL);
-                peer.connection_type = p.value("connection_type", "");
-                peer.transport       = p.value("transport_protocol_type", "");
-                peer.addr_processed  = p.value("addr_processed", 0LL);
-                if (p.contains("servicesnames") && p["servicesnames"].is_array()) {
-                    std::string svc;
-                    for (const auto& sv : p["servicesnames"]) {
-                        if (!svc.empty())
-                            svc += ", ";
-                        svc += sv.get<std::string>();
-                    }
-                    peer.services = svc;
-                }
-                if (p.contains("pingtime") && p["pingtime"].is_number()) {
-                    peer.ping_ms = p["pingtime"].get<double>() * 1000.0;
-                }
-                if (p.contains("minping") && p["minping"].is_number()) {
-                    peer.min_ping_ms = p["minping"].get<double>() * 1000.0;
-                }
-                if (p.contains("bip152_hb_from") && p["bip152_hb_from"].is_bool()) {
-                    peer.bip152_hb_from = p["bip152_hb_from"].get<bool>();
-                }
-                if (p.contains("bip152_hb_to") && p["bip152_hb_to"].is_bool()) {
-                    peer.bip152_hb_to = p["bip152_hb_to"].get<bool>();
-                }
-                s.peers.push_back(std::move(peer));
-            }
+            s.peers = std::move(peers);
 
             s.connected = true;
             s.error_message.clear();
             s.last_update = now_string();
         });
 
-        // Private broadcast queue (Bitcoin Core PR #29415 — skipped on older nodes)
-        try {
-            auto                     pbinfo = rpc.call("getprivatebroadcastinfo")["result"];
+        // Private broadcast queue (Bitcoin Core PR #29415 — the batch element
+        // carries an error on older nodes, which leaves the list untouched)
+        if (phase1[4].ok()) {
             std::vector<std::string> txids;
-            if (pbinfo.is_array()) {
-                for (const auto& entry : pbinfo) {
+            const json& queue = phase1[4].result;
+            if (queue.is_array()) {
+                for (const auto& entry : queue) {
                     if (entry.is_string())
                         txids.push_back(entry.get<std::string>());
                     else if (entry.is_object() && entry.contains("txid"))
@@ -113,30 +156,39 @@ void poll_rpc(RpcClient& rpc, Guarded<AppState>& state,
                 }
             }
             state.update([&](auto& s) { s.privbcast_txids = std::move(txids); });
-        } catch (...) { // NOLINT(bugprone-empty-catch) — RPC absent on older nodes
         }
 
         // Let the UI render with core data while block stats are fetched.
         if (on_core_ready)
             on_core_ready();
 
-        // ── Phase 2: per-block stats (slow — up to 20 sequential calls) ────────────
+        // ── Phase 2: per-block stats (up to 20 heights, one round trip) ────
         if (new_tip != cached_tip && new_tip > 0) {
             std::vector<BlockStat> fresh_blocks;
-            for (int i = 0; i < 20 && (new_tip - i) >= 0; ++i) {
+            bool                   have_blocks = false;
+            if (rest && rest->available()) {
+                auto known = state.access([](const auto& s) { return s.recent_blocks; });
                 try {
-                    json      params = {new_tip - i,
-                                        json({"height", "txs", "total_size", "total_weight", "time"})};
-                    auto      bs     = rpc.call("getblockstats", params)["result"];
+                    have_blocks = recent_blocks_rest(*rest, new_tip, bc.value("bestblockhash", ""),
+                                                     known, fresh_blocks);
+                } catch (...) { // NOLINT(bugprone-empty-catch) — fall back to getblockstats
+                }
+            }
+
+            if (!have_blocks) {
+                const json stats_fields =
+                    json({"height", "txs", "total_size", "total_weight", "time", "blockhash"});
+                std::vector<RpcBatchCall> calls;
+                for (int i = 0; i < kRecentBlocks && (new_tip - i) >= 0; ++i)
+                    calls.push_back({"getblockstats", {new_tip - i, stats_fields}});
+
+                fresh_blocks.clear();
+                for (const auto& r : rpc.call_batch(calls)) {
+                    if (!r.ok())
+                        break;
                     BlockStat blk;
-                    blk.height       = bs.value("height", 0LL);
-                    blk.txs          = bs.value("txs", 0LL);
-                    blk.total_size   = bs.value("total_size", 0LL);
-                    blk.total_weight = bs.value("total_weight", 0LL);
-                    blk.time         = bs.value("time", 0LL);
-                    fresh_blocks.push_back(blk);
-                } catch (...) {
-                    break;
+                    json_bind(r.result, blk);
+                    fresh_blocks.push_back(std::move(blk));
                 }
             }
 
@@ -4,10 +4,12 @@
 #include <mutex>
 
 #include "guarded.hpp"
+#include "rest_client.hpp"
 #include "rpc_client.hpp"
 #include "state.hpp"
 
 // Two-phase RPC poll: commits core data (blockchain/network/mempool/peers) and
-// calls on_core_ready before the slower per-block stats fetches.
+// calls on_core_ready before the slower per-block stats fetches. With `rest`,
+// block stats come from the node's REST interface when it is enabled.
 void poll_rpc(RpcClient& rpc, Guarded<AppState>& state,
-              const std::function<void()>& on_core_ready = nullptr);
+              const std::function<void()>& on_core_ready = nullptr, RestClient* rest = nullptr);
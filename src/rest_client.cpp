@@ -0,0 +1,104 @@
+#include "rest_client.hpp"
+#include "rpc_engine.hpp"
+
+#include <algorithm>
+#include <utility>
+
+RestClient::RestClient(std::shared_ptr<RpcEngine> engine, RpcCallOptions options)
+    : engine_(std::move(engine)), options_(std::move(options)),
+      available_(std::make_shared<std::atomic<bool>>(true)) {}
+
+RestClient RestClient::with_options(RpcCallOptions options) const {
+    RestClient copy = *this;
+    copy.options_   = std::move(options);
+    return copy;
+}
+
+// ---------------------------------------------------------------------------
+// Transport
+// ---------------------------------------------------------------------------
+std::future<std::string> RestClient::get(const std::string& path) {
+    auto promise = std::make_shared<std::promise<std::string>>();
+    auto fut     = promise->get_future();
+    if (!available()) {
+        promise->set_exception(
+            std::make_exception_ptr(RestUnavailable("REST interface is disabled on the node")));
+        return fut;
+    }
+    engine_->get("/rest/" + path,
+                 [promise, available = available_](std::exception_ptr err, std::string body) {
+                     if (!err) {
+                         promise->set_value(std::move(body));
+                         return;
+                     }
+                     // Without -rest the node has no handler for /rest/ and answers a
+                     // bare 404; REST's own "not found" replies always carry a message.
+                     try {
+                         std::rethrow_exception(err);
+                     } catch (const RpcHttpError& e) {
+                         if (e.status() == 404 && e.body().empty()) {
+                             available->store(false);
+                             err = std::make_exception_ptr(
+                                 RestUnavailable("REST interface is disabled on the node"));
+                         }
+                     } catch (...) { // NOLINT(bugprone-empty-catch) — passed on as is
+                     }
+                     promise->set_exception(err);
+                 },
+                 options_);
+    return fut;
+}
+
+// Hashes end up in the request path, so only well-formed ones are sent.
+static std::string checked_hash(const std::string& hash) {
+    if (!Hash256::from_hex(hash))
+        throw RpcError("Invalid block hash: " + hash);
+    return hash;
+}
+
+// ---------------------------------------------------------------------------
+// Endpoints
+// ---------------------------------------------------------------------------
+std::string RestClient::block(const std::string& hash) { return block_async(hash).get(); }
+
+std::future<std::string> RestClient::block_async(const std::string& hash) {
+    return get("block/" + checked_hash(hash) + ".bin");
+}
+
+std::vector<BlockHeader> RestClient::headers(int count, const std::string& hash) {
+    // The /headers/<count>/<hash> form is understood by every REST-capable
+    // release; newer ones also accept ?count=.
+    const std::string raw =
+        get("headers/" + std::to_string(count) + "/" + checked_hash(hash) + ".bin").get();
+    return decode_headers(raw);
+}
+
+std::string RestClient::blockhash_by_height(int64_t height) {
+    const std::string raw = get("blockhashbyheight/" + std::to_string(height) + ".bin").get();
+    if (raw.size() != 32)
+        throw ConsensusError("Unexpected blockhashbyheight response size");
+    Hash256 h;
+    std::copy(raw.begin(), raw.end(), h.bytes.begin());
+    return h.hex();
+}
+
+int64_t RestClient::block_count() {
+    const std::string body = get("chaininfo.json").get();
+    try {
+        const json::cursor blocks = json::cursor(body)["blocks"];
+        if (!blocks.is_number())
+            throw RpcError("REST chaininfo has no block count");
+        return blocks.get<int64_t>();
+    } catch (const json::exception& e) {
+        throw RpcError("JSON parse error: " + std::string(e.what()));
+    }
+}
+
+json RestClient::mempool_info() {
+    std::string body = get("mempool/info.json").get();
+    try {
+        return json::parse_document(std::move(body));
+    } catch (const json::exception& e) {
+        throw RpcError("JSON parse error: " + std::string(e.what()));
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "consensus.hpp"
+#include "rpc_client.hpp"
+
+// The node does not serve REST (it was started without `-rest`).
+class RestUnavailable : public RpcError {
+  public:
+    using RpcError::RpcError;
+};
+
+// Client for Bitcoin Core's REST interface. The binary endpoints return
+// consensus-serialized data that is much cheaper for the node to produce, and
+// for us to read, than verbose JSON-RPC; decode it with consensus.hpp.
+//
+// Requests travel over the same RpcEngine (and connection pool) as JSON-RPC.
+// Callers use REST as a fast path and fall back to JSON-RPC when a call throws;
+// once the node has shown REST is disabled, calls throw RestUnavailable without
+// a round trip. Copies share that knowledge.
+class RestClient {
+  public:
+    explicit RestClient(std::shared_ptr<RpcEngine> engine, RpcCallOptions options = {});
+
+    // A copy that sends with `options` instead (e.g. carrying a cancel token).
+    [[nodiscard]] RestClient with_options(RpcCallOptions options) const;
+
+    // False once the node answered as if REST were disabled.
+    [[nodiscard]] bool available() const { return available_->load(); }
+
+    // Raw serialized block (/rest/block/<hash>.bin); decode with decode_block().
+    std::string              block(const std::string& hash);
+    std::future<std::string> block_async(const std::string& hash);
+
+    // Up to `count` headers starting at `hash` and walking towards the tip.
+    std::vector<BlockHeader> headers(int count, const std::string& hash);
+
+    // Hash (display hex) of the active-chain block at `height`.
+    std::string blockhash_by_height(int64_t height);
+
+    // Height of the node's active chain tip (/rest/chaininfo.json "blocks").
+    int64_t block_count();
+
+    // /rest/mempool/info.json — the same object as getmempoolinfo.
+    json mempool_info();
+
+  private:
+    std::shared_ptr<RpcEngine>         engine_;
+    RpcCallOptions                     options_;
+    std::shared_ptr<std::atomic<bool>> available_;
+
+    std::future<std::string> get(const std::string& path);
+};
@@ -0,0 +1,154 @@
+#include "rpc_cache.hpp"
+
+#include <utility>
+
+using namespace std::chrono_literals;
+
+// Chain-wide summaries live for a second: the poll thread and Lua tabs asking
+// within the same second share one answer, while no refresh interval (the
+// shortest is one second) ever sees data from an earlier cycle. Per-block data
+// only changes with the tip, which clears the cache anyway. Lookups whose
+// answer moves constantly are coalesced but not kept.
+static const std::map<std::string, std::chrono::milliseconds> kDefaultTtl = {
+    {"getbestblockhash", 1s},
+    {"getblockchaininfo", 1s},
+    {"getblockcount", 1s},
+    {"getchaintips", 1s},
+    {"getmempoolinfo", 1s},
+    {"getmininginfo", 1s},
+    {"getnettotals", 1s},
+    {"getnetworkinfo", 1s},
+    {"getpeerinfo", 1s},
+    {"getblock", 10min},
+    {"getblockhash", 10min},
+    {"getblockheader", 10min},
+    {"getblockstats", 10min},
+    {"getmempoolentry", 0s},
+    {"getrawmempool", 0s},
+    {"getrawtransaction", 0s},
+};
+
+// Beyond this many cached replies, expired ones are swept on insert.
+static constexpr size_t kSweepThreshold = 64;
+
+RpcCache::RpcCache() : ttl_(kDefaultTtl) {}
+
+// One waiter's callback throwing must not cost the others their reply.
+static void deliver(const RpcCache::Callback& done, std::exception_ptr error, json reply) {
+    try {
+        done(std::move(error), std::move(reply));
+    } catch (...) { // NOLINT(bugprone-empty-catch)
+    }
+}
+
+void RpcCache::set_ttl(const std::string& method, std::chrono::milliseconds ttl) {
+    STDLOCK(mtx_);
+    ttl_[method] = ttl;
+}
+
+void RpcCache::exclude(const std::string& method) {
+    STDLOCK(mtx_);
+    ttl_.erase(method);
+}
+
+bool RpcCache::handles(const std::string& method) const {
+    STDLOCK(mtx_);
+    return ttl_.contains(method);
+}
+
+bool RpcCache::keeps(const std::string& method) const {
+    STDLOCK(mtx_);
+    auto it = ttl_.find(method);
+    return it != ttl_.end() && it->second > 0ms;
+}
+
+void RpcCache::clear() {
+    STDLOCK(mtx_);
+    entries_.clear();
+}
+
+RpcCache::Stats RpcCache::stats() const {
+    STDLOCK(mtx_);
+    return stats_;
+}
+
+std::optional<std::string> RpcCache::join(const std::string& method, const json& params,
+                                          Callback done) {
+    std::string key = method + '\n';
+    params.dump_to(key);
+    json        cached;
+    {
+        STDLOCK(mtx_);
+        auto hit = entries_.find(key);
+        if (hit != entries_.end() && hit->second.expires <= Clock::now()) {
+            entries_.erase(hit);
+            hit = entries_.end();
+        }
+        if (hit != entries_.end()) {
+            ++stats_.hits;
+            cached = hit->second.reply;
+        } else if (auto flight = in_flight_.find(key); flight != in_flight_.end()) {
+            ++stats_.coalesced;
+            flight->second.waiters.push_back(std::move(done));
+            return std::nullopt;
+        } else {
+            ++stats_.misses;
+            Flight& f    = in_flight_[key];
+            f.method     = method;
+            f.generation = generation_;
+            f.waiters.push_back(std::move(done));
+            return key;
+        }
+    }
+    deliver(done, nullptr, std::move(cached)); // outside the lock: callbacks may call back in
+    return std::nullopt;
+}
+
+// The tip hash carried by a reply, if the method reports one.
+static std::optional<std::string> reported_tip(const std::string& method, const json& reply) {
+    if (!reply.contains("result"))
+        return std::nullopt;
+    const json& result = reply["result"];
+    if (method == "getbestblockhash" && result.is_string())
+        return result.get<std::string>();
+    if (method == "getblockchaininfo" && result.is_object() && result.contains("bestblockhash") &&
+        result["bestblockhash"].is_string())
+        return result["bestblockhash"].get<std::string>();
+    return std::nullopt;
+}
+
+void RpcCache::resolve(const std::string& key, std::exception_ptr error, const json& reply) {
+    std::vector<Callback> waiters;
+    {
+        STDLOCK(mtx_);
+        auto it = in_flight_.find(key);
+        if (it == in_flight_.end())
+            return;
+        Flight flight = std::move(it->second);
+        in_flight_.erase(it);
+        waiters = std::move(flight.waiters);
+
+        if (!error) {
+            bool current = flight.generation == generation_;
+            if (auto tip = reported_tip(flight.method, reply); tip && *tip != tip_) {
+                // A new tip invalidates everything learned about the old one,
+                // including replies to calls still in flight.
+                if (!tip_.empty()) {
+                    entries_.clear();
+                    ++generation_;
+                }
+                tip_    = std::move(*tip);
+                current = true;
+            }
+            auto ttl = ttl_.find(flight.method);
+            if (current && ttl != ttl_.end() && ttl->second.count() > 0) {
+                const auto now = Clock::now();
+                if (entries_.size() >= kSweepThreshold)
+                    std::erase_if(entries_, [&](const auto& e) { return e.second.expires <= now; });
+                entries_[key] = {reply, now + ttl->second};
+            }
+        }
+    }
+    for (auto& done : waiters)
+        deliver(done, error, error ? json() : reply);
+}
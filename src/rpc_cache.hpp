@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "json.hpp"
+#include "thread_safety.hpp"
+
+// Single-flight coalescing and short-lived caching of read-only JSON-RPC calls.
+//
+// The poll thread and Lua tabs ask the node the same questions on independent
+// timers. Calls to a method with a policy (see set_ttl) are keyed by
+// method + params: while one is in flight, identical calls from any thread wait
+// for its reply instead of sending their own, and a successful reply is served
+// from memory until its TTL runs out or the chain tip changes (as seen in any
+// getblockchaininfo / getbestblockhash reply passing through). Errors are
+// shared with the waiters but never cached.
+//
+// RpcClient routes its calls through the cache of the engine it uses, so every
+// client sharing an engine shares this cache.
+class RpcCache {
+  public:
+    // Exactly one of `error` (non-null) or `reply` is meaningful; `reply` is the
+    // whole JSON-RPC response object, as RpcClient::Callback receives it.
+    using Callback = std::function<void(std::exception_ptr error, json reply)>;
+    using Clock    = std::chrono::steady_clock;
+
+    struct Stats {
+        uint64_t hits      = 0; // served from memory
+        uint64_t coalesced = 0; // attached to an identical call in flight
+        uint64_t misses    = 0; // sent to the node
+    };
+
+    RpcCache(); // default policy for the read-only calls the TUI makes
+
+    // A zero TTL only coalesces overlapping calls. Methods with no policy (all
+    // writes, and anything not listed) always go straight to the node.
+    void set_ttl(const std::string& method, std::chrono::milliseconds ttl)
+        EXCLUSIVE_LOCKS_REQUIRED(!mtx_);
+    void exclude(const std::string& method) EXCLUSIVE_LOCKS_REQUIRED(!mtx_);
+    [[nodiscard]] bool handles(const std::string& method) const EXCLUSIVE_LOCKS_REQUIRED(!mtx_);
+    // Whether replies to `method` are served from memory (a TTL above zero),
+    // rather than only coalesced or not handled at all.
+    [[nodiscard]] bool keeps(const std::string& method) const EXCLUSIVE_LOCKS_REQUIRED(!mtx_);
+
+    // Route one call. A cached reply is handed to `done` before this returns;
+    // an identical call in flight takes `done` along. Otherwise the caller leads:
+    // the returned key must be passed to resolve() once the node has answered,
+    // which completes `done` and every caller that joined meanwhile.
+    [[nodiscard]] std::optional<std::string> join(const std::string& method, const json& params,
+                                                  Callback done) EXCLUSIVE_LOCKS_REQUIRED(!mtx_);
+    void resolve(const std::string& key, std::exception_ptr error, const json& reply)
+        EXCLUSIVE_LOCKS_REQUIRED(!mtx_);
+
+    // Drop every cached reply (in-flight calls are unaffected).
+    void clear() EXCLUSIVE_LOCKS_REQUIRED(!mtx_);
+
+    [[nodiscard]] Stats stats() const EXCLUSIVE_LOCKS_REQUIRED(!mtx_);
+
+  private:
+    struct Flight {
+        std::string           method;
+        uint64_t              generation = 0; // tip generation when the call was sent
+        std::vector<Callback> waiters;
+    };
+    struct Entry {
+        json              reply;
+        Clock::time_point expires;
+    };
+
+    mutable StdMutex                                 mtx_;
+    std::map<std::string, std::chrono::milliseconds> ttl_ GUARDED_BY(mtx_);
+    std::map<std::string, Flight>                    in_flight_ GUARDED_BY(mtx_);
+    std::map<std::string, Entry>                     entries_ GUARDED_BY(mtx_);
+    std::string                                      tip_ GUARDED_BY(mtx_);
+    uint64_t                                         generation_ GUARDED_BY(mtx_) = 0;
+    Stats                                            stats_ GUARDED_BY(mtx_);
+};
@@ -1,231 +1,171 @@
 #include "rpc_client.hpp"
+#include "rpc_cache.hpp"
+#include "rpc_engine.hpp"
 
-#ifdef _WIN32
-#include <winsock2.h>
-#include <ws2tcpip.h>
-using sock_t                     = SOCKET;
-using io_sz_t                    = int;
-static constexpr sock_t kBadSock = INVALID_SOCKET;
-static void             net_close(sock_t s) { closesocket(s); }
-#else
-#include <netdb.h>
-#include <sys/socket.h>
-#include <unistd.h>
-using sock_t                     = int;
-using io_sz_t                    = ssize_t;
-static constexpr sock_t kBadSock = -1;
-static void             net_close(sock_t s) { close(s); }
-#endif
-
+#include <algorithm>
+#include <atomic>
 #include <cctype>
-#include <cerrno>
+#include <chrono>
 #include <cstdio>
-#include <cstring>
-
-static std::string safe_strerror(int errnum) {
-    char buf[128];
-#ifdef _WIN32
-    strerror_s(buf, sizeof(buf), errnum);
-    return buf;
-#elif defined(__GLIBC__) && (_GNU_SOURCE || !(_POSIX_C_SOURCE >= 200112L))
-    // GNU strerror_r returns char*
-    return strerror_r(errnum, buf, sizeof(buf));
-#else
-    // POSIX strerror_r returns int
-    if (strerror_r(errnum, buf, sizeof(buf)) == 0)
-        return buf;
-    return "Unknown error " + std::to_string(errnum);
-#endif
-}
+#include <optional>
+#include <set>
+#include <utility>
 
 RpcClient::RpcClient(RpcConfig config, RpcAuth auth)
-    : config_(std::move(config)), auth_(std::move(auth)) {}
+    : engine_(std::make_shared<RpcEngine>(std::move(config), std::move(auth))) {}
 
-// ---------------------------------------------------------------------------
-// base64 encoder (RFC 4648)
-// ---------------------------------------------------------------------------
-std::string RpcClient::base64_encode(const std::string& input) {
-    static const char* chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+RpcClient::RpcClient(std::shared_ptr<RpcEngine> engine, RpcCallOptions options)
+    : engine_(std::move(engine)), options_(std::move(options)) {}
 
-    std::string out;
-    out.reserve((input.size() + 2) / 3 * 4);
-
-    unsigned char buf[3];
-    int           i = 0;
-
-    for (unsigned char c : input) {
-        buf[i++] = c;
-        if (i == 3) {
-            out += chars[(buf[0] >> 2) & 0x3f];
-            out += chars[((buf[0] & 0x03) << 4) | ((buf[1] >> 4) & 0x0f)];
-            out += chars[((buf[1] & 0x0f) << 2) | ((buf[2] >> 6) & 0x03)];
-            out += chars[buf[2] & 0x3f];
-            i = 0;
-        }
-    }
-    if (i == 1) {
-        out += chars[(buf[0] >> 2) & 0x3f];
-        out += chars[(buf[0] & 0x03) << 4];
-        out += '=';
-        out += '=';
-    } else if (i == 2) {
-        out += chars[(buf[0] >> 2) & 0x3f];
-        out += chars[((buf[0] & 0x03) << 4) | ((buf[1] >> 4) & 0x0f)];
-        out += chars[(buf[1] & 0x0f) << 2];
-        out += '=';
-    }
-    return out;
-}
+RpcConnectionStats RpcClient::connection_stats() const { return engine_->connection_stats(); }
 
 // ---------------------------------------------------------------------------
-// Low-level HTTP POST over a plain TCP socket
+// Cancellation
 // ---------------------------------------------------------------------------
-std::string RpcClient::http_post(const std::string& endpoint, const std::string& body) {
-#ifdef _WIN32
-    static const bool wsa_ok = []() {
-        WSADATA d;
-        return WSAStartup(MAKEWORD(2, 2), &d) == 0;
-    }();
-    if (!wsa_ok)
-        throw RpcError("WSAStartup failed");
-#endif
-
-    struct addrinfo  hints = {};
-    struct addrinfo* res   = nullptr;
-
-    hints.ai_family   = AF_UNSPEC;
-    hints.ai_socktype = SOCK_STREAM;
-
-    const std::string port_str = std::to_string(config_.port);
-    int               err      = getaddrinfo(config_.host.c_str(), port_str.c_str(), &hints, &res);
-    if (err != 0)
-        throw RpcError("getaddrinfo: " + std::string(gai_strerror(err)));
-
-    sock_t sock = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
-    if (sock == kBadSock) {
-        freeaddrinfo(res);
-        throw RpcError("socket(): " + safe_strerror(errno));
-    }
+void RpcCancelToken::cancel() {
+    // Flipped under the lock so on_cancel() either sees it or gets collected here.
+    auto fns = listeners_.update_and_notify([this](auto& l) {
+        cancelled_ = true;
+        return std::exchange(l, {});
+    });
+    for (auto& [key, fn] : fns)
+        fn();
+}
 
-    // Set send/recv timeout
-#ifdef _WIN32
-    DWORD timeout_ms = static_cast<DWORD>(config_.timeout_seconds) * 1000;
-    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout_ms),
-               sizeof(timeout_ms));
-    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout_ms),
-               sizeof(timeout_ms));
-#else
-    struct timeval tv = {};
-    tv.tv_sec         = config_.timeout_seconds;
-    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
-    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
-#endif
-
-    if (connect(sock, res->ai_addr, res->ai_addrlen) < 0) {
-        freeaddrinfo(res);
-        net_close(sock);
-        throw RpcError("connect to " + config_.host + ":" + port_str +
-                       " failed: " + safe_strerror(errno));
-    }
-    freeaddrinfo(res);
-
-    // Build HTTP/1.1 request with Connection: close so the server closes after
-    // responding, allowing recv() to reach EOF without waiting for a timeout.
-    const std::string auth    = base64_encode(auth_.user + ":" + auth_.password);
-    const std::string request = "POST " + endpoint +
-                                " HTTP/1.1\r\n"
-                                "Host: " +
-                                config_.host +
-                                "\r\n"
-                                "Authorization: Basic " +
-                                auth +
-                                "\r\n"
-                                "Content-Type: application/json\r\n"
-                                "Content-Length: " +
-                                std::to_string(body.size()) +
-                                "\r\n"
-                                "Connection: close\r\n"
-                                "\r\n" +
-                                body;
-
-    // Send request
-    size_t sent_total = 0;
-    while (sent_total < request.size()) {
-        io_sz_t n = send(sock, request.c_str() + sent_total,
-                         static_cast<int>(request.size() - sent_total), 0);
-        if (n <= 0) {
-            net_close(sock);
-            throw RpcError("send() failed: " + safe_strerror(errno));
-        }
-        sent_total += static_cast<size_t>(n);
-    }
+void RpcCancelToken::on_cancel(const void* key, std::function<void()> fn) {
+    bool already = listeners_.update([&](auto& l) {
+        if (cancelled_)
+            return true;
+        l[key] = std::move(fn);
+        return false;
+    });
+    if (already)
+        fn();
+}
 
-    // Read response
-    std::string response;
-    char        buf[4096];
-    io_sz_t     n;
-    while ((n = recv(sock, buf, sizeof(buf), 0)) > 0)
-        response.append(buf, static_cast<size_t>(n));
-
-#ifdef _WIN32
-    const int recv_err = (n < 0) ? WSAGetLastError() : 0;
-#else
-    const int recv_err = (n < 0) ? errno : 0;
-#endif
-    net_close(sock);
-
-    if (response.empty()) {
-#ifdef _WIN32
-        if (n < 0 && (recv_err == WSAETIMEDOUT || recv_err == WSAEWOULDBLOCK))
-#else
-        if (n < 0 && (recv_err == EAGAIN || recv_err == EWOULDBLOCK))
-#endif
-            throw RpcError("RPC timeout — Bitcoin Core did not respond within " +
-                           std::to_string(config_.timeout_seconds) + "s");
-        else if (n < 0)
-            throw RpcError("recv() failed: " + safe_strerror(recv_err));
-        else
-            throw RpcError(
-                "Empty response from Bitcoin Core — connection closed before any data was sent");
-    }
+void RpcCancelToken::forget(const void* key) {
+    listeners_.update([&](auto& l) { l.erase(key); });
+}
 
-    // Extract HTTP status
-    auto status_space = response.find(' ');
-    if (status_space == std::string::npos)
-        throw RpcError("Invalid HTTP response");
+bool RpcCancelToken::wait_for(std::chrono::milliseconds timeout) {
+    listeners_.wait_until(std::chrono::steady_clock::now() + timeout,
+                          [this](auto&) { return cancelled_.load(); });
+    return cancelled_;
+}
 
-    int status_code = 0;
-    try {
-        status_code = std::stoi(response.substr(status_space + 1, 3));
-    } catch (...) {
-        throw RpcError("Invalid HTTP status line");
-    }
+// A reply shared through RpcCache may be awaited by callers that did not cancel,
+// so cancelling one of them only detaches it: `done` fires once, with
+// RpcCancelled as soon as `token` is cancelled or with the reply, whichever
+// comes first, while the shared request carries on.
+static RpcClient::Callback detachable(const std::shared_ptr<RpcCancelToken>& token,
+                                      RpcClient::Callback                    done) {
+    if (!token)
+        return done;
+    struct Once {
+        std::atomic<bool>   fired{false};
+        RpcClient::Callback done;
+    };
+    auto once  = std::make_shared<Once>();
+    once->done = std::move(done);
+    token->on_cancel(once.get(), [once] {
+        if (!once->fired.exchange(true))
+            once->done(std::make_exception_ptr(RpcCancelled()), json());
+    });
+    return [once, weak = std::weak_ptr(token)](std::exception_ptr err, json reply) {
+        if (auto t = weak.lock())
+            t->forget(once.get());
+        if (!once->fired.exchange(true))
+            once->done(std::move(err), std::move(reply));
+    };
+}
 
-    // Locate body
-    auto header_end = response.find("\r\n\r\n");
-    if (header_end == std::string::npos)
-        throw RpcError("No HTTP header separator found");
-
-    std::string resp_body = response.substr(header_end + 4);
-
-    if (status_code == 401)
-        throw RpcError("Authentication failed (HTTP 401) — check your RPC credentials");
-    // 500 is also used by Bitcoin Core for RPC-level errors; body still contains JSON
-    if (status_code != 200 && status_code != 500) {
-        std::string detail = resp_body.substr(0, 200);
-        if (detail.size() == 200)
-            detail += "…";
-        throw RpcError("HTTP " + std::to_string(status_code) + ": " + detail);
-    }
+// Options for a request other callers may be waiting on: no single caller's
+// cancellation or deadline may cut it short.
+static RpcCallOptions shared_options(RpcCallOptions options) {
+    options.cancel.reset();
+    options.deadline = {};
+    return options;
+}
 
-    return resp_body;
+// Methods that only read node or wallet state. The engine may send one of them
+// again when the keep-alive socket it went out on turns out to be dead
+// (RpcCallOptions::idempotent); anything else, such as sendrawtransaction,
+// setban, addnode or stop, may already have run, so that failure is reported.
+static const std::set<std::string> kReadOnlyMethods = {
+    "decodepsbt",
+    "decoderawtransaction",
+    "decodescript",
+    "estimatesmartfee",
+    "getaddednodeinfo",
+    "getaddressinfo",
+    "getbalance",
+    "getbalances",
+    "getbestblockhash",
+    "getblock",
+    "getblockchaininfo",
+    "getblockcount",
+    "getblockfilter",
+    "getblockhash",
+    "getblockheader",
+    "getblockstats",
+    "getchaintips",
+    "getchaintxstats",
+    "getconnectioncount",
+    "getdeploymentinfo",
+    "getdifficulty",
+    "getindexinfo",
+    "getmempoolancestors",
+    "getmempoolcluster",
+    "getmempooldescendants",
+    "getmempoolentry",
+    "getmempoolfeeratediagram",
+    "getmempoolinfo",
+    "getmininginfo",
+    "getnettotals",
+    "getnetworkhashps",
+    "getnetworkinfo",
+    "getnodeaddresses",
+    "getpeerinfo",
+    "getrawmempool",
+    "getrawtransaction",
+    "gettransaction",
+    "gettxout",
+    "gettxoutsetinfo",
+    "getwalletinfo",
+    "listbanned",
+    "listtransactions",
+    "listunspent",
+    "listwallets",
+    "uptime",
+    "validateaddress",
+};
+
+static RpcCallOptions resendable(RpcCallOptions options, const std::string& method) {
+    options.idempotent = options.idempotent || kReadOnlyMethods.contains(method);
+    return options;
 }
 
 // ---------------------------------------------------------------------------
 // JSON-RPC call
 // ---------------------------------------------------------------------------
 json RpcClient::call(const std::string& method, const json& params) {
-    return call("/", method, params);
+    return call_async(method, params).get();
+}
+
+std::future<json> RpcClient::call_async(const std::string& method, const json& params) {
+    auto promise = std::make_shared<std::promise<json>>();
+    auto fut     = promise->get_future();
+    call_async("/", method, params, [promise](std::exception_ptr err, json reply) {
+        if (err)
+            promise->set_exception(err);
+        else
+            promise->set_value(std::move(reply));
+    });
+    return fut;
+}
+
+void RpcClient::call_async(const std::string& method, const json& params, Callback done) {
+    call_async("/", method, params, std::move(done));
 }
 
 static std::string uri_encode(const std::string& s) {
@@ -244,43 +184,428 @@ static std::string uri_encode(const std::string& s) {
 
 json RpcClient::call_wallet(const std::string& wallet, const std::string& method,
                             const json& params) {
-    return call("/wallet/" + uri_encode(wallet), method, params);
+    auto promise = std::make_shared<std::promise<json>>();
+    auto fut     = promise->get_future();
+    call_async("/wallet/" + uri_encode(wallet), method, params,
+               [promise](std::exception_ptr err, json reply) {
+                   if (err)
+                       promise->set_exception(err);
+                   else
+                       promise->set_value(std::move(reply));
+               });
+    return fut.get();
 }
 
-json RpcClient::call(const std::string& endpoint, const std::string& method, const json& params) {
+void RpcClient::call_wallet_async(const std::string& wallet, const std::string& method,
+                                  const json& params, Callback done) {
+    call_async("/wallet/" + uri_encode(wallet), method, params, std::move(done));
+}
+
+// Human-readable message for a non-null JSON-RPC "error" member.
+static std::string rpc_error_message(const json& err) {
+    if (err.contains("message") && err["message"].is_string())
+        return err["message"].get<std::string>();
+
+    std::string msg = "RPC error";
+    if (err.contains("code") && (err["code"].is_number_integer() || err["code"].is_number()))
+        msg += " (code " + std::to_string(err["code"].get<long long>()) + ")";
+    msg += ": " + err.dump();
+    return msg;
+}
+
+// Appends one JSON-RPC request object to `out`, writing `params` straight into
+// it rather than copying them into a request document first (a
+// sendrawtransaction carries the whole transaction hex).
+static void append_rpc_request(std::string& out, int id, const std::string& method,
+                               const json& params) {
     // Omit "jsonrpc" version field — Bitcoin Core v25+ rejects "1.1".
     // Legacy JSON-RPC 1.0 (no version field) is accepted by all versions.
-    json req = {
-        {"id", ++request_id_},
-        {"method", method},
-        {"params", params},
-    };
+    out += R"({"id":)";
+    out += std::to_string(id);
+    out += R"(,"method":)";
+    json::dump_string(out, method);
+    out += R"(,"params":)";
+    params.dump_to(out);
+    out += '}';
+}
+
+static std::string rpc_request(int id, const std::string& method, const json& params) {
+    std::string out;
+    append_rpc_request(out, id, method, params);
+    return out;
+}
+
+// A JSON-RPC response parsed while it downloads (RpcEngine::BodySink), so it is
+// never held as text and as a document at once. Fed on the engine thread; the
+// time spent parsing is recorded as the request's Parse phase.
+class StreamedResponse {
+  public:
+    StreamedResponse(RpcStats& stats, std::string caller, std::string method)
+        : stats_(stats), caller_(std::move(caller)), method_(std::move(method)) {}
+
+    json::incremental_parser& parser() { return parser_; }
+
+    void feed(std::string_view bytes) {
+        parse([&] { parser_.feed(bytes); });
+    }
+
+    // The response, once the engine reports the outcome: rethrows `err`, or
+    // throws RpcError if the document is incomplete.
+    json finish(std::exception_ptr err) {
+        if (err) {
+            if (failed_) // the parse error is what failed the request
+                record();
+            std::rethrow_exception(err);
+        }
+        json doc;
+        parse([&] { doc = parser_.finish(); });
+        record();
+        return doc;
+    }
+
+  private:
+    RpcStats&                 stats_;
+    const std::string         caller_;
+    const std::string         method_;
+    json::incremental_parser  parser_;
+    std::chrono::microseconds elapsed_{0};
+    bool                      failed_ = false;
+
+    template <typename Fn> void parse(Fn&& fn) {
+        const auto start = std::chrono::steady_clock::now();
+        try {
+            fn();
+        } catch (const json::exception& e) {
+            failed_ = true;
+            elapsed_ += since(start);
+            throw RpcError("JSON parse error: " + std::string(e.what()));
+        } catch (...) { // thrown by a stream() handler
+            failed_ = true;
+            elapsed_ += since(start);
+            throw;
+        }
+        elapsed_ += since(start);
+    }
+
+    static std::chrono::microseconds since(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start);
+    }
+
+    void record() { stats_.record_parse(caller_, method_, elapsed_); }
+};
+
+void RpcClient::call_async(const std::string& endpoint, const std::string& method,
+                           const json& params, Callback done) {
+    // Read-only node calls go through the engine's cache: identical requests from
+    // any client sharing the engine ride on one round trip (see rpc_cache.hpp).
+    if (options_.cancel && options_.cancel->cancelled()) {
+        done(std::make_exception_ptr(RpcCancelled()), json());
+        return;
+    }
+    RpcCache&      cache   = engine_->cache();
+    RpcCallOptions options = options_;
+    if (endpoint == "/" && cache.handles(method)) {
+        auto key = cache.join(method, params, detachable(options_.cancel, std::move(done)));
+        if (!key)
+            return;
+        done    = [&cache, key = std::move(*key)](std::exception_ptr err, json reply) {
+            cache.resolve(key, err, reply);
+        };
+        options = shared_options(std::move(options));
+    }
+    post_call(endpoint, method, params, std::move(options), std::move(done), {});
+}
+
+void RpcClient::call_streamed(const std::string& method, const json& params,
+                              ElementHandler on_element, Callback done) {
+    post_call("/", method, params, options_, std::move(done), std::move(on_element));
+}
+
+void RpcClient::call_streamed(const std::string& method, const json& params,
+                              ElementHandler on_element) {
+    auto promise = std::make_shared<std::promise<void>>();
+    auto fut     = promise->get_future();
+    call_streamed(method, params, std::move(on_element),
+                  [promise](std::exception_ptr err, json) {
+                      if (err)
+                          promise->set_exception(err);
+                      else
+                          promise->set_value();
+                  });
+    fut.get();
+}
+
+std::string RpcClient::call_text(const std::string& method, const json& params) {
+    return call_text_async(method, params).get();
+}
+
+std::future<std::string> RpcClient::call_text_async(const std::string& method,
+                                                    const json&        params) {
+    auto promise = std::make_shared<std::promise<std::string>>();
+    auto fut     = promise->get_future();
+    post_text("/", method, params, [promise](std::exception_ptr err, std::string body) {
+        if (err)
+            promise->set_exception(err);
+        else
+            promise->set_value(std::move(body));
+    });
+    return fut;
+}
+
+void RpcClient::call_text_async(const std::string& method, const json& params,
+                                TextCallback done) {
+    post_text("/", method, params, std::move(done));
+}
+
+void RpcClient::call_wallet_text_async(const std::string& wallet, const std::string& method,
+                                       const json& params, TextCallback done) {
+    post_text("/wallet/" + uri_encode(wallet), method, params, std::move(done));
+}
+
+void RpcClient::post_text(const std::string& endpoint, const std::string& method,
+                          const json& params, TextCallback done) {
+    engine_->post(endpoint, rpc_request(engine_->reserve_ids(), method, params),
+                  [done = std::move(done)](std::exception_ptr err, std::string body) {
+                      try {
+                          if (err)
+                              std::rethrow_exception(err);
+                          const json::cursor error = json::cursor(body)["error"];
+                          if (!error.is_null())
+                              throw RpcError(rpc_error_message(error.to_json()));
+                      } catch (const json::exception& e) {
+                          done(std::make_exception_ptr(
+                                   RpcError("JSON parse error: " + std::string(e.what()))),
+                               {});
+                          return;
+                      } catch (...) {
+                          done(std::current_exception(), {});
+                          return;
+                      }
+                      done(nullptr, std::move(body));
+                  },
+                  resendable(options_, method), method);
+}
+
+void RpcClient::post_call(const std::string& endpoint, const std::string& method,
+                          const json& params, RpcCallOptions options, Callback done,
+                          ElementHandler on_element) {
+    // Parsing happens on the engine thread, as the body arrives, so the caller
+    // only ever sees the result.
+    auto response = std::make_shared<StreamedResponse>(engine_->stats(), options_.tag, method);
+    if (on_element)
+        response->parser().stream("result", std::move(on_element));
+    engine_->post(endpoint, rpc_request(engine_->reserve_ids(), method, params),
+                  [response](std::string_view bytes) { response->feed(bytes); },
+                  [done = std::move(done), response](std::exception_ptr err, std::string) {
+                      json parsedJson;
+                      try {
+                          parsedJson        = response->finish(err);
+                          const json& error = std::as_const(parsedJson)["error"];
+                          if (!error.is_null())
+                              throw RpcError(rpc_error_message(error));
+                      } catch (...) {
+                          done(std::current_exception(), json());
+                          return;
+                      }
+                      done(nullptr, std::move(parsedJson));
+                  },
+                  resendable(std::move(options), method), method);
+}
 
-    const std::string body     = req.dump();
-    const std::string response = http_post(endpoint, body);
+// ---------------------------------------------------------------------------
+// JSON-RPC batch
+// ---------------------------------------------------------------------------
+// "[getblockcount,getmempoolinfo]": a batch's row in RpcStats, the same for
+// every batch of the same methods whatever their order or repetition.
+static std::string batch_label(const std::vector<RpcBatchCall>& calls) {
+    std::set<std::string> methods;
+    for (const auto& c : calls)
+        methods.insert(c.method);
+    std::string label = "[";
+    for (const auto& m : methods)
+        label += (label.size() > 1 ? "," : "") + m;
+    return label + "]";
+}
+
+// Map a batch reply back onto the calls that produced it.
+static std::vector<RpcBatchResult> collect_batch(const std::vector<RpcBatchCall>& calls,
+                                                 int first_id, const json& replies) {
+    std::vector<RpcBatchResult> results(calls.size());
+
+    // A malformed batch is answered with a single error object, not an array.
+    if (!replies.is_array()) {
+        if (replies.contains("error") && !replies["error"].is_null())
+            throw RpcError(rpc_error_message(replies["error"]));
+        throw RpcError("Invalid JSON-RPC batch response (expected an array)");
+    }
+
+    std::vector<bool> seen(calls.size(), false);
+    for (const auto& reply : replies) {
+        const json& id = reply["id"];
+        if (!id.is_number_integer())
+            continue;
+        const int64_t slot = id.get<int64_t>() - first_id;
+        if (slot < 0 || slot >= static_cast<int64_t>(calls.size()))
+            continue;
+        auto& r = results[static_cast<size_t>(slot)];
+        if (!reply["error"].is_null())
+            r.error = rpc_error_message(reply["error"]);
+        else
+            r.result = replies.share(reply["result"]); // no copy out of the document
+        seen[static_cast<size_t>(slot)] = true;
+    }
+    for (size_t i = 0; i < calls.size(); ++i) {
+        if (!seen[i])
+            results[i].error = "No response for batched call: " + calls[i].method;
+    }
+    return results;
+}
+
+std::vector<RpcBatchResult> RpcClient::call_batch(const std::vector<RpcBatchCall>& calls) {
+    if (calls.empty())
+        return {};
+    return call_batch_async(calls).get();
+}
 
-    json parsedJson;
+static std::string error_message(std::exception_ptr err) {
     try {
-        parsedJson = json::parse(response);
-    } catch (const json::exception& e) {
-        throw RpcError("JSON parse error: " + std::string(e.what()));
+        std::rethrow_exception(std::move(err));
+    } catch (const std::exception& e) {
+        return e.what();
+    } catch (...) {
+        return "Unknown error";
     }
+}
 
-    if (parsedJson.contains("error") && !parsedJson["error"].is_null()) {
-        const json& err = parsedJson["error"];
-        std::string msg;
-
-        if (err.contains("message") && err["message"].is_string()) {
-            msg = err["message"].get<std::string>();
-        } else {
-            msg = "RPC error";
-            if (err.contains("code") &&
-                (err["code"].is_number_integer() || err["code"].is_number())) {
-                msg += " (code " + std::to_string(err["code"].get<long long>()) + ")";
-            }
-            msg += ": " + err.dump();
+// A batch in progress: elements complete one by one, from the cache or from
+// the reply; the promise is fulfilled when the last one does, or broken early
+// by abandon() when the caller cancels.
+struct PendingBatch {
+    std::vector<RpcBatchResult>               results;
+    std::atomic<size_t>                       left;
+    std::exception_ptr                        failure; // the batch request itself failed
+    std::promise<std::vector<RpcBatchResult>> promise;
+    std::atomic<bool>                         fulfilled{false};
+    std::weak_ptr<RpcCancelToken>             token; // registered with, if any
+
+    explicit PendingBatch(size_t n) : results(n), left(n + 1) {} // +1 until all are routed
+
+    void settle() {
+        if (--left > 0)
+            return;
+        if (auto t = token.lock())
+            t->forget(this);
+        if (fulfilled.exchange(true))
+            return;
+        if (failure)
+            promise.set_exception(failure);
+        else
+            promise.set_value(std::move(results));
+    }
+
+    void abandon() {
+        if (!fulfilled.exchange(true))
+            promise.set_exception(std::make_exception_ptr(RpcCancelled()));
+    }
+};
+
+std::future<std::vector<RpcBatchResult>> RpcClient::call_batch_async(std::vector<RpcBatchCall> calls) {
+    auto pending = std::make_shared<PendingBatch>(calls.size());
+    auto fut     = pending->promise.get_future();
+    if (const auto& token = options_.cancel) {
+        pending->token = token;
+        token->on_cancel(pending.get(), [pending] { pending->abandon(); });
+        if (token->cancelled())
+            return fut;
+    }
+
+    // Elements the cache answers, or that join an identical call already in
+    // flight, complete on their own; only the rest go into the request.
+    RpcCache&                               cache = engine_->cache();
+    std::vector<size_t>                     sent;
+    std::vector<std::optional<std::string>> keys(calls.size());
+    for (size_t i = 0; i < calls.size(); ++i) {
+        if (cache.handles(calls[i].method)) {
+            keys[i] = cache.join(calls[i].method, calls[i].params,
+                                 [pending, i](std::exception_ptr err, const json& reply) {
+                                     auto& r = pending->results[i];
+                                     if (err)
+                                         r.error = error_message(err);
+                                     else
+                                         r.result = reply.share(reply["result"]);
+                                     pending->settle();
+                                 });
+            if (!keys[i])
+                continue;
         }
-        throw RpcError(msg);
+        sent.push_back(i);
+    }
+    if (sent.empty()) {
+        pending->settle();
+        return fut;
     }
-    return parsedJson;
+    // Elements other callers may be waiting on keep the request alive when this
+    // caller cancels; without any, cancelling aborts it on the wire.
+    const bool shared = std::ranges::any_of(sent, [&](size_t i) { return keys[i].has_value(); });
+
+    // Ids are allocated consecutively, so a reply maps back to its slot by offset.
+    std::vector<RpcBatchCall> batch_calls;
+    batch_calls.reserve(sent.size());
+    for (size_t i : sent)
+        batch_calls.push_back(std::move(calls[i]));
+    const int   first_id = engine_->reserve_ids(static_cast<int>(batch_calls.size()));
+    std::string batch    = "[";
+    int         id       = first_id;
+    for (const auto& c : batch_calls) {
+        if (id != first_id)
+            batch += ',';
+        append_rpc_request(batch, id++, c.method, c.params);
+    }
+    batch += ']';
+
+    RpcCallOptions options = shared ? shared_options(options_) : options_;
+    options.idempotent =
+        options.idempotent || std::ranges::all_of(batch_calls, [](const RpcBatchCall& c) {
+            return kReadOnlyMethods.contains(c.method);
+        });
+
+    std::string label    = batch_label(batch_calls);
+    auto        response = std::make_shared<StreamedResponse>(engine_->stats(), options_.tag,
+                                                              label);
+    engine_->post(
+        "/", std::move(batch),
+        [response](std::string_view bytes) { response->feed(bytes); },
+        [pending, &cache, response, first_id, sent, keys = std::move(keys),
+         batch_calls = std::move(batch_calls)](std::exception_ptr err, std::string) {
+            std::vector<RpcBatchResult> got;
+            try {
+                got = collect_batch(batch_calls, first_id, response->finish(err));
+            } catch (...) {
+                pending->failure = std::current_exception();
+                for (size_t i : sent) {
+                    if (keys[i])
+                        cache.resolve(*keys[i], pending->failure, json());
+                    else
+                        pending->settle();
+                }
+                return;
+            }
+            for (size_t j = 0; j < sent.size(); ++j) {
+                const size_t i = sent[j];
+                if (!keys[i]) {
+                    pending->results[i] = std::move(got[j]);
+                    pending->settle();
+                } else if (got[j].ok()) {
+                    cache.resolve(*keys[i], nullptr,
+                                  json({{"result", std::move(got[j].result)}, {"error", nullptr}}));
+                } else {
+                    cache.resolve(*keys[i], std::make_exception_ptr(RpcError(got[j].error)),
+                                  json());
+                }
+            }
+        },
+        std::move(options), label);
+    pending->settle();
+    return fut;
 }
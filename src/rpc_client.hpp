@@ -1,14 +1,46 @@
 #pragma once
 
+#include "guarded.hpp"
 #include "json.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 class RpcError : public std::runtime_error {
   public:
     explicit RpcError(const std::string& msg) : std::runtime_error(msg) {}
 };
 
+// The node answered with an unexpected HTTP status (anything but 200, or the
+// 500 Bitcoin Core uses to carry JSON-RPC errors).
+class RpcHttpError : public RpcError {
+  public:
+    RpcHttpError(int status, const std::string& msg, std::string body = {})
+        : RpcError(msg), status_(status), body_(std::move(body)) {}
+
+    [[nodiscard]] int                status() const { return status_; }
+    [[nodiscard]] const std::string& body() const { return body_; } // first 200 bytes at most
+
+  private:
+    int         status_;
+    std::string body_;
+};
+
+// The caller gave up on the request (RpcCancelToken::cancel()).
+class RpcCancelled : public RpcError {
+  public:
+    RpcCancelled() : RpcError("RPC call cancelled") {}
+};
+
 // Kept at namespace scope to avoid a clang bug where nested structs with
 // default member initializers trigger "needed within definition of enclosing
 // class outside of member functions".
@@ -23,20 +55,133 @@ struct RpcAuth {
     std::string password;
 };
 
+// Keep-alive bookkeeping: every request either opens a fresh TCP connection or
+// reuses the one left open by the previous response.
+struct RpcConnectionStats {
+    uint64_t fresh  = 0; // connections opened (including transparent reconnects)
+    uint64_t reused = 0; // requests sent on an already-open connection
+};
+
+// Lets a caller abandon requests it has already submitted. Shared (by
+// shared_ptr) between the caller and every request carrying it; cancel() is
+// sticky. Requests carrying a cancelled token fail with RpcCancelled at once:
+// queued ones are dropped and in-flight ones have their connection closed.
+class RpcCancelToken {
+  public:
+    void               cancel();
+    [[nodiscard]] bool cancelled() const { return cancelled_.load(); }
+
+    // Run `fn` on the thread calling cancel(), or right away if that already
+    // happened. One callback per `key`: registering again replaces it, so a
+    // long-lived token does not pile up callbacks. forget() drops it unrun.
+    void on_cancel(const void* key, std::function<void()> fn);
+    void forget(const void* key);
+
+    // Sleep for up to `timeout`, waking early on cancel(). True if cancelled.
+    // Meant for a single waiting thread (e.g. a worker's refresh interval).
+    bool wait_for(std::chrono::milliseconds timeout);
+
+  private:
+    std::atomic<bool>                                             cancelled_{false};
+    WaitableGuarded<std::map<const void*, std::function<void()>>> listeners_;
+};
+
+// Per-client request settings. `tag` names the submitter (e.g. a tab) so a
+// shared RpcEngine can report queue depth per caller. `timeout` bounds each
+// attempt from the moment it is sent (zero falls back to
+// RpcConfig::timeout_seconds); `deadline`, if set, is absolute and also
+// covers time spent queued behind other requests. `idempotent` lets a request
+// lost on a stale keep-alive socket be sent again; RpcClient sets it for
+// read-only methods, and REST requests are always resent.
+struct RpcCallOptions {
+    std::string                           tag;
+    std::chrono::milliseconds             timeout{0};
+    std::chrono::steady_clock::time_point deadline{};
+    std::shared_ptr<RpcCancelToken>       cancel{}; // optional
+    bool                                  idempotent = false;
+};
+
+// One element of a JSON-RPC batch request.
+struct RpcBatchCall {
+    std::string method;
+    json        params = json::array();
+};
+
+// Per-element outcome of a batch: exactly one of `result` / `error` is meaningful.
+struct RpcBatchResult {
+    json        result;
+    std::string error; // empty on success
+
+    [[nodiscard]] bool ok() const { return error.empty(); }
+};
+
+class RpcEngine;
+
+// JSON-RPC client. Requests travel over an RpcEngine (see rpc_engine.hpp), which
+// may be private to this client or shared by several of them.
 class RpcClient {
   public:
+    // Exactly one of `error` (non-null) or `reply` is meaningful.
+    using Callback = std::function<void(std::exception_ptr error, json reply)>;
+
     explicit RpcClient(RpcConfig config, RpcAuth auth);
+    explicit RpcClient(std::shared_ptr<RpcEngine> engine, RpcCallOptions options = {});
 
     json call(const std::string& method, const json& params = json::array());
     json call_wallet(const std::string& wallet, const std::string& method,
                      const json& params = json::array());
 
+    // Non-blocking variants: the request is queued on the engine and the caller
+    // continues. Several calls issued back to back are in flight concurrently.
+    // Callbacks run on the engine thread and must not block; a reply already in
+    // the engine's RpcCache is delivered on the calling thread instead, and a call
+    // abandoned through its cancel token may fail on the thread that cancelled it.
+    std::future<json> call_async(const std::string& method, const json& params = json::array());
+    void call_async(const std::string& method, const json& params, Callback done);
+    void call_wallet_async(const std::string& wallet, const std::string& method,
+                           const json& params, Callback done);
+
+    // Send all calls in a single HTTP round trip (JSON-RPC batch). Results come
+    // back in the order of `calls`; an RPC error in one element does not fail the
+    // others. Transport and HTTP failures (and cancellation) still throw RpcError.
+    std::vector<RpcBatchResult>              call_batch(const std::vector<RpcBatchCall>& calls);
+    std::future<std::vector<RpcBatchResult>> call_batch_async(std::vector<RpcBatchCall> calls);
+
+    // For results too large to hold twice, such as getrawmempool true on a full
+    // mempool: each element of the result (array elements, or object members
+    // with their key) is handed to `on_element` on the engine thread as soon as
+    // it has downloaded, and is not kept. `done` then gets the reply with the
+    // result emptied. Never served from or added to the cache. The blocking
+    // variant throws RpcError.
+    using ElementHandler = json::incremental_parser::element_handler;
+    void call_streamed(const std::string& method, const json& params, ElementHandler on_element,
+                       Callback done);
+    void call_streamed(const std::string& method, const json& params, ElementHandler on_element);
+
+    // The reply as text, for replies of which only a few fields are read: read
+    // it with json::cursor(text)["result"] instead of parsing it into a
+    // document. An RPC error still throws RpcError. Never served from or added
+    // to the cache.
+    std::string call_text(const std::string& method, const json& params = json::array());
+    std::future<std::string> call_text_async(const std::string& method,
+                                             const json&        params = json::array());
+    // Callback forms, as for call_async; the reply is empty on error.
+    using TextCallback = std::function<void(std::exception_ptr error, std::string reply)>;
+    void call_text_async(const std::string& method, const json& params, TextCallback done);
+    void call_wallet_text_async(const std::string& wallet, const std::string& method,
+                                const json& params, TextCallback done);
+
+    [[nodiscard]] RpcConnectionStats                connection_stats() const;
+    [[nodiscard]] const std::shared_ptr<RpcEngine>& engine() const { return engine_; }
+
   private:
-    json      call(const std::string& endpoint, const std::string& method, const json& params);
-    RpcConfig config_;
-    RpcAuth   auth_;
-    int       request_id_ = 0;
+    std::shared_ptr<RpcEngine> engine_;
+    RpcCallOptions             options_;
 
-    std::string        http_post(const std::string& endpoint, const std::string& body);
-    static std::string base64_encode(const std::string& input);
+    void call_async(const std::string& endpoint, const std::string& method, const json& params,
+                    Callback done);
+    void post_call(const std::string& endpoint, const std::string& method, const json& params,
+                   RpcCallOptions options, Callback done, ElementHandler on_element);
+    void post_text(const std::string& endpoint, const std::string& method, const json& params,
+                   TextCallback done);
 };
@@ -0,0 +1,1383 @@
+#include "rpc_engine.hpp"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+using sock_t                     = SOCKET;
+using io_sz_t                    = int;
+static constexpr sock_t kBadSock = INVALID_SOCKET;
+static void             net_close(sock_t s) { closesocket(s); }
+static int              net_errno() { return WSAGetLastError(); }
+static int              net_poll(pollfd* fds, size_t n, int ms) {
+    return WSAPoll(fds, static_cast<ULONG>(n), ms);
+}
+#else
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+using sock_t                     = int;
+using io_sz_t                    = ssize_t;
+static constexpr sock_t kBadSock = -1;
+static void             net_close(sock_t s) { close(s); }
+static int              net_errno() { return errno; }
+static int net_poll(pollfd* fds, size_t n, int ms) { return poll(fds, static_cast<nfds_t>(n), ms); }
+#endif
+
+// A keep-alive socket may have been closed by the server while idle; writing to
+// it must surface as an error instead of killing the process with SIGPIPE.
+#ifdef MSG_NOSIGNAL
+static constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+static constexpr int kSendFlags = 0;
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "rpc_recording.hpp"
+#include "thread_safety.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static std::string safe_strerror(int errnum) {
+    char buf[128];
+#ifdef _WIN32
+    strerror_s(buf, sizeof(buf), errnum);
+    return buf;
+#elif defined(__GLIBC__) && (_GNU_SOURCE || !(_POSIX_C_SOURCE >= 200112L))
+    // GNU strerror_r returns char*
+    return strerror_r(errnum, buf, sizeof(buf));
+#else
+    // POSIX strerror_r returns int
+    if (strerror_r(errnum, buf, sizeof(buf)) == 0)
+        return buf;
+    return "Unknown error " + std::to_string(errnum);
+#endif
+}
+
+static bool would_block(int err) {
+#ifdef _WIN32
+    return err == WSAEWOULDBLOCK;
+#else
+    return err == EAGAIN || err == EWOULDBLOCK;
+#endif
+}
+
+static bool connect_in_progress(int err) {
+#ifdef _WIN32
+    return err == WSAEWOULDBLOCK;
+#else
+    return err == EINPROGRESS;
+#endif
+}
+
+static bool is_reset_errno(int err) {
+#ifdef _WIN32
+    return err == WSAECONNRESET || err == WSAECONNABORTED;
+#else
+    return err == EPIPE || err == ECONNRESET;
+#endif
+}
+
+static bool set_nonblocking(sock_t s) {
+#ifdef _WIN32
+    u_long mode = 1;
+    return ioctlsocket(s, FIONBIO, &mode) == 0;
+#else
+    int flags = fcntl(s, F_GETFL, 0);
+    return flags >= 0 && fcntl(s, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+}
+
+static void ensure_winsock() {
+#ifdef _WIN32
+    static const bool wsa_ok = []() {
+        WSADATA d;
+        return WSAStartup(MAKEWORD(2, 2), &d) == 0;
+    }();
+    if (!wsa_ok)
+        throw RpcError("WSAStartup failed");
+#endif
+}
+
+// "30s", or "1500ms" when not a whole number of seconds.
+static std::string format_timeout(std::chrono::milliseconds t) {
+    if (t.count() % 1000 == 0)
+        return std::to_string(t.count() / 1000) + "s";
+    return std::to_string(t.count()) + "ms";
+}
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Self-wake channel: lets submitters interrupt the loop's poll(). A pipe on
+// POSIX; WSAPoll only accepts sockets, so Windows uses a loopback TCP pair.
+// ---------------------------------------------------------------------------
+class Waker {
+  public:
+    Waker() {
+#ifdef _WIN32
+        sock_t listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        sockaddr_in addr{};
+        addr.sin_family      = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        int len              = sizeof(addr);
+        if (listener == kBadSock || bind(listener, reinterpret_cast<sockaddr*>(&addr), len) != 0 ||
+            listen(listener, 1) != 0 ||
+            getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+            if (listener != kBadSock)
+                net_close(listener);
+            throw RpcError("RPC engine: cannot create wake socket");
+        }
+        write_ = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (write_ == kBadSock ||
+            ::connect(write_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            net_close(listener);
+            throw RpcError("RPC engine: cannot connect wake socket");
+        }
+        read_ = accept(listener, nullptr, nullptr);
+        net_close(listener);
+        if (read_ == kBadSock)
+            throw RpcError("RPC engine: cannot accept wake socket");
+#else
+        int fds[2];
+        if (pipe(fds) != 0)
+            throw RpcError("RPC engine: pipe() failed: " + safe_strerror(errno));
+        read_  = fds[0];
+        write_ = fds[1];
+#endif
+        set_nonblocking(read_);
+        set_nonblocking(write_);
+    }
+    ~Waker() {
+        net_close(read_);
+        net_close(write_);
+    }
+    Waker(const Waker&)            = delete;
+    Waker& operator=(const Waker&) = delete;
+
+    [[nodiscard]] sock_t fd() const { return read_; }
+
+    void notify() {
+        const char b = 1;
+#ifdef _WIN32
+        (void)send(write_, &b, 1, 0);
+#else
+        (void)!write(write_, &b, 1);
+#endif
+    }
+
+    void drain() {
+        char buf[64];
+#ifdef _WIN32
+        while (recv(read_, buf, sizeof(buf), 0) > 0) {
+        }
+#else
+        while (read(read_, buf, sizeof(buf)) > 0) {
+        }
+#endif
+    }
+
+  private:
+    sock_t read_  = kBadSock;
+    sock_t write_ = kBadSock;
+};
+
+// ---------------------------------------------------------------------------
+// Incremental HTTP/1.1 response parser (Content-Length, chunked, or to-EOF)
+// ---------------------------------------------------------------------------
+bool iequals(std::string_view a, std::string_view b) {
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) !=
+            std::tolower(static_cast<unsigned char>(b[i])))
+            return false;
+    }
+    return true;
+}
+
+bool icontains(std::string_view haystack, std::string_view needle) {
+    for (size_t i = 0; i + needle.size() <= haystack.size(); ++i) {
+        if (iequals(haystack.substr(i, needle.size()), needle))
+            return true;
+    }
+    return false;
+}
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+        s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r'))
+        s.remove_suffix(1);
+    return s;
+}
+
+// The parser owns the receive buffers: the caller asks prepare() where the
+// next recv() should land and reports the byte count to commit(). Status line,
+// headers and chunk framing go through a small staging buffer; body bytes of a
+// Content-Length response (and chunk payloads) are read straight into `body`,
+// which is sized once from the header, so a multi-megabyte getblock reply is
+// never copied on its way to the JSON parser.
+//
+// With a `sink`, a 200 or 500 body is not kept: `body` is a bounded window that
+// is handed to the sink after every read, so the response is never buffered
+// whole. Exceptions from the sink propagate out of commit().
+class HttpResponseParser {
+  public:
+    int                                   status     = 0;
+    bool                                  keep_alive = true;
+    std::string                           body;
+    std::function<void(std::string_view)> sink;
+
+    // Writable space for the next read; never empty.
+    std::span<char> prepare() {
+        direct_ = buf_.size() == pos_;
+        if (direct_) {
+            switch (stage_) {
+            case Stage::Body:
+                return {body.data() + body_fill_,
+                        std::min(content_length_ - body_done(), body.size() - body_fill_)};
+            case Stage::ChunkData:
+                grow_body(sink ? std::min(chunk_left_, kSinkWindow) : chunk_left_);
+                return {body.data() + body_fill_, std::min(chunk_left_, body.size() - body_fill_)};
+            case Stage::UntilEof:
+                grow_body(std::max(kStagingSize, body_fill_)); // geometric growth
+                return {body.data() + body_fill_, body.size() - body_fill_};
+            default:
+                break;
+            }
+        }
+        direct_ = false;
+        compact();
+        staged_ = buf_.size();
+        buf_.resize(staged_ + kStagingSize);
+        return {buf_.data() + staged_, kStagingSize};
+    }
+
+    // `n` bytes were written into the last prepare() span. Returns true once the
+    // response is complete.
+    bool commit(size_t n) {
+        received_ += n;
+        if (!direct_) {
+            buf_.resize(staged_ + n);
+            return deliver(advance());
+        }
+        body_fill_ += n;
+        if (stage_ == Stage::Body && body_done() == content_length_) {
+            stage_ = Stage::Done;
+        } else if (stage_ == Stage::ChunkData) {
+            chunk_left_ -= n;
+            if (!chunk_left_)
+                stage_ = Stage::ChunkEnd;
+        }
+        return deliver(advance());
+    }
+
+    // The peer closed the socket. Returns true if that completes the response
+    // (read-to-EOF framing); false means the response was truncated. A sink has
+    // already been given every byte by commit().
+    bool finish_at_eof() {
+        if (stage_ == Stage::UntilEof) {
+            keep_alive = false;
+            stage_     = Stage::Done;
+            body.resize(body_fill_);
+        }
+        return stage_ == Stage::Done;
+    }
+
+    [[nodiscard]] bool started() const { return received_ > 0; }
+
+  private:
+    enum class Stage { Headers, Body, ChunkSize, ChunkData, ChunkEnd, Trailers, UntilEof, Done };
+
+    static constexpr size_t kStagingSize = 16 * 1024;
+    static constexpr size_t kSinkWindow  = 256 * 1024; // body buffer when streaming
+
+    Stage       stage_ = Stage::Headers;
+    std::string buf_;                    // staging buffer for framing bytes
+    size_t      pos_            = 0;     // parse cursor into buf_
+    size_t      staged_         = 0;     // where the last staging read began
+    bool        direct_         = false; // last prepare() pointed into body
+    size_t      body_fill_      = 0;     // body bytes in `body`; body.size() may be larger
+    size_t      body_sunk_      = 0;     // body bytes already handed to the sink
+    size_t      received_       = 0;
+    size_t      content_length_ = 0;
+    size_t      chunk_left_     = 0;
+
+    [[nodiscard]] size_t body_done() const { return body_sunk_ + body_fill_; }
+
+    // Hand the window to the sink; passes `done` through. The body of a finished
+    // response is left empty.
+    bool deliver(bool done) {
+        if (sink && body_fill_) {
+            sink(std::string_view(body.data(), body_fill_));
+            body_sunk_ += body_fill_;
+            body_fill_ = 0;
+        }
+        if (sink && done)
+            body.clear();
+        return done;
+    }
+
+    // Make room for `extra` more body bytes past body_fill_.
+    void grow_body(size_t extra) {
+        if (body.size() - body_fill_ < extra)
+            body.resize(body_fill_ + extra);
+    }
+
+    void append_body(const char* data, size_t n) {
+        grow_body(n);
+        std::memcpy(body.data() + body_fill_, data, n);
+        body_fill_ += n;
+    }
+
+    // Drop consumed bytes so buf_ only ever holds the unparsed tail.
+    void compact() {
+        buf_.erase(0, pos_);
+        pos_ = 0;
+    }
+
+    std::optional<std::string_view> next_line() {
+        size_t eol = buf_.find("\r\n", pos_);
+        if (eol == std::string::npos)
+            return std::nullopt;
+        std::string_view line(buf_.data() + pos_, eol - pos_);
+        pos_ = eol + 2;
+        return line;
+    }
+
+    void parse_head(std::string_view head) {
+        auto line_end = head.find("\r\n");
+        auto status_l = head.substr(0, line_end);
+        auto sp       = status_l.find(' ');
+        if (status_l.substr(0, 5) != "HTTP/" || sp == std::string_view::npos ||
+            status_l.size() < sp + 4)
+            throw RpcError("Invalid HTTP status line");
+        keep_alive = status_l.substr(0, sp) != "HTTP/1.0";
+        for (size_t i = sp + 1; i < sp + 4; ++i) {
+            if (status_l[i] < '0' || status_l[i] > '9')
+                throw RpcError("Invalid HTTP status line");
+            status = status * 10 + (status_l[i] - '0');
+        }
+
+        bool chunked    = false;
+        bool has_length = false;
+        while (line_end != std::string_view::npos) {
+            size_t next = head.find("\r\n", line_end + 2);
+            auto   line = head.substr(line_end + 2, next == std::string_view::npos
+                                                        ? std::string_view::npos
+                                                        : next - line_end - 2);
+            line_end    = next;
+            auto colon  = line.find(':');
+            if (colon == std::string_view::npos)
+                continue;
+            auto name  = trim(line.substr(0, colon));
+            auto value = trim(line.substr(colon + 1));
+            if (iequals(name, "Content-Length")) {
+                content_length_ = 0;
+                for (char c : value) {
+                    if (c < '0' || c > '9')
+                        throw RpcError("Invalid Content-Length header");
+                    content_length_ = content_length_ * 10 + static_cast<size_t>(c - '0');
+                }
+                has_length = true;
+            } else if (iequals(name, "Transfer-Encoding")) {
+                chunked = icontains(value, "chunked");
+            } else if (iequals(name, "Connection")) {
+                if (iequals(value, "close"))
+                    keep_alive = false;
+                else if (iequals(value, "keep-alive"))
+                    keep_alive = true;
+            }
+        }
+
+        // Error pages are kept for the error message.
+        if (status != 200 && status != 500)
+            sink = nullptr;
+
+        if (chunked) {
+            stage_ = Stage::ChunkSize;
+        } else if (has_length) {
+            body.resize(sink ? std::min(content_length_, kSinkWindow) : content_length_);
+            stage_ = content_length_ ? Stage::Body : Stage::Done;
+        } else {
+            stage_ = Stage::UntilEof; // no framing: the body runs until the server closes
+        }
+    }
+
+    bool advance() {
+        for (;;) {
+            switch (stage_) {
+            case Stage::Headers: {
+                size_t end = buf_.find("\r\n\r\n", pos_);
+                if (end == std::string::npos)
+                    return false;
+                parse_head(std::string_view(buf_).substr(pos_, end - pos_));
+                pos_ = end + 4;
+                break;
+            }
+            case Stage::Body: {
+                size_t take = std::min(content_length_ - body_done(), buf_.size() - pos_);
+                append_body(buf_.data() + pos_, take);
+                pos_ += take;
+                if (body_done() < content_length_) {
+                    compact();
+                    return false;
+                }
+                stage_ = Stage::Done;
+                break;
+            }
+            case Stage::ChunkSize: {
+                auto line = next_line();
+                if (!line) {
+                    compact();
+                    return false;
+                }
+                size_t size = 0;
+                size_t i    = 0;
+                for (; i < line->size(); ++i) {
+                    const char c = (*line)[i];
+                    int        d = (c >= '0' && c <= '9')   ? c - '0'
+                                   : (c >= 'a' && c <= 'f') ? c - 'a' + 10
+                                   : (c >= 'A' && c <= 'F') ? c - 'A' + 10
+                                                            : -1;
+                    if (d < 0)
+                        break;
+                    size = size * 16 + static_cast<size_t>(d);
+                }
+                if (i == 0)
+                    throw RpcError("Invalid chunk size in HTTP response");
+                chunk_left_ = size;
+                stage_      = size ? Stage::ChunkData : Stage::Trailers;
+                break;
+            }
+            case Stage::ChunkData: {
+                size_t take = std::min(chunk_left_, buf_.size() - pos_);
+                append_body(buf_.data() + pos_, take);
+                pos_ += take;
+                chunk_left_ -= take;
+                if (chunk_left_) {
+                    compact();
+                    return false;
+                }
+                stage_ = Stage::ChunkEnd;
+                break;
+            }
+            case Stage::ChunkEnd:
+                if (buf_.size() - pos_ < 2)
+                    return false;
+                pos_ += 2; // CRLF after chunk data
+                stage_ = Stage::ChunkSize;
+                break;
+            case Stage::Trailers: {
+                // Optional trailer headers, terminated by an empty line
+                auto line = next_line();
+                if (!line)
+                    return false;
+                if (line->empty())
+                    stage_ = Stage::Done;
+                break;
+            }
+            case Stage::UntilEof:
+                append_body(buf_.data() + pos_, buf_.size() - pos_);
+                pos_ = buf_.size();
+                compact();
+                return false;
+            case Stage::Done:
+                // Bytes beyond this response mean the stream is out of sync.
+                if (pos_ != buf_.size())
+                    keep_alive = false;
+                body.resize(body_fill_);
+                return true;
+            }
+        }
+    }
+};
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Engine state
+// ---------------------------------------------------------------------------
+struct RpcEngine::Impl {
+    struct Request {
+        std::string       endpoint;
+        std::string       body;
+        bool              is_get = false; // REST: no body, only HTTP 200 succeeds
+        std::string       label;          // method name in RpcStats
+        Completion        done;
+        BodySink          sink;           // optional: the response body is streamed
+        std::string       tee;            // streamed body kept for the recorder
+        RpcCallOptions    options;
+        int               attempts = 0;
+        Clock::time_point deadline{}; // of the current attempt
+
+        // Instrumentation. Every timestamp but `submitted` is per attempt; a
+        // retry starts them over and keeps counting bytes.
+        Clock::time_point submitted{};
+        Clock::time_point queued_at{};
+        Clock::time_point dispatched{};
+        Clock::time_point send_start{}; // connected
+        Clock::time_point sent{};
+        Clock::time_point first_byte{};
+        bool              fresh_conn = false;
+        uint64_t          bytes_out  = 0;
+        uint64_t          bytes_in   = 0;
+
+        [[nodiscard]] std::chrono::milliseconds timeout(const RpcConfig& cfg) const {
+            if (options.timeout.count() > 0)
+                return options.timeout;
+            return std::chrono::seconds(cfg.timeout_seconds);
+        }
+        [[nodiscard]] bool cancelled() const {
+            return options.cancel && options.cancel->cancelled();
+        }
+        // Past the caller's absolute deadline (queued or not).
+        [[nodiscard]] bool overdue(Clock::time_point now) const {
+            return options.deadline != Clock::time_point{} && options.deadline <= now;
+        }
+    };
+
+    struct Slot {
+        // Replaying: holds a request answered from an RpcReplay, without a
+        // socket, until its recorded latency has passed.
+        enum class State { Closed, Connecting, Idle, Sending, Receiving, Replaying };
+
+        State                             state = State::Closed;
+        sock_t                            sock  = kBadSock;
+        std::unique_ptr<Request>          req;
+        std::string                       out;
+        size_t                            out_pos = 0;
+        std::optional<HttpResponseParser> parser;
+        bool                              reused = false;
+        RpcReplayAnswer                   replayed;
+        Clock::time_point                 replay_due{};
+    };
+
+    const RpcConfig config;
+    const int       max_in_flight;
+
+    // Shared so that cancel tokens outliving the engine can still poke it safely.
+    std::shared_ptr<Waker> waker = std::make_shared<Waker>();
+    std::vector<Slot>      slots; // loop thread only
+
+    mutable StdMutex                     mtx;
+    std::deque<std::unique_ptr<Request>> queue GUARDED_BY(mtx);
+    std::map<std::string, RpcQueueDepth> depth GUARDED_BY(mtx); // per RpcCallOptions::tag
+    std::string                          auth_header GUARDED_BY(mtx); // base64(user:password)
+    bool                                 stopping GUARDED_BY(mtx) = false;
+    std::shared_ptr<RpcRecorder>         recorder GUARDED_BY(mtx);
+    std::shared_ptr<RpcReplay>           replay GUARDED_BY(mtx);
+
+    // Copies of `recorder` and `replay` taken once per loop iteration (loop thread only).
+    std::shared_ptr<RpcRecorder> loop_recorder;
+    std::shared_ptr<RpcReplay>   loop_replay;
+
+    std::atomic<int>      next_id{0};
+    std::atomic<uint64_t> fresh{0};
+    std::atomic<uint64_t> reused{0};
+    std::atomic<size_t>   busy{0};
+
+    // Resolved node address, cached across reconnects (loop thread only).
+    std::vector<char> addr;
+    int               addr_family = AF_UNSPEC;
+
+    RpcCache cache;
+    RpcStats stats;
+
+    std::thread loop_thread;
+    std::once_flag shutdown_once;
+
+    Impl(RpcConfig cfg, const RpcAuth& auth, int max)
+        : config(std::move(cfg)), max_in_flight(std::max(1, max)),
+          slots(static_cast<size_t>(max_in_flight)),
+          auth_header(base64(auth.user + ":" + auth.password)) {}
+
+    static std::string base64(const std::string& input);
+
+    void run();
+    void dispatch(std::deque<std::unique_ptr<Request>>& ready);
+    void start_connect(Slot& s);
+    void start_send(Slot& s);
+    void on_writable(Slot& s);
+    void on_readable(Slot& s);
+    void finish(Slot& s);
+    void start_replay(Slot& s);
+    void finish_replay(Slot& s);
+    void close_slot(Slot& s);
+    void fail(Slot& s, const std::string& msg);
+    void fail(Slot& s, std::exception_ptr err);
+    void retry_or_fail(Slot& s, const std::string& msg);
+    void submit(std::unique_ptr<Request> r) EXCLUSIVE_LOCKS_REQUIRED(!mtx);
+    void requeue_front(std::unique_ptr<Request> r) EXCLUSIVE_LOCKS_REQUIRED(!mtx);
+    void release(const Request& r) EXCLUSIVE_LOCKS_REQUIRED(!mtx);
+    void record(const Request& r, bool failed);
+
+    void complete(Request& r, std::exception_ptr err, std::string body) {
+        record(r, err != nullptr);
+        try {
+            r.done(std::move(err), std::move(body));
+        } catch (...) { // NOLINT(bugprone-empty-catch) — a throwing completion must not
+                        // take down the loop thread
+        }
+    }
+
+    [[nodiscard]] std::string target() const {
+        return config.host + ":" + std::to_string(config.port);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// base64 encoder (RFC 4648)
+// ---------------------------------------------------------------------------
+std::string RpcEngine::Impl::base64(const std::string& input) {
+    static const char* chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    std::string out;
+    out.reserve((input.size() + 2) / 3 * 4);
+
+    unsigned char buf[3];
+    int           i = 0;
+
+    for (unsigned char c : input) {
+        buf[i++] = c;
+        if (i == 3) {
+            out += chars[(buf[0] >> 2) & 0x3f];
+            out += chars[((buf[0] & 0x03) << 4) | ((buf[1] >> 4) & 0x0f)];
+            out += chars[((buf[1] & 0x0f) << 2) | ((buf[2] >> 6) & 0x03)];
+            out += chars[buf[2] & 0x3f];
+            i = 0;
+        }
+    }
+    if (i == 1) {
+        out += chars[(buf[0] >> 2) & 0x3f];
+        out += chars[(buf[0] & 0x03) << 4];
+        out += '=';
+        out += '=';
+    } else if (i == 2) {
+        out += chars[(buf[0] >> 2) & 0x3f];
+        out += chars[((buf[0] & 0x03) << 4) | ((buf[1] >> 4) & 0x0f)];
+        out += chars[(buf[1] & 0x0f) << 2];
+        out += '=';
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Connection state machine (loop thread)
+// ---------------------------------------------------------------------------
+void RpcEngine::Impl::close_slot(Slot& s) {
+    if (s.sock != kBadSock)
+        net_close(s.sock);
+    s.sock  = kBadSock;
+    s.state = Slot::State::Closed;
+    s.parser.reset();
+    s.out.clear();
+    s.out_pos = 0;
+}
+
+void RpcEngine::Impl::fail(Slot& s, const std::string& msg) {
+    fail(s, std::make_exception_ptr(RpcError(msg)));
+}
+
+// The connection is closed rather than drained: whatever the node still sends
+// for this request is of no use to anyone.
+void RpcEngine::Impl::fail(Slot& s, std::exception_ptr err) {
+    auto r = std::move(s.req);
+    close_slot(s);
+    if (!r)
+        return;
+    release(*r);
+    complete(*r, std::move(err), {});
+}
+
+// A request leaves its connection: drop it from the in-flight accounting.
+void RpcEngine::Impl::release(const Request& r) {
+    --busy;
+    STDLOCK(mtx);
+    auto it = depth.find(r.options.tag);
+    if (it == depth.end())
+        return;
+    --it->second.in_flight;
+    if (it->second.in_flight == 0 && it->second.queued == 0)
+        depth.erase(it);
+}
+
+// A reused keep-alive socket that dies before any response byte arrived was
+// closed by Bitcoin Core while idle (-rpcservertimeout). Nothing was received,
+// so the request is retried once on a fresh connection; but the node may have
+// run it before closing, so only if it is safe to run twice.
+void RpcEngine::Impl::retry_or_fail(Slot& s, const std::string& msg) {
+    const bool stale = s.reused && !(s.parser && s.parser->started()) && s.req &&
+                       s.req->attempts == 0 && (s.req->is_get || s.req->options.idempotent);
+    if (!stale) {
+        fail(s, msg);
+        return;
+    }
+    auto r = std::move(s.req);
+    ++r->attempts;
+    close_slot(s);
+    release(*r);
+    r->queued_at  = Clock::now();
+    r->dispatched = r->send_start = r->sent = r->first_byte = Clock::time_point{};
+    requeue_front(std::move(r));
+}
+
+// Requests the caller abandoned are left out: their phases say nothing about
+// the node.
+void RpcEngine::Impl::record(const Request& r, bool failed) {
+    if (r.cancelled())
+        return;
+    const auto now  = Clock::now();
+    auto       span = [](Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(to - from);
+    };
+    constexpr Clock::time_point unset{};
+
+    RpcTiming t;
+    t.wall           = span(r.submitted, now);
+    t.bytes_sent     = r.bytes_out;
+    t.bytes_received = r.bytes_in;
+    t.failed         = failed;
+    if (r.dispatched != unset) {
+        t[RpcPhase::Queue] = span(r.queued_at, r.dispatched);
+        if (r.fresh_conn && r.send_start != unset)
+            t[RpcPhase::Connect] = span(r.dispatched, r.send_start);
+    }
+    if (r.sent != unset)
+        t[RpcPhase::Send] = span(r.send_start, r.sent);
+    if (r.first_byte != unset && r.sent != unset) {
+        t[RpcPhase::FirstByte] = span(r.sent, r.first_byte);
+        if (!failed)
+            t[RpcPhase::Body] = span(r.first_byte, now);
+    }
+    stats.record(r.options.tag, r.label, t);
+}
+
+void RpcEngine::Impl::submit(std::unique_ptr<Request> r) {
+    r->submitted = r->queued_at = Clock::now();
+    if (r->cancelled()) {
+        complete(*r, std::make_exception_ptr(RpcCancelled()), {});
+        return;
+    }
+    // Cancelling interrupts poll() so the loop drops the request at once. One
+    // registration per engine and token, however many requests carry it.
+    if (r->options.cancel) {
+        r->options.cancel->on_cancel(this, [w = std::weak_ptr<Waker>(waker)] {
+            if (auto alive = w.lock())
+                alive->notify();
+        });
+    }
+    bool stopped;
+    {
+        STDLOCK(mtx);
+        stopped = stopping;
+        if (!stopped) {
+            ++depth[r->options.tag].queued;
+            queue.push_back(std::move(r));
+        }
+    }
+    if (stopped) {
+        complete(*r, std::make_exception_ptr(RpcError("RPC engine shut down")), {});
+        return;
+    }
+    waker->notify();
+}
+
+void RpcEngine::Impl::requeue_front(std::unique_ptr<Request> r) {
+    STDLOCK(mtx);
+    ++depth[r->options.tag].queued;
+    queue.push_front(std::move(r));
+}
+
+void RpcEngine::Impl::start_connect(Slot& s) {
+    ++fresh;
+    s.reused = false;
+
+    if (addr.empty()) {
+        addrinfo  hints = {};
+        addrinfo* res   = nullptr;
+        hints.ai_family   = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        const std::string port_str = std::to_string(config.port);
+        int err = getaddrinfo(config.host.c_str(), port_str.c_str(), &hints, &res);
+        if (err != 0) {
+            fail(s, "getaddrinfo: " + std::string(gai_strerror(err)));
+            return;
+        }
+        auto* p = reinterpret_cast<const char*>(res->ai_addr);
+        addr.assign(p, p + res->ai_addrlen);
+        addr_family = res->ai_family;
+        freeaddrinfo(res);
+    }
+
+    s.sock = socket(addr_family, SOCK_STREAM, 0);
+    if (s.sock == kBadSock) {
+        fail(s, "socket(): " + safe_strerror(net_errno()));
+        return;
+    }
+    set_nonblocking(s.sock);
+#ifdef SO_NOSIGPIPE
+    int one_nosig = 1;
+    setsockopt(s.sock, SOL_SOCKET, SO_NOSIGPIPE, &one_nosig, sizeof(one_nosig));
+#endif
+    // Requests are written in one go; don't let Nagle hold back the tail.
+    int one = 1;
+    setsockopt(s.sock, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&one), sizeof(one));
+
+    if (::connect(s.sock, reinterpret_cast<const sockaddr*>(addr.data()),
+                  static_cast<int>(addr.size())) == 0) {
+        start_send(s);
+        return;
+    }
+    const int err = net_errno();
+    if (connect_in_progress(err)) {
+        s.state = Slot::State::Connecting;
+        return;
+    }
+    addr.clear(); // re-resolve next time, the node may have moved
+    fail(s, "connect to " + target() + " failed: " + safe_strerror(err));
+}
+
+void RpcEngine::Impl::start_send(Slot& s) {
+    // HTTP/1.1 defaults to keep-alive; the response is framed by Content-Length
+    // (or chunked encoding), so the socket stays open for the next request.
+    Request&    r = *s.req;
+    std::string auth_header;
+    {
+        STDLOCK(mtx);
+        auth_header = this->auth_header;
+    }
+    // Written into the slot's buffer, which keeps its capacity from one
+    // request on this socket to the next.
+    s.out.clear();
+    s.out += r.is_get ? "GET " : "POST ";
+    s.out += r.endpoint;
+    s.out += " HTTP/1.1\r\nHost: ";
+    s.out += config.host;
+    s.out += "\r\nAuthorization: Basic ";
+    s.out += auth_header;
+    if (!r.is_get) {
+        s.out += "\r\nContent-Type: application/json\r\nContent-Length: ";
+        s.out += std::to_string(r.body.size());
+    }
+    s.out += "\r\n\r\n";
+    s.out += r.body; // empty for a GET
+    s.out_pos    = 0;
+    r.send_start = Clock::now();
+    s.parser.emplace();
+    if (r.sink && loop_recorder) {
+        s.parser->sink = [&r](std::string_view bytes) {
+            r.tee.append(bytes);
+            r.sink(bytes);
+        };
+    } else {
+        s.parser->sink = r.sink;
+    }
+    s.state = Slot::State::Sending;
+    on_writable(s);
+}
+
+void RpcEngine::Impl::on_writable(Slot& s) {
+    if (s.state == Slot::State::Connecting) {
+        int       err = 0;
+        socklen_t len = sizeof(err);
+        getsockopt(s.sock, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&err), &len);
+        if (err != 0) {
+            addr.clear();
+            fail(s, "connect to " + target() + " failed: " + safe_strerror(err));
+            return;
+        }
+        start_send(s);
+        return;
+    }
+    while (s.out_pos < s.out.size()) {
+        io_sz_t n = send(s.sock, s.out.data() + s.out_pos,
+                         static_cast<int>(s.out.size() - s.out_pos), kSendFlags);
+        if (n > 0) {
+            s.out_pos += static_cast<size_t>(n);
+            s.req->bytes_out += static_cast<uint64_t>(n);
+            continue;
+        }
+        const int err = net_errno();
+        if (n < 0 && would_block(err))
+            return; // wait for POLLOUT
+        if (is_reset_errno(err))
+            retry_or_fail(s, "Empty response from Bitcoin Core — " + safe_strerror(err));
+        else
+            fail(s, "send() failed: " + safe_strerror(err));
+        return;
+    }
+    s.out.clear();
+    s.req->sent = Clock::now();
+    s.state     = Slot::State::Receiving;
+}
+
+void RpcEngine::Impl::on_readable(Slot& s) {
+    // Cap a single recv() so the Windows int length can't overflow.
+    constexpr size_t kMaxRecv = size_t{1} << 20;
+    for (;;) {
+        // Responses are read straight into the parser's buffers. An idle socket
+        // only ever yields EOF or junk, so a one-byte probe is enough there.
+        char            probe = 0;
+        std::span<char> into  = s.state == Slot::State::Receiving ? s.parser->prepare()
+                                                                  : std::span<char>(&probe, 1);
+        io_sz_t         n     = recv(s.sock, into.data(), std::min(into.size(), kMaxRecv), 0);
+        if (n > 0) {
+            if (s.state != Slot::State::Receiving) {
+                close_slot(s); // unsolicited bytes on an idle socket: out of sync
+                return;
+            }
+            if (s.req->first_byte == Clock::time_point{})
+                s.req->first_byte = Clock::now();
+            s.req->bytes_in += static_cast<uint64_t>(n);
+            bool done = false;
+            try {
+                done = s.parser->commit(static_cast<size_t>(n));
+            } catch (const std::exception& e) {
+                fail(s, e.what());
+                return;
+            }
+            if (done) {
+                finish(s);
+                return;
+            }
+            continue;
+        }
+        const int err = n < 0 ? net_errno() : 0;
+        if (n < 0 && would_block(err))
+            return;
+        if (s.state == Slot::State::Idle) {
+            close_slot(s); // the node dropped an idle keep-alive socket
+            return;
+        }
+        if (n == 0) {
+            if (s.parser->finish_at_eof()) {
+                finish(s);
+            } else if (!s.parser->started()) {
+                retry_or_fail(s, "Empty response from Bitcoin Core — connection closed before "
+                                 "any data was sent");
+            } else {
+                fail(s, "Connection closed mid-response");
+            }
+            return;
+        }
+        if (is_reset_errno(err))
+            retry_or_fail(s, "Empty response from Bitcoin Core — " + safe_strerror(err));
+        else
+            fail(s, "recv() failed: " + safe_strerror(err));
+        return;
+    }
+}
+
+// The error an HTTP status stands for, or null when `body` is the answer.
+static std::exception_ptr status_error(int status, const std::string& body, bool is_get) {
+    if (status == 401) {
+        return std::make_exception_ptr(RpcHttpError(
+            401, "Authentication failed (HTTP 401) — check your RPC credentials"));
+    }
+    if (status != 200 && (status != 500 || is_get)) {
+        // 500 is also used by Bitcoin Core for RPC-level errors; body still contains JSON
+        std::string detail = body.substr(0, 200);
+        if (detail.size() == 200)
+            detail += "…";
+        return std::make_exception_ptr(RpcHttpError(
+            status, "HTTP " + std::to_string(status) + ": " + detail, body.substr(0, 200)));
+    }
+    return nullptr;
+}
+
+void RpcEngine::Impl::finish(Slot& s) {
+    auto               r     = std::move(s.req);
+    HttpResponseParser p     = std::move(*s.parser);
+    const bool         keep  = p.keep_alive;
+    s.parser.reset();
+    release(*r);
+    if (keep)
+        s.state = Slot::State::Idle;
+    else
+        close_slot(s);
+
+    if (loop_recorder && !r->cancelled()) {
+        const auto   now = Clock::now();
+        std::string& raw = r->tee.empty() ? p.body : r->tee; // the tee if streamed
+        RpcExchange  ex;
+        ex.is_get   = r->is_get;
+        ex.tag      = r->options.tag;
+        ex.endpoint = r->endpoint;
+        ex.request  = r->body;
+        ex.status   = p.status;
+        ex.response = std::move(raw);
+        ex.offset   = std::chrono::duration_cast<std::chrono::microseconds>(
+            r->submitted - loop_recorder->started());
+        ex.duration = std::chrono::duration_cast<std::chrono::microseconds>(now - r->send_start);
+        loop_recorder->record(ex);
+        raw = std::move(ex.response);
+    }
+
+    std::exception_ptr err = status_error(p.status, p.body, r->is_get);
+    complete(*r, err, err ? std::string{} : std::move(p.body));
+}
+
+// Stands in for connect + send: the answer is known at once and handed over
+// when its recorded latency has passed (see run()).
+void RpcEngine::Impl::start_replay(Slot& s) {
+    close_slot(s); // keep-alive socket from before replay_from()
+    Request& r   = *s.req;
+    r.send_start = r.sent = Clock::now();
+    r.bytes_out  = r.body.size();
+    s.replayed   = loop_replay->answer(r.is_get, r.endpoint, r.body);
+    s.replay_due = r.sent + s.replayed.delay;
+    s.state      = Slot::State::Replaying;
+}
+
+void RpcEngine::Impl::finish_replay(Slot& s) {
+    auto            r = std::move(s.req);
+    RpcReplayAnswer a = std::move(s.replayed);
+    s.state           = Slot::State::Closed;
+    release(*r);
+    r->first_byte = Clock::now();
+    r->bytes_in   = a.body.size();
+
+    std::exception_ptr err = status_error(a.status, a.body, r->is_get);
+    if (!err && r->sink) {
+        try {
+            r->sink(a.body);
+        } catch (const std::exception& e) {
+            err = std::make_exception_ptr(RpcError(e.what()));
+        }
+        a.body.clear();
+    }
+    complete(*r, err, err ? std::string{} : std::move(a.body));
+}
+
+void RpcEngine::Impl::dispatch(std::deque<std::unique_ptr<Request>>& ready) {
+    // Prefer sockets that are already open, then open new ones up to the cap.
+    for (auto want : {Slot::State::Idle, Slot::State::Closed}) {
+        for (auto& s : slots) {
+            if (ready.empty())
+                return;
+            if (s.state != want)
+                continue;
+            s.req = std::move(ready.front());
+            ready.pop_front();
+            s.req->dispatched = Clock::now();
+            s.req->fresh_conn = want == Slot::State::Closed;
+            s.req->deadline   = s.req->dispatched + s.req->timeout(config);
+            if (s.req->options.deadline != Clock::time_point{})
+                s.req->deadline = std::min(s.req->deadline, s.req->options.deadline);
+            ++busy;
+            if (loop_replay) {
+                start_replay(s);
+            } else if (want == Slot::State::Idle) {
+                ++reused;
+                s.reused = true;
+                start_send(s);
+            } else {
+                start_connect(s);
+            }
+        }
+    }
+}
+
+void RpcEngine::Impl::run() {
+    std::vector<pollfd> fds;
+    std::vector<Slot*>  fd_slots;
+
+    for (;;) {
+        std::deque<std::unique_ptr<Request>>  ready;
+        std::vector<std::unique_ptr<Request>> dropped; // cancelled or overdue while queued
+        auto                                  next_deadline = Clock::time_point::max();
+        {
+            STDLOCK(mtx);
+            if (stopping)
+                break;
+            loop_recorder  = recorder;
+            loop_replay    = replay;
+            const auto now = Clock::now();
+            for (auto it = queue.begin(); it != queue.end();) {
+                if ((*it)->cancelled() || (*it)->overdue(now)) {
+                    --depth[(*it)->options.tag].queued;
+                    dropped.push_back(std::move(*it));
+                    it = queue.erase(it);
+                    continue;
+                }
+                if ((*it)->options.deadline != Clock::time_point{})
+                    next_deadline = std::min(next_deadline, (*it)->options.deadline);
+                ++it;
+            }
+            std::erase_if(depth, [](const auto& kv) {
+                return kv.second.queued == 0 && kv.second.in_flight == 0;
+            });
+            size_t free_slots = static_cast<size_t>(std::count_if(
+                slots.begin(), slots.end(), [](const Slot& s) {
+                    return s.state == Slot::State::Idle || s.state == Slot::State::Closed;
+                }));
+            while (free_slots-- > 0 && !queue.empty()) {
+                auto& d = depth[queue.front()->options.tag];
+                --d.queued;
+                ++d.in_flight;
+                ready.push_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+        }
+        for (auto& r : dropped) {
+            complete(*r,
+                     r->cancelled() ? std::make_exception_ptr(RpcCancelled())
+                                    : std::make_exception_ptr(RpcError(
+                                          "RPC timeout — deadline passed while queued")),
+                     {});
+        }
+        dispatch(ready);
+        if (!ready.empty()) {
+            // Defensive: never drop work if dispatch could not place it.
+            STDLOCK(mtx);
+            while (!ready.empty()) {
+                auto& d = depth[ready.back()->options.tag];
+                ++d.queued;
+                --d.in_flight;
+                queue.push_front(std::move(ready.back()));
+                ready.pop_back();
+            }
+        }
+
+        fds.clear();
+        fd_slots.clear();
+        fds.push_back({waker->fd(), POLLIN, 0});
+        fd_slots.push_back(nullptr);
+        for (auto& s : slots) {
+            short events = 0;
+            switch (s.state) {
+            case Slot::State::Closed:
+                continue;
+            case Slot::State::Replaying:
+                next_deadline = std::min({next_deadline, s.replay_due, s.req->deadline});
+                continue;
+            case Slot::State::Connecting:
+            case Slot::State::Sending:
+                events = POLLOUT;
+                break;
+            case Slot::State::Idle:
+            case Slot::State::Receiving:
+                events = POLLIN;
+                break;
+            }
+            if (s.req)
+                next_deadline = std::min(next_deadline, s.req->deadline);
+            fds.push_back({s.sock, events, 0});
+            fd_slots.push_back(&s);
+        }
+
+        int timeout_ms = -1;
+        if (next_deadline != Clock::time_point::max()) {
+            auto left  = std::chrono::ceil<std::chrono::milliseconds>(next_deadline - Clock::now());
+            timeout_ms = static_cast<int>(std::max<int64_t>(0, left.count()));
+        }
+
+        int rc = net_poll(fds.data(), fds.size(), timeout_ms);
+        if (rc < 0 && net_errno() != EINTR)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+        if (rc > 0) {
+            if (fds[0].revents)
+                waker->drain();
+            for (size_t i = 1; i < fds.size(); ++i) {
+                const short re = fds[i].revents;
+                Slot&       s  = *fd_slots[i];
+                if (!re || s.sock != fds[i].fd)
+                    continue;
+                if (re & (POLLIN | POLLHUP | POLLERR)) {
+                    if (s.state == Slot::State::Connecting || s.state == Slot::State::Sending)
+                        on_writable(s); // surfaces the connect/send error
+                    else
+                        on_readable(s);
+                } else if (re & POLLOUT) {
+                    on_writable(s);
+                }
+            }
+        }
+
+        const auto now = Clock::now();
+        for (auto& s : slots) {
+            if (!s.req)
+                continue;
+            if (s.state == Slot::State::Replaying && s.replay_due <= now &&
+                !s.req->cancelled() && s.req->deadline > now)
+                finish_replay(s);
+            else if (s.req->cancelled())
+                fail(s, std::make_exception_ptr(RpcCancelled()));
+            else if (s.req->overdue(now))
+                fail(s, "RPC timeout — deadline passed before Bitcoin Core responded");
+            else if (s.req->deadline <= now)
+                fail(s, "RPC timeout — Bitcoin Core did not respond within " +
+                            format_timeout(s.req->timeout(config)));
+        }
+    }
+
+    // Shutdown: fail everything still pending.
+    std::deque<std::unique_ptr<Request>> leftover;
+    {
+        STDLOCK(mtx);
+        leftover.swap(queue);
+        for (const auto& r : leftover)
+            --depth[r->options.tag].queued;
+        std::erase_if(depth, [](const auto& kv) {
+            return kv.second.queued == 0 && kv.second.in_flight == 0;
+        });
+    }
+    for (auto& s : slots) {
+        if (s.req)
+            fail(s, "RPC engine shut down");
+        close_slot(s);
+    }
+    for (auto& r : leftover)
+        complete(*r, std::make_exception_ptr(RpcError("RPC engine shut down")), {});
+}
+
+// ---------------------------------------------------------------------------
+// Public interface
+// ---------------------------------------------------------------------------
+RpcEngine::RpcEngine(RpcConfig config, RpcAuth auth, int max_in_flight) {
+    ensure_winsock();
+    impl_              = std::make_unique<Impl>(std::move(config), auth, max_in_flight);
+    impl_->loop_thread = std::thread([impl = impl_.get()] { impl->run(); });
+}
+
+RpcEngine::~RpcEngine() { shutdown(); }
+
+void RpcEngine::shutdown() {
+    std::call_once(impl_->shutdown_once, [this] {
+        {
+            STDLOCK(impl_->mtx);
+            impl_->stopping = true;
+        }
+        impl_->waker->notify();
+        impl_->loop_thread.join();
+    });
+}
+
+void RpcEngine::set_auth(const RpcAuth& auth) {
+    std::string header = Impl::base64(auth.user + ":" + auth.password);
+    STDLOCK(impl_->mtx);
+    impl_->auth_header = std::move(header);
+}
+
+void RpcEngine::record_to(std::shared_ptr<RpcRecorder> recorder) {
+    STDLOCK(impl_->mtx);
+    impl_->recorder = std::move(recorder);
+}
+
+void RpcEngine::replay_from(std::shared_ptr<RpcReplay> replay) {
+    {
+        STDLOCK(impl_->mtx);
+        impl_->replay = std::move(replay);
+    }
+    impl_->waker->notify();
+}
+
+void RpcEngine::post(std::string endpoint, std::string body, Completion done,
+                     RpcCallOptions options, std::string label) {
+    post(std::move(endpoint), std::move(body), BodySink{}, std::move(done), std::move(options),
+         std::move(label));
+}
+
+void RpcEngine::post(std::string endpoint, std::string body, BodySink sink, Completion done,
+                     RpcCallOptions options, std::string label) {
+    auto r      = std::make_unique<Impl::Request>();
+    r->label    = label.empty() ? "POST " + endpoint : std::move(label);
+    r->endpoint = std::move(endpoint);
+    r->body     = std::move(body);
+    r->done     = std::move(done);
+    r->sink     = std::move(sink);
+    r->options  = std::move(options);
+    impl_->submit(std::move(r));
+}
+
+std::future<std::string> RpcEngine::post(std::string endpoint, std::string body,
+                                         RpcCallOptions options, std::string label) {
+    auto promise = std::make_shared<std::promise<std::string>>();
+    auto fut     = promise->get_future();
+    post(std::move(endpoint), std::move(body),
+         [promise](std::exception_ptr err, std::string resp) {
+             if (err)
+                 promise->set_exception(err);
+             else
+                 promise->set_value(std::move(resp));
+         },
+         std::move(options), std::move(label));
+    return fut;
+}
+
+// "/rest/block/<hash>.bin" -> "rest/block": one stats row per endpoint, not per object.
+static std::string rest_label(std::string_view endpoint) {
+    constexpr std::string_view prefix = "/rest/";
+    if (!endpoint.starts_with(prefix))
+        return "GET " + std::string(endpoint);
+    auto name = endpoint.substr(prefix.size());
+    return "rest/" + std::string(name.substr(0, name.find_first_of("/.?")));
+}
+
+void RpcEngine::get(std::string endpoint, Completion done, RpcCallOptions options) {
+    auto r      = std::make_unique<Impl::Request>();
+    r->label    = rest_label(endpoint);
+    r->endpoint = std::move(endpoint);
+    r->is_get   = true;
+    r->done     = std::move(done);
+    r->options  = std::move(options);
+    impl_->submit(std::move(r));
+}
+
+std::future<std::string> RpcEngine::get(std::string endpoint, RpcCallOptions options) {
+    auto promise = std::make_shared<std::promise<std::string>>();
+    auto fut     = promise->get_future();
+    get(std::move(endpoint),
+        [promise](std::exception_ptr err, std::string resp) {
+            if (err)
+                promise->set_exception(err);
+            else
+                promise->set_value(std::move(resp));
+        },
+        std::move(options));
+    return fut;
+}
+
+int RpcEngine::reserve_ids(int n) { return impl_->next_id.fetch_add(n) + 1; }
+
+RpcConnectionStats RpcEngine::connection_stats() const {
+    return {impl_->fresh.load(), impl_->reused.load()};
+}
+
+size_t RpcEngine::in_flight() const { return impl_->busy.load(); }
+
+size_t RpcEngine::queued() const {
+    STDLOCK(impl_->mtx);
+    return impl_->queue.size();
+}
+
+int RpcEngine::max_in_flight() const { return impl_->max_in_flight; }
+
+RpcCache& RpcEngine::cache() { return impl_->cache; }
+
+RpcStats& RpcEngine::stats() { return impl_->stats; }
+
+std::map<std::string, RpcQueueDepth> RpcEngine::queue_depth() const {
+    STDLOCK(impl_->mtx);
+    return impl_->depth;
+}
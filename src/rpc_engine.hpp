@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "rpc_cache.hpp"
+#include "rpc_client.hpp"
+#include "rpc_stats.hpp"
+
+class RpcRecorder;
+class RpcReplay;
+
+// Outstanding work for one RpcCallOptions::tag.
+struct RpcQueueDepth {
+    size_t queued    = 0; // waiting for a free connection
+    size_t in_flight = 0; // sent, awaiting the response
+};
+
+// Asynchronous HTTP transport for JSON-RPC.
+//
+// One event-loop thread multiplexes a small pool of non-blocking keep-alive
+// sockets with poll(). Each socket carries one request at a time; requests
+// beyond the pool size wait in a FIFO queue, so `max_in_flight` caps the load
+// a single TUI puts on the node regardless of how many callers submit work.
+//
+// Completions run on the engine thread: they must not block, and must never
+// wait on another request of the same engine (that would deadlock the loop).
+class RpcEngine {
+  public:
+    // Exactly one of `error` (non-null) or `body` is meaningful.
+    using Completion = std::function<void(std::exception_ptr error, std::string body)>;
+    // Receives a streamed response body piece by piece, on the engine thread.
+    using BodySink = std::function<void(std::string_view bytes)>;
+
+    RpcEngine(RpcConfig config, RpcAuth auth, int max_in_flight = 4);
+    ~RpcEngine(); // calls shutdown()
+
+    RpcEngine(const RpcEngine&)            = delete;
+    RpcEngine& operator=(const RpcEngine&) = delete;
+
+    // Queue an HTTP POST of `body` to `endpoint`. The response body (HTTP 200, or
+    // 500 which Bitcoin Core uses for RPC-level errors) is handed to `done`;
+    // other statuses fail with RpcHttpError. `label` names the request in stats()
+    // (the JSON-RPC method); it defaults to "POST <endpoint>".
+    void                     post(std::string endpoint, std::string body, Completion done,
+                                  RpcCallOptions options = {}, std::string label = {});
+    std::future<std::string> post(std::string endpoint, std::string body,
+                                  RpcCallOptions options = {}, std::string label = {});
+
+    // As post(), but a 200 or 500 response body is handed to `sink` as it comes
+    // off the socket instead of being buffered, and `done` gets an empty body.
+    // A sink that throws fails the request with RpcError. The request is only
+    // retried while nothing has been received, so the sink never sees a byte
+    // twice.
+    void post(std::string endpoint, std::string body, BodySink sink, Completion done,
+              RpcCallOptions options = {}, std::string label = {});
+
+    // Queue an HTTP GET of `endpoint` (Bitcoin Core's REST interface). Only HTTP
+    // 200 succeeds; any other status fails with RpcHttpError. Recorded in stats()
+    // as "rest/<endpoint>", e.g. "rest/block".
+    void                     get(std::string endpoint, Completion done,
+                                 RpcCallOptions options = {});
+    std::future<std::string> get(std::string endpoint, RpcCallOptions options = {});
+
+    // Credentials for requests sent from now on (e.g. after a cookie refresh).
+    void set_auth(const RpcAuth& auth);
+
+    // Append every HTTP exchange completed from now on to `recorder`; nullptr
+    // stops recording. Cancelled requests and transport failures are left out.
+    void record_to(std::shared_ptr<RpcRecorder> recorder);
+
+    // Answer requests dispatched from now on from `replay` instead of the node,
+    // without opening a socket; nullptr goes back to the node. The pool size,
+    // queueing, timeouts, cancellation and stats() work as they do live.
+    void replay_from(std::shared_ptr<RpcReplay> replay);
+
+    // Stop the loop thread, failing anything still queued or in flight with
+    // RpcError. Every completion has run by the time this returns; later posts
+    // fail immediately. Idempotent.
+    void shutdown();
+
+    // JSON-RPC ids are unique per engine, so clients sharing it never collide.
+    // Returns the first of `n` consecutive ids.
+    [[nodiscard]] int reserve_ids(int n = 1);
+
+    [[nodiscard]] RpcConnectionStats connection_stats() const;
+    [[nodiscard]] size_t             in_flight() const;
+    [[nodiscard]] size_t             queued() const;
+    [[nodiscard]] int                max_in_flight() const;
+
+    // Per-tag breakdown of queued() and in_flight(); tags with no work are omitted.
+    [[nodiscard]] std::map<std::string, RpcQueueDepth> queue_depth() const;
+
+    // Coalescing / TTL cache shared by every RpcClient on this engine.
+    [[nodiscard]] RpcCache& cache();
+
+    // Latency and payload size of every request, by tag and method.
+    [[nodiscard]] RpcStats& stats();
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
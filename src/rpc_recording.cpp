@@ -0,0 +1,255 @@
+#include "rpc_recording.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <utility>
+
+#include "rpc_client.hpp"
+
+static constexpr std::string_view kMagic   = "bitcoin-tui-rpc-recording";
+static constexpr int              kVersion = 1;
+
+// A larger length in a record header is corruption, not a response.
+static constexpr size_t kMaxField = size_t{1} << 30;
+
+// ---------------------------------------------------------------------------
+// File format
+// ---------------------------------------------------------------------------
+void write_rpc_session_header(std::ostream& out) {
+    const auto unix_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             std::chrono::system_clock::now().time_since_epoch())
+                             .count();
+    out << kMagic << ' ' << kVersion << ' ' << unix_ms << '\n';
+}
+
+void write_rpc_exchange(std::ostream& out, const RpcExchange& ex) {
+    out << (ex.is_get ? 'G' : 'P') << ' ' << ex.offset.count() << ' ' << ex.duration.count()
+        << ' ' << ex.status << ' ' << ex.tag.size() << ' ' << ex.endpoint.size() << ' '
+        << ex.request.size() << ' ' << ex.response.size() << '\n';
+    out << ex.tag << ex.endpoint << ex.request << ex.response << '\n';
+}
+
+std::vector<RpcExchange> read_rpc_recording(std::istream& in) {
+    std::vector<RpcExchange> out;
+    std::string              line;
+    auto                     read_field = [&in](std::string& s, size_t n) {
+        s.resize(n);
+        in.read(s.data(), static_cast<std::streamsize>(n));
+        return static_cast<size_t>(in.gcount()) == n;
+    };
+    while (std::getline(in, line)) {
+        if (in.eof())
+            break; // header line cut short
+        std::istringstream hdr(line);
+        if (line.starts_with(kMagic)) {
+            std::string magic;
+            int         version = 0;
+            hdr >> magic >> version;
+            if (version != kVersion)
+                throw RpcError("Unsupported RPC recording version " + std::to_string(version));
+            continue;
+        }
+        RpcExchange ex;
+        char        kind = 0;
+        int64_t     offset_us = 0, duration_us = 0;
+        size_t      tag_len = 0, endpoint_len = 0, request_len = 0, response_len = 0;
+        hdr >> kind >> offset_us >> duration_us >> ex.status >> tag_len >> endpoint_len >>
+            request_len >> response_len;
+        if (!hdr || (kind != 'P' && kind != 'G') || tag_len > kMaxField ||
+            endpoint_len > kMaxField || request_len > kMaxField || response_len > kMaxField)
+            throw RpcError("Malformed RPC recording: unexpected line \"" + line.substr(0, 60) +
+                           "\"");
+        ex.is_get   = kind == 'G';
+        ex.offset   = std::chrono::microseconds(offset_us);
+        ex.duration = std::chrono::microseconds(duration_us);
+        if (!read_field(ex.tag, tag_len) || !read_field(ex.endpoint, endpoint_len) ||
+            !read_field(ex.request, request_len) || !read_field(ex.response, response_len))
+            break;
+        const int end = in.get();
+        if (end == std::char_traits<char>::eof())
+            break;
+        if (end != '\n')
+            throw RpcError("Malformed RPC recording: record longer than its header says");
+        out.push_back(std::move(ex));
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// RpcRecorder
+// ---------------------------------------------------------------------------
+RpcRecorder::RpcRecorder(const std::string& path) {
+    STDLOCK(mtx_);
+    out_.open(path, std::ios::binary | std::ios::app);
+    if (!out_)
+        throw RpcError("Cannot open RPC recording file: " + path);
+    write_rpc_session_header(out_);
+    out_.flush();
+}
+
+void RpcRecorder::record(const RpcExchange& ex) {
+    STDLOCK(mtx_);
+    write_rpc_exchange(out_, ex);
+    out_.flush();
+    ++count_;
+}
+
+uint64_t RpcRecorder::count() const {
+    STDLOCK(mtx_);
+    return count_;
+}
+
+// ---------------------------------------------------------------------------
+// RpcReplay
+// ---------------------------------------------------------------------------
+// "<endpoint>\n<method>\n<params>": ids left out, params in canonical form.
+static std::string call_key(const std::string& endpoint, const json& call) {
+    return endpoint + '\n' + call.value("method", "") + '\n' +
+           (call.contains("params") ? call["params"].dump() : "[]");
+}
+
+RpcReplay::RpcReplay(const std::vector<RpcExchange>& exchanges, double speed) : speed_(speed) {
+    STDLOCK(mtx_);
+    for (const auto& ex : exchanges) {
+        if (ex.is_get) {
+            rest_[ex.endpoint].items.push_back({ex.status, ex.response, ex.duration});
+            has_rest_ = true;
+            ++calls_;
+            continue;
+        }
+        // Only replies carrying JSON-RPC: 200, or 500 for an RPC-level error.
+        if (ex.status != 200 && ex.status != 500)
+            continue;
+        json req, resp;
+        try {
+            req  = json::parse(ex.request);
+            resp = json::parse(ex.response);
+        } catch (const json::exception&) {
+            continue;
+        }
+        auto add = [&](const json& call, const json& reply) {
+            replies_[call_key(ex.endpoint, call)].items.push_back(
+                {reply["result"].dump(), reply["error"].dump(), ex.duration});
+            ++calls_;
+        };
+        if (!req.is_array()) {
+            add(req, resp);
+            continue;
+        }
+        // Batch replies come in any order; a malformed batch gets one error
+        // object for all of its calls.
+        std::map<std::string, const json*> by_id;
+        if (resp.is_array()) {
+            for (const auto& reply : resp)
+                by_id[reply["id"].dump()] = &reply;
+        }
+        for (const auto& call : req) {
+            if (!resp.is_array()) {
+                add(call, resp);
+            } else if (auto it = by_id.find(call["id"].dump()); it != by_id.end()) {
+                add(call, *it->second);
+            }
+        }
+    }
+}
+
+std::shared_ptr<RpcReplay> RpcReplay::load(const std::string& path, double speed) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        throw RpcError("Cannot open RPC recording file: " + path);
+    auto replay = std::make_shared<RpcReplay>(read_rpc_recording(in), speed);
+    if (replay->calls() == 0)
+        throw RpcError("RPC recording has no replayable calls: " + path);
+    return replay;
+}
+
+std::chrono::microseconds RpcReplay::scaled(std::chrono::microseconds d) const {
+    if (speed_ <= 0.0)
+        return std::chrono::microseconds{0};
+    return std::chrono::microseconds(
+        std::llround(static_cast<double>(d.count()) / speed_));
+}
+
+// One JSON-RPC response object for `call`, under the id the caller used.
+std::string RpcReplay::reply_json(const std::string& endpoint, const json& call,
+                                  std::chrono::microseconds& delay, bool& failed) {
+    std::string out = R"({"result":)";
+    auto        it  = replies_.find(call_key(endpoint, call));
+    if (it == replies_.end()) {
+        ++misses_;
+        failed = true;
+        out += R"(null,"error":)";
+        out += json({{"code", -32601},
+                     {"message", "Not in RPC recording: " + call.value("method", "")}})
+                   .dump();
+    } else {
+        const Reply& r = it->second.take();
+        delay          = std::max(delay, r.duration);
+        failed         = failed || r.error != "null";
+        out += r.result;
+        out += R"(,"error":)";
+        out += r.error;
+    }
+    out += R"(,"id":)";
+    out += call["id"].dump();
+    out += '}';
+    return out;
+}
+
+RpcReplayAnswer RpcReplay::answer(bool is_get, const std::string& endpoint,
+                                  std::string_view request) {
+    STDLOCK(mtx_);
+    RpcReplayAnswer a;
+    if (is_get) {
+        auto it = rest_.find(endpoint);
+        if (it == rest_.end()) {
+            ++misses_;
+            a.status = 404;
+            // A recording without any REST traffic came from a node without
+            // -rest: answer with the same bare 404, so RestClient falls back to
+            // JSON-RPC as it did then.
+            if (has_rest_)
+                a.body = "Not in RPC recording: " + endpoint + "\r\n";
+            return a;
+        }
+        const Rest& r = it->second.take();
+        a.status      = r.status;
+        a.body        = r.body;
+        a.delay       = scaled(r.duration);
+        return a;
+    }
+
+    json req;
+    try {
+        req = json::parse(request);
+    } catch (const json::exception&) {
+        a.status = 500;
+        a.body   = R"({"result":null,"error":{"code":-32700,"message":"Parse error"},"id":null})";
+        return a;
+    }
+    std::chrono::microseconds delay{0};
+    bool                      failed = false;
+    if (req.is_array()) {
+        a.body = "[";
+        for (const auto& call : req) {
+            if (a.body.size() > 1)
+                a.body += ',';
+            a.body += reply_json(endpoint, call, delay, failed);
+        }
+        a.body += ']';
+    } else {
+        a.body = reply_json(endpoint, req, delay, failed);
+        if (failed)
+            a.status = 500; // as Bitcoin Core answers a failed single call
+    }
+    a.delay = scaled(delay);
+    return a;
+}
+
+uint64_t RpcReplay::misses() const {
+    STDLOCK(mtx_);
+    return misses_;
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "json.hpp"
+#include "thread_safety.hpp"
+
+// Recording and offline replay of the HTTP traffic an RpcEngine exchanges with
+// the node, so the TUI can be profiled against a real node's answers without
+// the node.
+//
+// A recording is an append-only file of framed records, each a one-line text
+// header followed by the raw bytes it announces (REST bodies are binary):
+//
+//   bitcoin-tui-rpc-recording 1 <unix ms>               one per session
+//   P|G <offset µs> <duration µs> <status> <tag len> <endpoint len> <request len> <response len>
+//   <tag><endpoint><request><response>\n
+//
+// `offset` is when the request was submitted, from the start of the session;
+// `duration` runs from sending it to the last byte of the response.
+
+// One request/response pair. `is_get` marks REST requests (no request body).
+struct RpcExchange {
+    bool                      is_get = false;
+    std::string               tag; // RpcCallOptions::tag of the caller
+    std::string               endpoint;
+    std::string               request;
+    int                       status = 200;
+    std::string               response;
+    std::chrono::microseconds offset{0};
+    std::chrono::microseconds duration{0};
+};
+
+void write_rpc_session_header(std::ostream& out);
+void write_rpc_exchange(std::ostream& out, const RpcExchange& ex);
+
+// Every complete record of a recording. A record cut short at the end (the
+// recording process died mid-write) is ignored; anything else malformed throws
+// RpcError.
+[[nodiscard]] std::vector<RpcExchange> read_rpc_recording(std::istream& in);
+
+// Appends exchanges to a recording file, flushing each so a crash loses at most
+// the one being written. Thread-safe.
+class RpcRecorder {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit RpcRecorder(const std::string& path); // throws RpcError if it cannot be opened
+
+    void record(const RpcExchange& ex) EXCLUSIVE_LOCKS_REQUIRED(!mtx_);
+
+    // Session start: the origin of RpcExchange::offset.
+    [[nodiscard]] Clock::time_point started() const { return started_; }
+    [[nodiscard]] uint64_t          count() const EXCLUSIVE_LOCKS_REQUIRED(!mtx_);
+
+  private:
+    const Clock::time_point started_ = Clock::now();
+    mutable StdMutex        mtx_;
+    std::ofstream           out_ GUARDED_BY(mtx_);
+    uint64_t                count_ GUARDED_BY(mtx_) = 0;
+};
+
+// What a replayed request is answered with, and after how long.
+struct RpcReplayAnswer {
+    int                       status = 200;
+    std::string               body;
+    std::chrono::microseconds delay{0};
+};
+
+// Serves a recording back in place of the node.
+//
+// JSON-RPC calls are matched by endpoint, method and params, one call at a
+// time: batches are split on load and reassembled on replay, so a batch
+// whose composition differs from the recorded one (some elements served from
+// the cache this time) still finds every answer, under the ids of the new
+// request. A call recorded several times gets its answers in recorded order,
+// then keeps getting the last one. REST requests are matched by endpoint.
+//
+// Each answer is delayed by its recorded duration divided by `speed`; a speed
+// of 0 answers at once. Calls missing from the recording get a JSON-RPC error.
+class RpcReplay {
+  public:
+    explicit RpcReplay(const std::vector<RpcExchange>& exchanges, double speed = 1.0);
+
+    // Read and index a recording file. Throws RpcError.
+    [[nodiscard]] static std::shared_ptr<RpcReplay> load(const std::string& path,
+                                                         double             speed = 1.0);
+
+    [[nodiscard]] RpcReplayAnswer answer(bool is_get, const std::string& endpoint,
+                                         std::string_view request) EXCLUSIVE_LOCKS_REQUIRED(!mtx_);
+
+    [[nodiscard]] size_t   calls() const { return calls_; } // recorded calls and REST requests
+    [[nodiscard]] uint64_t misses() const EXCLUSIVE_LOCKS_REQUIRED(!mtx_);
+
+  private:
+    struct Reply {
+        std::string               result; // raw JSON
+        std::string               error;  // raw JSON, "null" on success
+        std::chrono::microseconds duration{0};
+    };
+    struct Rest {
+        int                       status = 200;
+        std::string               body;
+        std::chrono::microseconds duration{0};
+    };
+    template <typename T> struct Track {
+        std::vector<T> items;
+        size_t         next = 0;
+
+        const T& take() {
+            const T& item = items[next];
+            if (next + 1 < items.size())
+                ++next;
+            return item;
+        }
+    };
+
+    [[nodiscard]] std::chrono::microseconds scaled(std::chrono::microseconds d) const;
+    [[nodiscard]] std::string reply_json(const std::string& endpoint, const json& call,
+                                         std::chrono::microseconds& delay, bool& failed)
+        EXCLUSIVE_LOCKS_REQUIRED(mtx_);
+
+    const double                        speed_;
+    size_t                              calls_    = 0;
+    bool                                has_rest_ = false;
+    mutable StdMutex                    mtx_;
+    std::map<std::string, Track<Reply>> replies_ GUARDED_BY(mtx_); // endpoint \n method \n params
+    std::map<std::string, Track<Rest>>  rest_ GUARDED_BY(mtx_);    // endpoint
+    uint64_t                            misses_ GUARDED_BY(mtx_) = 0;
+};
@@ -0,0 +1,138 @@
+#include "rpc_stats.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <vector>
+
+#include "format.hpp"
+
+const char* rpc_phase_name(RpcPhase phase) {
+    switch (phase) {
+    case RpcPhase::Queue:
+        return "queue";
+    case RpcPhase::Connect:
+        return "connect";
+    case RpcPhase::Send:
+        return "send";
+    case RpcPhase::FirstByte:
+        return "ttfb";
+    case RpcPhase::Body:
+        return "body";
+    case RpcPhase::Parse:
+        return "parse";
+    }
+    return "?";
+}
+
+// ============================================================================
+// LatencyHistogram
+// ============================================================================
+
+void LatencyHistogram::add(std::chrono::microseconds sample) {
+    const auto   us     = static_cast<uint64_t>(std::max<int64_t>(0, sample.count()));
+    const size_t bucket = us < 2 ? 0 : static_cast<size_t>(std::bit_width(us)) - 1;
+    ++buckets_[std::min(bucket, kBuckets - 1)];
+    ++count_;
+    total_ += sample;
+    max_    = std::max(max_, sample);
+}
+
+std::chrono::microseconds LatencyHistogram::percentile(double q) const {
+    if (count_ == 0)
+        return std::chrono::microseconds{0};
+    const auto want = static_cast<uint64_t>(std::ceil(q * static_cast<double>(count_)));
+    uint64_t   seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+        seen += buckets_[i];
+        if (seen < std::max<uint64_t>(want, 1))
+            continue;
+        if (i == kBuckets - 1)
+            break; // the last bucket has no upper bound
+        return std::min(max_, std::chrono::microseconds{int64_t{2} << i});
+    }
+    return max_;
+}
+
+// ============================================================================
+// RpcStats
+// ============================================================================
+
+void RpcStats::record(const std::string& caller, const std::string& method,
+                      const RpcTiming& timing) {
+    STDLOCK(mtx_);
+    RpcMethodStats& st = stats_[{caller, method}];
+    ++st.calls;
+    if (timing.failed)
+        ++st.errors;
+    st.bytes_sent += timing.bytes_sent;
+    st.bytes_received += timing.bytes_received;
+    st.wall.add(timing.wall);
+    for (size_t i = 0; i < kRpcPhases; ++i) {
+        if (timing.phases[i])
+            st.phases[i].add(*timing.phases[i]);
+    }
+}
+
+void RpcStats::record_parse(const std::string& caller, const std::string& method,
+                            std::chrono::microseconds elapsed) {
+    STDLOCK(mtx_);
+    stats_[{caller, method}].phases[static_cast<size_t>(RpcPhase::Parse)].add(elapsed);
+}
+
+std::map<RpcStats::Key, RpcMethodStats> RpcStats::snapshot() const {
+    STDLOCK(mtx_);
+    return stats_;
+}
+
+void RpcStats::reset() {
+    STDLOCK(mtx_);
+    stats_.clear();
+}
+
+std::string RpcStats::report() const {
+    const auto snap = snapshot();
+
+    std::vector<const std::pair<const Key, RpcMethodStats>*> rows;
+    for (const auto& kv : snap)
+        rows.push_back(&kv);
+    std::ranges::sort(rows, [](const auto* a, const auto* b) {
+        return a->second.wall.total() > b->second.wall.total();
+    });
+
+    size_t caller_w = 6, method_w = 6;
+    for (const auto* r : rows) {
+        caller_w = std::max(caller_w, r->first.first.size());
+        method_w = std::max(method_w, r->first.second.size());
+    }
+
+    // Pads to `w` columns; "µs" is two bytes but one column.
+    auto pad = [](std::string s, size_t w) {
+        const auto cols = static_cast<size_t>(
+            std::ranges::count_if(s, [](char c) { return (c & 0xC0) != 0x80; }));
+        if (cols < w)
+            s.append(w - cols, ' ');
+        return s;
+    };
+    auto col = [&](const std::string& s) { return pad(s, 12); };
+
+    std::string out = pad("caller", caller_w + 2) + pad("method", method_w + 2) +
+                      pad("calls", 8) + pad("errors", 8) + col("p50") + col("p90") +
+                      col("max");
+    for (size_t i = 0; i < kRpcPhases; ++i)
+        out += col(std::string(rpc_phase_name(static_cast<RpcPhase>(i))) + " p50");
+    out += col("sent") + "received\n";
+
+    for (const auto* r : rows) {
+        const auto& [key, st] = *r;
+        out += pad(key.first.empty() ? "other" : key.first, caller_w + 2) +
+               pad(key.second, method_w + 2) + pad(std::to_string(st.calls), 8) +
+               pad(std::to_string(st.errors), 8) + col(fmt_latency(st.wall.percentile(0.5))) +
+               col(fmt_latency(st.wall.percentile(0.9))) + col(fmt_latency(st.wall.max()));
+        for (const auto& h : st.phases)
+            out += col(h.count() ? fmt_latency(h.percentile(0.5)) : "-");
+        out += col(fmt_bytes(static_cast<int64_t>(st.bytes_sent))) +
+               fmt_bytes(static_cast<int64_t>(st.bytes_received)) + "\n";
+    }
+    return out;
+}
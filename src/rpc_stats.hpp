@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "thread_safety.hpp"
+
+// Where the time of one RPC goes, in order. Queue is spent waiting for a free
+// connection (raise --rpc-connections); FirstByte is the node working on the
+// request (raise -rpcthreads, or call it less); Body and Parse grow with the
+// size of the reply.
+enum class RpcPhase { Queue, Connect, Send, FirstByte, Body, Parse };
+inline constexpr size_t kRpcPhases = 6;
+
+[[nodiscard]] const char* rpc_phase_name(RpcPhase phase);
+
+// Log2-bucketed latency histogram: bucket i counts samples below 2^(i+1) µs,
+// so percentiles are exact to within a factor of two in constant space.
+class LatencyHistogram {
+  public:
+    static constexpr size_t kBuckets = 25; // up to ~33s; slower samples land in the last
+
+    void add(std::chrono::microseconds sample);
+
+    [[nodiscard]] uint64_t                  count() const { return count_; }
+    [[nodiscard]] std::chrono::microseconds total() const { return total_; }
+    [[nodiscard]] std::chrono::microseconds max() const { return max_; }
+    // Upper bound of the bucket holding the q-quantile (0 < q <= 1), capped at max().
+    [[nodiscard]] std::chrono::microseconds percentile(double q) const;
+
+  private:
+    std::array<uint64_t, kBuckets> buckets_{};
+    uint64_t                       count_ = 0;
+    std::chrono::microseconds      total_{0};
+    std::chrono::microseconds      max_{0};
+};
+
+// What the engine measured for one request. Phases that did not happen (e.g.
+// Connect on a reused socket, or everything after a failed send) are empty.
+struct RpcTiming {
+    std::array<std::optional<std::chrono::microseconds>, kRpcPhases> phases;
+    std::chrono::microseconds                                        wall{0}; // submitted to done
+    uint64_t                                                         bytes_sent     = 0;
+    uint64_t                                                         bytes_received = 0;
+    bool                                                             failed         = false;
+
+    std::optional<std::chrono::microseconds>& operator[](RpcPhase p) {
+        return phases[static_cast<size_t>(p)];
+    }
+};
+
+struct RpcMethodStats {
+    uint64_t                                 calls          = 0;
+    uint64_t                                 errors         = 0;
+    uint64_t                                 bytes_sent     = 0;
+    uint64_t                                 bytes_received = 0;
+    LatencyHistogram                         wall; // submitted to fully received
+    std::array<LatencyHistogram, kRpcPhases> phases;
+
+    [[nodiscard]] const LatencyHistogram& phase(RpcPhase p) const {
+        return phases[static_cast<size_t>(p)];
+    }
+};
+
+// Per-caller, per-method RPC instrumentation. The caller is the submitter's
+// RpcCallOptions::tag ("poll", "Mempool", a Lua tab's name); the method is the
+// JSON-RPC method, "[a,b,…]" for a batch, or "rest/<endpoint>" for REST.
+// RpcEngine records transport phases; RpcClient adds the parse time.
+class RpcStats {
+  public:
+    using Key = std::pair<std::string, std::string>; // (caller, method)
+
+    void record(const std::string& caller, const std::string& method, const RpcTiming& timing)
+        EXCLUSIVE_LOCKS_REQUIRED(!mtx_);
+    void record_parse(const std::string& caller, const std::string& method,
+                      std::chrono::microseconds elapsed) EXCLUSIVE_LOCKS_REQUIRED(!mtx_);
+
+    [[nodiscard]] std::map<Key, RpcMethodStats> snapshot() const EXCLUSIVE_LOCKS_REQUIRED(!mtx_);
+    void                                        reset() EXCLUSIVE_LOCKS_REQUIRED(!mtx_);
+
+    // Plain-text table of snapshot(), slowest callers/methods (by total time) first.
+    [[nodiscard]] std::string report() const EXCLUSIVE_LOCKS_REQUIRED(!mtx_);
+
+  private:
+    mutable StdMutex              mtx_;
+    std::map<Key, RpcMethodStats> stats_ GUARDED_BY(mtx_);
+};
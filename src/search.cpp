@@ -1,22 +1,74 @@
 #include "search.hpp"
 #include "format.hpp"
 
+#include <optional>
+#include <utility>
+
+// ============================================================================
+// Block lookup over REST — one binary download replaces getblock plus the
+// getrawtransaction for the coinbase (which needs -txindex for old blocks).
+// Returns false when the block cannot be placed on the active chain (stale, or
+// below BIP34 so the height is not committed), leaving JSON-RPC to answer.
+// ============================================================================
+static bool fetch_block_rest(RestClient& rest, const std::string& hash,
+                             std::optional<int64_t> height, TxSearchState& result) {
+    const auto id = Hash256::from_hex(hash);
+    if (!id)
+        return false;
+    const std::string raw = rest.block(hash);
+    const Block       blk = decode_block(raw);
+    if (blk.txs.empty() || blk.txs[0].vin.empty())
+        return false;
+    const TxIn& coinbase = blk.txs[0].vin[0];
+
+    if (!height) {
+        height = bip34_height(coinbase.script_sig);
+        if (!height || rest.blockhash_by_height(*height) != id->hex())
+            return false;
+    }
+    // Counted against the node's tip, as getblock does, not the last one polled
+    const int64_t tip = rest.block_count();
+    if (tip < *height)
+        return false;
+
+    result.blk_hash          = id->hex();
+    result.blk_height        = *height;
+    result.blk_time          = blk.header.time;
+    result.blk_ntx           = static_cast<int64_t>(blk.txs.size());
+    result.blk_size          = static_cast<int64_t>(blk.size);
+    result.blk_weight        = blk.weight();
+    result.blk_difficulty    = difficulty_from_bits(blk.header.bits);
+    result.blk_confirmations = tip - *height + 1;
+    result.blk_miner         = extract_miner(to_hex(coinbase.script_sig));
+    return true;
+}
+
 // ============================================================================
-// Transaction / block lookup — pure: takes config + query, returns result.
+// Transaction / block lookup — pure: takes a client + query, returns result.
 // No shared state, no threads, no UI side-effects. Suitable for testing.
 // ============================================================================
-TxSearchState perform_tx_search(const RpcConfig& cfg, const RpcAuth& auth, const std::string& query,
-                                bool query_is_height, int64_t tip) {
+TxSearchState perform_tx_search(RpcClient& search_rpc, const std::string& query,
+                                bool query_is_height, int64_t tip, RestClient* rest) {
     TxSearchState result;
     result.txid = query;
     try {
-        RpcConfig search_cfg       = cfg;
-        search_cfg.timeout_seconds = 5;
-        RpcClient search_rpc(search_cfg, auth);
-
-        // Helper: populate result with block data from getblock (verbosity 1)
-        auto fetch_block = [&](const std::string& hash) {
-            auto blk                 = search_rpc.call("getblock", {json(hash), json(1)})["result"];
+        // Helper: populate result with block data, over REST when the node serves
+        // it, otherwise from getblock (verbosity 1)
+        auto fetch_block = [&](const std::string& hash, std::optional<int64_t> height) {
+            if (rest && rest->available()) {
+                try {
+                    if (fetch_block_rest(*rest, hash, height, result)) {
+                        result.is_block = true;
+                        result.found    = true;
+                        return;
+                    }
+                } catch (...) { // NOLINT(bugprone-empty-catch) — fall back to JSON-RPC
+                }
+            }
+            // Read on demand: of the reply only a few fields and the first of
+            // its (up to thousands of) txids are wanted.
+            const std::string  text  = search_rpc.call_text("getblock", {json(hash), json(1)});
+            const json::cursor blk   = json::cursor(text)["result"];
             result.blk_hash          = blk.value("hash", hash);
             result.blk_height        = blk.value("height", 0LL);
             result.blk_time          = blk.value("time", 0LL);
@@ -26,14 +78,14 @@ TxSearchState perform_tx_search(const RpcConfig& cfg, const RpcAuth& auth, const
             result.blk_difficulty    = blk.value("difficulty", 0.0);
             result.blk_confirmations = blk.value("confirmations", 0LL);
             // Extract miner tag from coinbase scriptSig
-            if (blk.contains("tx") && blk["tx"].is_array() && !blk["tx"].empty()) {
-                std::string coinbase_txid = blk["tx"][0].get<std::string>();
+            if (const json::cursor txs = blk["tx"]; txs.is_array() && !txs.empty()) {
+                std::string coinbase_txid = txs[0].get<std::string>();
                 try {
-                    auto coinbase_tx = search_rpc.call("getrawtransaction",
-                                                       {json(coinbase_txid), json(true)})["result"];
-                    if (coinbase_tx.contains("vin") && coinbase_tx["vin"].is_array() &&
-                        !coinbase_tx["vin"].empty()) {
-                        std::string cb_hex = coinbase_tx["vin"][0].value("coinbase", "");
+                    const std::string cb_text = search_rpc.call_text(
+                        "getrawtransaction", {json(coinbase_txid), json(true)});
+                    const json::cursor vin = json::cursor(cb_text)["result"]["vin"];
+                    if (vin.is_array() && !vin.empty()) {
+                        std::string cb_hex = vin[0].value("coinbase", "");
                         result.blk_miner   = extract_miner(cb_hex);
                     }
                 } catch (...) {
@@ -47,18 +99,29 @@ TxSearchState perform_tx_search(const RpcConfig& cfg, const RpcAuth& auth, const
         if (query_is_height) {
             // Block height search: getblockhash → getblock
             int64_t     height = std::stoll(query);
-            auto        hash_r = search_rpc.call("getblockhash", {height})["result"];
-            std::string hash   = hash_r.get<std::string>();
-            fetch_block(hash);
+            std::string hash;
+            if (rest && rest->available()) {
+                try {
+                    hash = rest->blockhash_by_height(height);
+                } catch (...) { // NOLINT(bugprone-empty-catch) — getblockhash reports the error
+                }
+            }
+            if (hash.empty()) {
+                const json reply = search_rpc.call("getblockhash", {height});
+                hash             = reply["result"].get<std::string>();
+            }
+            fetch_block(hash, height);
         } else {
             // 1. Try mempool first
             try {
-                auto entry = search_rpc.call("getmempoolentry", {query})["result"];
+                const json  reply = search_rpc.call("getmempoolentry", {query});
+                const json& entry = reply["result"];
 
-                if (entry.contains("fees") && entry["fees"].is_object())
-                    result.fee = entry["fees"].value("base", 0.0);
-                else
-                    result.fee = entry.value("fee", 0.0);
+                // Fees in exact satoshis; `fee` is the pre-v0.21 field.
+                const json&   fee      = entry["fees"].is_object() ? entry["fees"]["base"]
+                                                                   : entry["fee"];
+                const int64_t fee_sats = fee.is_number() ? fee.get_sats() : 0;
+                result.fee             = static_cast<double>(fee_sats) / 1e8;
 
                 result.vsize       = entry.value("vsize", 0LL);
                 result.weight      = entry.value("weight", 0LL);
@@ -66,14 +129,16 @@ TxSearchState perform_tx_search(const RpcConfig& cfg, const RpcAuth& auth, const
                 result.descendants = entry.value("descendantcount", 0LL);
                 result.entry_time  = entry.value("time", 0LL);
                 if (result.vsize > 0)
-                    result.fee_rate = result.fee * 1e8 / static_cast<double>(result.vsize);
+                    result.fee_rate =
+                        static_cast<double>(fee_sats) / static_cast<double>(result.vsize);
                 result.confirmed = false;
                 result.found     = true;
             } catch (...) {
                 // 2. Try confirmed tx (requires txindex=1)
                 try {
-                    auto tx =
-                        search_rpc.call("getrawtransaction", {json(query), json(true)})["result"];
+                    const std::string tx_text =
+                        search_rpc.call_text("getrawtransaction", {json(query), json(true)});
+                    const json::cursor tx = json::cursor(tx_text)["result"];
 
                     result.vsize         = tx.value("vsize", 0LL);
                     result.weight        = tx.value("weight", 0LL);
@@ -84,39 +149,20 @@ TxSearchState perform_tx_search(const RpcConfig& cfg, const RpcAuth& auth, const
                     if (tip > 0 && result.confirmations > 0)
                         result.block_height = tip - result.confirmations + 1;
 
-                    if (tx.contains("vin") && tx["vin"].is_array()) {
-                        for (const auto& inp : tx["vin"]) {
-                            TxVin v;
-                            if (inp.contains("coinbase")) {
-                                v.is_coinbase = true;
-                            } else {
-                                v.txid = inp.value("txid", "");
-                                v.vout = inp.value("vout", 0);
-                            }
-                            result.vin_list.push_back(v);
-                        }
-                        result.vin_count = static_cast<int>(result.vin_list.size());
-                    }
-                    if (tx.contains("vout") && tx["vout"].is_array()) {
-                        for (const auto& out : tx["vout"]) {
-                            TxVout v;
-                            v.value = out.value("value", 0.0);
-                            if (out.contains("scriptPubKey")) {
-                                const auto& spk = out["scriptPubKey"];
-                                v.type          = spk.value("type", "");
-                                if (spk.contains("address"))
-                                    v.address = spk.value("address", "");
-                            }
-                            result.total_output += v.value;
-                            result.vout_list.push_back(v);
-                        }
-                        result.vout_count = static_cast<int>(result.vout_list.size());
-                    }
-                    result.confirmed = true;
-                    result.found     = true;
+                    result.vin_list   = json_bind_array<TxVin>(tx["vin"]);
+                    result.vin_count  = static_cast<int>(result.vin_list.size());
+                    result.vout_list  = json_bind_array<TxVout>(tx["vout"]);
+                    result.vout_count = static_cast<int>(result.vout_list.size());
+
+                    int64_t total_sats = 0;
+                    for (const TxVout& v : result.vout_list)
+                        total_sats += v.sats;
+                    result.total_output = static_cast<double>(total_sats) / 1e8;
+                    result.confirmed    = true;
+                    result.found        = true;
                 } catch (...) {
                     // 3. Fall back: try as block hash
-                    fetch_block(query);
+                    fetch_block(query, std::nullopt);
                 }
             }
         }
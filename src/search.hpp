@@ -2,10 +2,13 @@
 
 #include <cstdint>
 
+#include "rest_client.hpp"
 #include "rpc_client.hpp"
 #include "state.hpp"
 
 // Pure transaction/block lookup — no shared state, no UI side-effects.
 // query_is_height: true when query is a decimal block height string.
-TxSearchState perform_tx_search(const RpcConfig& cfg, const RpcAuth& auth, const std::string& query,
-                                bool query_is_height, int64_t tip);
+// rest: optional REST fast path for block lookups; JSON-RPC is used whenever it
+// is null, disabled on the node, or cannot answer.
+TxSearchState perform_tx_search(RpcClient& rpc, const std::string& query, bool query_is_height,
+                                int64_t tip, RestClient* rest = nullptr);
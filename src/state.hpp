@@ -6,6 +6,8 @@
 #include <string>
 #include <vector>
 
+#include "json.hpp"
+
 // ============================================================================
 // Block animation parameters
 // ============================================================================
@@ -16,11 +18,24 @@ static constexpr int BLOCK_ANIM_TOTAL_FRAMES = BLOCK_ANIM_SLIDE_FRAMES;
 // Application state (shared between render thread and RPC polling thread)
 // ============================================================================
 struct BlockStat {
-    int64_t height       = 0;
-    int64_t txs          = 0;
-    int64_t total_size   = 0;
-    int64_t total_weight = 0;
-    int64_t time         = 0;
+    int64_t     height       = 0;
+    int64_t     txs          = 0;
+    int64_t     total_size   = 0; // excluding the coinbase, as getblockstats reports it
+    int64_t     total_weight = 0; // likewise
+    int64_t     time         = 0;
+    std::string hash;             // lets a later poll reuse stats for an unchanged block
+};
+
+// One getblockstats result.
+template <> struct json_binding<BlockStat> {
+    static constexpr std::array fields = {
+        json_member<&BlockStat::height>("height"),
+        json_member<&BlockStat::txs>("txs"),
+        json_member<&BlockStat::total_size>("total_size"),
+        json_member<&BlockStat::total_weight>("total_weight"),
+        json_member<&BlockStat::time>("time"),
+        json_member<&BlockStat::hash>("blockhash"),
+    };
 };
 
 struct PeerInfo {
@@ -44,6 +59,48 @@ struct PeerInfo {
     double      min_ping_ms    = -1.0;
 };
 
+// One element of getpeerinfo.
+template <> struct json_binding<PeerInfo> {
+    static constexpr std::array fields = {
+        json_member<&PeerInfo::id>("id"),
+        json_member<&PeerInfo::addr>("addr"),
+        json_member<&PeerInfo::network>("network"),
+        json_field<PeerInfo>{"servicesnames",
+                             [](PeerInfo& p, const json& v) {
+                                 if (!v.is_array())
+                                     return;
+                                 p.services.clear();
+                                 for (const auto& name : v) {
+                                     if (!p.services.empty())
+                                         p.services += ", ";
+                                     p.services += name.get<std::string>();
+                                 }
+                             }},
+        json_member<&PeerInfo::bytes_sent>("bytessent"),
+        json_member<&PeerInfo::bytes_recv>("bytesrecv"),
+        json_member<&PeerInfo::conntime>("conntime"),
+        json_field<PeerInfo>{"pingtime",
+                             [](PeerInfo& p, const json& v) {
+                                 if (v.is_number())
+                                     p.ping_ms = v.get<double>() * 1000.0;
+                             }},
+        json_field<PeerInfo>{"minping",
+                             [](PeerInfo& p, const json& v) {
+                                 if (v.is_number())
+                                     p.min_ping_ms = v.get<double>() * 1000.0;
+                             }},
+        json_member<&PeerInfo::version>("version"),
+        json_member<&PeerInfo::subver>("subver"),
+        json_member<&PeerInfo::inbound>("inbound"),
+        json_member<&PeerInfo::bip152_hb_to>("bip152_hb_to"),
+        json_member<&PeerInfo::bip152_hb_from>("bip152_hb_from"),
+        json_member<&PeerInfo::synced_blocks>("synced_blocks"),
+        json_member<&PeerInfo::addr_processed>("addr_processed"),
+        json_member<&PeerInfo::connection_type>("connection_type"),
+        json_member<&PeerInfo::transport>("transport_protocol_type"),
+    };
+};
+
 struct AppState {
     // Blockchain
     std::string chain      = "—";
@@ -115,18 +172,72 @@ struct SoftFork {
     int64_t bip9_threshold = 0;
 };
 
+// One deployment of getdeploymentinfo; `name` is the key it is listed under.
+template <> struct json_binding<SoftFork> {
+    static constexpr std::array fields = {
+        json_member<&SoftFork::type>("type"),
+        json_member<&SoftFork::active>("active"),
+        json_member<&SoftFork::height>("height"),
+        json_field<SoftFork>{"bip9",
+                             [](SoftFork& f, const json& v) {
+                                 if (!v.is_object())
+                                     return;
+                                 f.bip9_status         = v.value("status", "");
+                                 f.bip9_since          = v.value("since", 0LL);
+                                 f.bip9_start_time     = v.value("start_time", 0LL);
+                                 f.bip9_timeout        = v.value("timeout", 0LL);
+                                 f.bip9_min_activation = v.value("min_activation_height", 0LL);
+                                 const json& stats     = v["statistics"];
+                                 f.bip9_elapsed        = stats.value("elapsed", 0LL);
+                                 f.bip9_count          = stats.value("count", 0LL);
+                                 f.bip9_period         = stats.value("period", 0LL);
+                                 f.bip9_threshold      = stats.value("threshold", 0LL);
+                             }},
+    };
+};
+
 struct TxVin {
     std::string txid;
     int         vout        = 0;
     bool        is_coinbase = false;
 };
 
+// One vin element of a verbose getrawtransaction.
+template <> struct json_binding<TxVin> {
+    static constexpr std::array fields = {
+        json_member<&TxVin::txid>("txid"),
+        json_member<&TxVin::vout>("vout"),
+        json_field<TxVin>{"coinbase", [](TxVin& in, const json&) { in.is_coinbase = true; }},
+    };
+};
+
 struct TxVout {
-    double      value = 0.0;
-    std::string address; // may be empty for non-standard scripts
+    int64_t     sats  = 0;   // exact amount; sum these, not value
+    double      value = 0.0; // BTC, for display
+    std::string address;     // may be empty for non-standard scripts
     std::string type;    // scriptPubKey type
 };
 
+// One vout element of a verbose getrawtransaction.
+template <> struct json_binding<TxVout> {
+    static constexpr std::array fields = {
+        json_field<TxVout>{"value",
+                           [](TxVout& out, const json& v) {
+                               if (!v.is_number())
+                                   return;
+                               out.sats  = v.get_sats();
+                               out.value = static_cast<double>(out.sats) / 1e8;
+                           }},
+        json_field<TxVout>{"scriptPubKey",
+                           [](TxVout& out, const json& v) {
+                               if (!v.is_object())
+                                   return;
+                               out.type    = v.value("type", "");
+                               out.address = v.value("address", "");
+                           }},
+    };
+};
+
 struct TxSearchState {
     std::string txid;
     bool        searching = false;
@@ -5,9 +5,9 @@
 
 using namespace ftxui;
 
-DashboardTab::DashboardTab(RpcConfig cfg, Guarded<RpcAuth>& auth, App& screen,
+DashboardTab::DashboardTab(std::shared_ptr<RpcEngine> rpc_engine, App& screen,
                            std::atomic<bool>& running, Guarded<AppState>& state, int refresh_secs)
-    : Tab(std::move(cfg), auth, screen, running, state, refresh_secs) {}
+    : Tab(std::move(rpc_engine), screen, running, state, refresh_secs) {}
 
 FooterSpec DashboardTab::footer_buttons(const AppState& snap) {
     return FooterSpec{{refresh_btn(snap)}};
@@ -8,7 +8,7 @@
 
 class DashboardTab : public Tab {
   public:
-    DashboardTab(RpcConfig cfg, Guarded<RpcAuth>& auth, ftxui::App& screen,
+    DashboardTab(std::shared_ptr<RpcEngine> rpc_engine, ftxui::App& screen,
                  std::atomic<bool>& running, Guarded<AppState>& state, int refresh_secs);
     ~DashboardTab() override = default;
 
@@ -8,6 +8,7 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <ftxui/ftxui.hpp>
@@ -26,6 +27,7 @@ extern "C" {
 #include "components/qr_item.hpp"
 #include "components/qr_overlay.hpp"
 #include "format.hpp"
+#include "lua_json.hpp"
 #include "luatable.hpp"
 #include "paths.hpp"
 #include "render.hpp"
@@ -69,16 +71,19 @@ static const std::set<std::string> DEFAULT_RPC_ALLOWLIST = {
     "uptime",
 };
 
-struct RpcRequest {
-    int                        id;
-    std::string                method;
-    json                       params;
-    std::optional<std::string> wallet; // empty = regular RPC, set = wallet RPC
-};
+// getblock with transactions decoded (verbosity 2 or 3): megabytes, cached
+// under a key nothing but the tab that asked for it shares.
+static bool large_result(const std::string& method, const json& params) {
+    if (method != "getblock" || !params.is_array() || params.size() < 2)
+        return false;
+    const json& verbosity = params[1];
+    return verbosity.is_number_integer() && verbosity.get<int64_t>() >= 2;
+}
 
 struct RpcResponse {
     int         id;
-    json        result;
+    json        result; // from a reply the RpcCache keeps: a handle into its document
+    std::string reply;  // otherwise the whole reply text, parsed straight into Lua
     std::string error;
 };
 
@@ -202,34 +207,6 @@ inline int field_or(const lb::LuaRef& t, const char* key, int def) {
     return def;
 }
 
-// Push a json value onto L's stack as the equivalent Lua value.
-static void push_json(lua_State* L, const json& j) {
-    if (j.is_bool())
-        lua_pushboolean(L, j.get<bool>());
-    else if (j.is_number_integer())
-        lua_pushinteger(L, static_cast<lua_Integer>(j.get<int64_t>()));
-    else if (j.is_number_float())
-        lua_pushnumber(L, j.get<double>());
-    else if (j.is_string()) {
-        auto s = j.get<std::string>();
-        lua_pushlstring(L, s.data(), s.size());
-    } else if (j.is_array()) {
-        lua_createtable(L, static_cast<int>(j.size()), 0);
-        for (size_t i = 0; i < j.size(); ++i) {
-            push_json(L, j[i]);
-            lua_rawseti(L, -2, static_cast<lua_Integer>(i) + 1);
-        }
-    } else if (j.is_object()) {
-        lua_createtable(L, 0, static_cast<int>(j.size()));
-        for (auto& [k, v] : j.items()) {
-            push_json(L, v);
-            lua_setfield(L, -2, k.c_str());
-        }
-    } else {
-        lua_pushnil(L);
-    }
-}
-
 class LuaScript {
   public:
     LuaScript();
@@ -1067,39 +1044,6 @@ void LuaTab::register_lua_api(LuaScript& script) {
         });
 }
 
-void LuaTab::rpc_thread_fn(WaitableGuarded<std::deque<RpcRequest>>&  requests,
-                           WaitableGuarded<std::deque<RpcResponse>>& responses) {
-    while (running_ && !stopped_) {
-        auto req =
-            requests.access_when([&](auto& q) { return !q.empty() || !running_ || stopped_; },
-                                 [](auto& q) -> std::optional<RpcRequest> {
-                                     if (q.empty())
-                                         return std::nullopt;
-                                     auto r = std::move(q.front());
-                                     q.pop_front();
-                                     return r;
-                                 });
-        if (!req)
-            continue;
-
-        RpcResponse resp{req->id, {}, {}};
-        try {
-            RpcClient rpc(cfg_, auth_);
-            json      rpc_result;
-            if (!req->wallet.has_value()) {
-                rpc_result = rpc.call(req->method, req->params);
-            } else {
-                rpc_result = rpc.call_wallet(*req->wallet, req->method, req->params);
-            }
-            resp.result = rpc_result["result"];
-        } catch (const std::exception& e) {
-            resp.error = e.what();
-        }
-
-        responses.update_and_notify([&](auto& q) { q.push_back(std::move(resp)); });
-    }
-}
-
 // Read an RPC params array (a Lua table at absolute stack index `idx` on `co`)
 // into json, preserving the integer/float distinction via the Lua number subtype.
 static json extract_rpc_params(lua_State* co, int idx) {
@@ -1133,17 +1077,18 @@ void LuaTab::lua_thread_fn(std::unique_ptr<LuaScript> script) {
     auto&      log_watches = script->log_watches();
     auto&      timers      = script->timers();
 
-    WaitableGuarded<std::deque<RpcRequest>>  requests;
-    WaitableGuarded<std::deque<RpcResponse>> responses;
-    int                                      next_rpc_id = 0;
-    auto&                                    pending     = script->pending();
-
-    std::thread rpc_thread(&LuaTab::rpc_thread_fn, this, std::ref(requests), std::ref(responses));
+    // RPCs go to the shared engine; their completions land here. Shared so that a
+    // reply arriving after this thread has exited still has somewhere to go.
+    auto      responses   = std::make_shared<WaitableGuarded<std::deque<RpcResponse>>>();
+    int       next_rpc_id = 0;
+    auto&     pending     = script->pending();
+    RpcClient rpc         = rpc_client({}, rpc_cancel_);
+    // stop() cancels the token; wake the sleep in step 5 so the loop sees it.
+    rpc_cancel_->on_cancel(this, [responses] { responses->update_and_notify([](auto&) {}); });
 
     // Everything below runs under an exception barrier: a C++ exception escaping
-    // this thread function would call std::terminate (the joinable rpc_thread above
-    // is destroyed mid-unwind), aborting the whole app with "terminate called
-    // without an active exception". Instead, surface the error and shut down cleanly.
+    // this thread function would call std::terminate, aborting the whole app.
+    // Instead, surface the error and shut down cleanly.
     try {
         // Open debug.log, seek back by max backlog
         int64_t max_backlog = 0;
@@ -1168,8 +1113,38 @@ void LuaTab::lua_thread_fn(std::unique_ptr<LuaScript> script) {
         auto submit_rpc = [&](const std::string& method, json params,
                               std::optional<std::string> wallet = std::nullopt) -> int {
             int id = ++next_rpc_id;
-            requests.update_and_notify(
-                [&](auto& q) { q.push_back({id, method, std::move(params), std::move(wallet)}); });
+            // Replies the cache keeps are shared documents, pushed from the tree.
+            // Anything else, and large results the cache would keep for this
+            // tab alone, comes as text and is parsed straight into Lua tables
+            // on this thread, so it never exists as a tree at all.
+            if (!wallet && rpc.engine()->cache().keeps(method) && !large_result(method, params)) {
+                rpc.call_async(method, params, [responses, id](std::exception_ptr err, const json& reply) {
+                    RpcResponse resp{id, {}, {}, {}};
+                    try {
+                        if (err)
+                            std::rethrow_exception(err);
+                        resp.result = reply.share(reply["result"]);
+                    } catch (const std::exception& e) {
+                        resp.error = e.what();
+                    }
+                    responses->update_and_notify([&](auto& q) { q.push_back(std::move(resp)); });
+                });
+                return id;
+            }
+            auto done = [responses, id](std::exception_ptr err, std::string reply) {
+                RpcResponse resp{id, {}, std::move(reply), {}};
+                try {
+                    if (err)
+                        std::rethrow_exception(err);
+                } catch (const std::exception& e) {
+                    resp.error = e.what();
+                }
+                responses->update_and_notify([&](auto& q) { q.push_back(std::move(resp)); });
+            };
+            if (wallet)
+                rpc.call_wallet_text_async(*wallet, method, params, std::move(done));
+            else
+                rpc.call_text_async(method, params, std::move(done));
             return id;
         };
 
@@ -1364,7 +1339,7 @@ void LuaTab::lua_thread_fn(std::unique_ptr<LuaScript> script) {
             }
 
             // 2. Collect RPC responses and resume waiting coroutines
-            auto resp_queue = responses.update([](auto& q) { return std::exchange(q, {}); });
+            auto resp_queue = responses->update([](auto& q) { return std::exchange(q, {}); });
             for (auto& resp : resp_queue) {
                 auto it = pending.find(resp.id);
                 if (it == pending.end())
@@ -1374,9 +1349,19 @@ void LuaTab::lua_thread_fn(std::unique_ptr<LuaScript> script) {
                 // Resume the coroutine with (value, err): push both onto its stack.
                 lua_settop(pc.co, 0);
                 if (resp.error.empty()) {
-                    push_json(pc.co, resp.result);
-                    lua_pushnil(pc.co);
-                } else {
+                    try {
+                        if (resp.reply.empty())
+                            push_json(pc.co, resp.result);
+                        else
+                            push_json_result(pc.co, resp.reply);
+                        lua_pushnil(pc.co);
+                    } catch (const json::exception& e) {
+                        resp.error = "JSON parse error: " + std::string(e.what());
+                    }
+                    std::string().swap(resp.reply); // only the Lua value is kept
+                }
+                if (!resp.error.empty()) {
+                    lua_settop(pc.co, 0);
                     lua_pushnil(pc.co);
                     lua_pushlstring(pc.co, resp.error.data(), resp.error.size());
                 }
@@ -1439,7 +1424,7 @@ void LuaTab::lua_thread_fn(std::unique_ptr<LuaScript> script) {
             auto deadline = Clock::now() + std::chrono::seconds(1);
             if (!timers.empty())
                 deadline = std::min(deadline, timers.begin()->first);
-            responses.wait_until(deadline, [](auto& q) { return !q.empty(); });
+            responses->wait_until(deadline, [this](auto& q) { return !q.empty() || stopped_; });
         }
     } catch (const std::exception& e) {
         if (debug_out_)
@@ -1448,12 +1433,9 @@ void LuaTab::lua_thread_fn(std::unique_ptr<LuaScript> script) {
             tab_options_.contains("script") ? tab_options_["script"].get<std::string>() : "";
         lua_tab_state_.update(
             [&](auto& st) { st.init_error = LuaError{script_path, e.what(), Clock::now()}; });
-        stopped_.store(true); // make rpc_thread observe shutdown so join() below returns
+        stopped_.store(true);
     }
 
-    // Shutdown: wake rpc thread so it sees !running_ (or stopped_)
-    requests.notify();
-    rpc_thread.join();
     thread_done_.store(true);
 }
 
@@ -1463,10 +1445,10 @@ static std::set<std::string> make_allowlist(std::span<const std::string> extra)
     return allowlist;
 }
 
-LuaTab::LuaTab(RpcConfig cfg, Guarded<RpcAuth>& auth, App& screen, std::atomic<bool>& running,
+LuaTab::LuaTab(std::shared_ptr<RpcEngine> rpc_engine, App& screen, std::atomic<bool>& running,
                Guarded<AppState>& state, int refresh_secs, std::string debug_log_path,
                json tab_options, std::span<const std::string> extra_rpcs, std::ostream* debug_out)
-    : Tab(std::move(cfg), auth, screen, running, state, refresh_secs, debug_out),
+    : Tab(std::move(rpc_engine), screen, running, state, refresh_secs, debug_out),
       debug_log_path_(std::move(debug_log_path)), tab_options_(std::move(tab_options)),
       rpc_allowlist_(make_allowlist(extra_rpcs)) {
     const std::string lua_script = tab_options_["script"].get<std::string>();
@@ -1506,8 +1488,7 @@ void LuaTab::set_reload_callback(std::function<void()> fn) { reload_request_fn_
 
 void LuaTab::stop() {
     stopped_.store(true);
-    // The lua thread polls at a ≤1s cadence (responses.wait_until cap), so it
-    // observes stopped_ and exits without needing an explicit wake.
+    rpc_cancel_->cancel(); // fails the tab's pending RPCs and wakes the lua thread
 }
 
 bool LuaTab::finished() const { return thread_done_.load(); }
@@ -2307,6 +2288,7 @@ Element LuaTab::render(const AppState& /*snap*/) {
 }
 
 void LuaTab::join() {
+    stop(); // only called on teardown; don't wait out the lua thread's sleep
     if (lua_thread_.joinable())
         lua_thread_.join();
 }
@@ -70,12 +70,11 @@ struct LuaTabState {
 };
 
 class LuaScript;
-struct RpcRequest;
 struct RpcResponse;
 
 class LuaTab : public Tab {
   public:
-    LuaTab(RpcConfig cfg, Guarded<RpcAuth>& auth, ftxui::App& screen, std::atomic<bool>& running,
+    LuaTab(std::shared_ptr<RpcEngine> rpc_engine, ftxui::App& screen, std::atomic<bool>& running,
            Guarded<AppState>& state, int refresh_secs, std::string debug_log_path,
            json tab_options = {}, std::span<const std::string> extra_rpcs = {},
            std::ostream* debug_out = nullptr);
@@ -91,15 +90,14 @@ class LuaTab : public Tab {
     void        set_reload_callback(std::function<void()> fn);
 
     // Per-instance shutdown, independent of the shared `running` flag. Used when a
-    // tab is de-loaded at runtime: the worker threads wind down within ~1s.
+    // tab is de-loaded at runtime: the tab's RPCs are cancelled and the worker
+    // thread wakes up and exits straight away.
     void stop();
     // True once the worker thread has fully exited (so join() returns immediately).
     bool finished() const;
 
   private:
     void lua_thread_fn(std::unique_ptr<LuaScript> script);
-    void rpc_thread_fn(WaitableGuarded<std::deque<RpcRequest>>&  requests,
-                       WaitableGuarded<std::deque<RpcResponse>>& responses);
     void register_lua_api(LuaScript& script);
     void report_callback_error(int id, const std::string& source_id, const std::string& msg);
     void clear_callback_error(int id);
@@ -113,6 +111,7 @@ class LuaTab : public Tab {
     std::atomic<bool>                panel_scrolling_{false};
     std::atomic<bool>                stopped_{false};     // per-tab shutdown request
     std::atomic<bool>                thread_done_{false}; // set when lua_thread_ exits
+    std::shared_ptr<RpcCancelToken>  rpc_cancel_ = std::make_shared<RpcCancelToken>();
     std::function<void()>            reload_request_fn_;
     mutable Guarded<std::deque<int>> btn_click_queue_;
     mutable Guarded<std::deque<std::optional<std::string>>> input_result_queue_;
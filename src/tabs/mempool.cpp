@@ -125,9 +125,10 @@ static Element render_mempool(const AppState& s, int mempool_sel) {
     });
 }
 
-MempoolTab::MempoolTab(RpcConfig cfg, Guarded<RpcAuth>& auth, App& screen,
+MempoolTab::MempoolTab(std::shared_ptr<RpcEngine> rpc_engine, App& screen,
                        std::atomic<bool>& running, Guarded<AppState>& state, int refresh_secs)
-    : Tab(std::move(cfg), auth, screen, running, state, refresh_secs) {}
+    : Tab(std::move(rpc_engine), screen, running, state, refresh_secs),
+      rest_(rpc_engine_, {"Mempool"}) {}
 
 void MempoolTab::trigger_search(const std::string& query, bool switch_tab, int& tab_index_out) {
     if (search_in_flight_.load())
@@ -156,14 +157,28 @@ void MempoolTab::trigger_search(const std::string& query, bool switch_tab, int&
         return std::isdigit(c) != 0;
     });
 
-    search_thread_ = std::thread([this, query, query_is_height, tip_at_search] {
-        TxSearchState result =
-            perform_tx_search(cfg_, auth_, query, query_is_height, tip_at_search);
-        search_in_flight_ = false;
+    // Esc cancels the search: pending lookups fail at once and the result is dropped.
+    search_cancel_ = std::make_shared<RpcCancelToken>();
+    search_thread_ = std::thread([this, query, query_is_height, tip_at_search,
+                                  cancel = search_cancel_] {
+        const auto    timeout = std::chrono::seconds(5);
+        RpcClient     rpc     = rpc_client(timeout, cancel);
+        RestClient    rest    = rest_.with_options({name(), timeout, {}, cancel});
+        TxSearchState result  =
+            perform_tx_search(rpc, query, query_is_height, tip_at_search, &rest);
+        search_in_flight_     = false;
         if (!running_.load())
             return;
-        search_data_.update([&](auto& sd) { sd.state = result; });
-        screen_.Post(Event::Custom);
+        // Checked under the lock handle_escape() cancels under, so a dismissed
+        // search can never overwrite what the user went back to.
+        bool shown = search_data_.update([&](auto& sd) {
+            if (cancel->cancelled())
+                return false;
+            sd.state = result;
+            return true;
+        });
+        if (shown)
+            screen_.Post(Event::Custom);
     });
 }
 
@@ -565,7 +580,10 @@ bool MempoolTab::handle_enter(const Event& event) {
 bool MempoolTab::handle_escape(const Event& event) {
     if (event != Event::Escape)
         return false;
-    bool had_overlay = search_data_.update([](auto& sd) {
+    bool had_overlay = search_data_.update([this](auto& sd) {
+        // Leaving a search that is still running abandons it.
+        if (search_in_flight_ && search_cancel_)
+            search_cancel_->cancel();
         if (!sd.history.empty()) {
             sd.state = sd.history.back();
             sd.history.pop_back();
@@ -9,12 +9,13 @@
 #include <ftxui/ftxui.hpp>
 
 #include "guarded.hpp"
+#include "rest_client.hpp"
 #include "state.hpp"
 #include "tabs/tab.hpp"
 
 class MempoolTab : public Tab {
   public:
-    MempoolTab(RpcConfig cfg, Guarded<RpcAuth>& auth, ftxui::App& screen,
+    MempoolTab(std::shared_ptr<RpcEngine> rpc_engine, ftxui::App& screen,
                std::atomic<bool>& running, Guarded<AppState>& state, int refresh_secs);
     ~MempoolTab() override = default;
 
@@ -53,7 +54,9 @@ class MempoolTab : public Tab {
         TxSearchState              state;
         std::vector<TxSearchState> history;
     };
-    mutable Guarded<SearchData> search_data_;
-    std::atomic<bool>           search_in_flight_{false};
-    std::thread                 search_thread_;
+    mutable Guarded<SearchData>     search_data_;
+    std::atomic<bool>               search_in_flight_{false};
+    std::shared_ptr<RpcCancelToken> search_cancel_; // current search; UI thread only
+    std::thread                     search_thread_;
+    RestClient                      rest_; // block lookups; remembers if the node lacks -rest
 };
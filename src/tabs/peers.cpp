@@ -319,9 +319,9 @@ static Element render_ban_list_panel(const std::vector<BannedEntry>& entries, bo
     return vbox(std::move(rows)) | border | size(WIDTH, EQUAL, 64);
 }
 
-PeersTab::PeersTab(RpcConfig cfg, Guarded<RpcAuth>& auth, App& screen, std::atomic<bool>& running,
+PeersTab::PeersTab(std::shared_ptr<RpcEngine> rpc_engine, App& screen, std::atomic<bool>& running,
                    Guarded<AppState>& state, int refresh_secs)
-    : Tab(std::move(cfg), auth, screen, running, state, refresh_secs) {}
+    : Tab(std::move(rpc_engine), screen, running, state, refresh_secs) {}
 
 FooterSpec PeersTab::footer_buttons(const AppState& snap) {
     auto esc_addnode = [this] { handle_addnode_input(ftxui::Event::Escape); };
@@ -402,29 +402,31 @@ void PeersTab::trigger_peer_action(const std::string& addr, bool is_ban) {
     peer_action_in_flight = true;
     peer_action_          = PeerActionResult{};
     screen_.Post(Event::Custom);
-    if (peer_action_thread_.joinable())
-        peer_action_thread_.join();
-    peer_action_thread_ = std::thread([this, addr, is_ban] {
+
+    std::string method  = "disconnectnode";
+    json        params  = {addr};
+    std::string success = "Disconnected";
+    if (is_ban) {
+        std::string ip = addr;
+        if (!addr.empty() && addr[0] == '[') {
+            auto end = addr.find(']');
+            if (end != std::string::npos)
+                ip = addr.substr(0, end + 1);
+        } else {
+            auto colon = addr.rfind(':');
+            if (colon != std::string::npos)
+                ip = addr.substr(0, colon);
+        }
+        method  = "setban";
+        params  = {ip, std::string("add")};
+        success = "Banned " + ip;
+    }
+    rpc_client().call_async(method, params, [this, is_ban, success](std::exception_ptr err, json) {
         PeerActionResult result;
         try {
-            RpcClient rc(cfg_, auth_);
-            if (is_ban) {
-                std::string ip = addr;
-                if (!addr.empty() && addr[0] == '[') {
-                    auto end = addr.find(']');
-                    if (end != std::string::npos)
-                        ip = addr.substr(0, end + 1);
-                } else {
-                    auto colon = addr.rfind(':');
-                    if (colon != std::string::npos)
-                        ip = addr.substr(0, colon);
-                }
-                rc.call("setban", {ip, std::string("add")});
-                result.message = "Banned " + ip;
-            } else {
-                rc.call("disconnectnode", {addr});
-                result.message = "Disconnected";
-            }
+            if (err)
+                std::rethrow_exception(err);
+            result.message = success;
             result.success = true;
         } catch (const std::exception& e) {
             result.message = e.what();
@@ -450,26 +452,25 @@ void PeersTab::trigger_addnode(const std::string& addr, const std::string& cmd)
         s.cmd_idx     = saved_cmd;
     });
     screen_.Post(Event::Custom);
-    if (addnode_thread_.joinable())
-        addnode_thread_.join();
-    addnode_thread_ = std::thread([this, addr, cmd] {
-        AddNodeState result;
-        try {
-            RpcClient rc(cfg_, auth_);
-            rc.call("addnode", {addr, cmd});
-            result.success        = true;
-            result.result_message = cmd + " " + addr;
-        } catch (const std::exception& e) {
-            result.result_message = e.what();
-        }
-        result.has_result   = true;
-        addnode_in_flight_  = false;
-        added_nodes_loaded_ = false;
-        if (!running_.load())
-            return;
-        addnode_state_ = std::move(result);
-        screen_.Post(Event::Custom);
-    });
+    rpc_client().call_async(
+        "addnode", {addr, cmd}, [this, addr, cmd](std::exception_ptr err, json) {
+            AddNodeState result;
+            try {
+                if (err)
+                    std::rethrow_exception(err);
+                result.success        = true;
+                result.result_message = cmd + " " + addr;
+            } catch (const std::exception& e) {
+                result.result_message = e.what();
+            }
+            result.has_result   = true;
+            addnode_in_flight_  = false;
+            added_nodes_loaded_ = false;
+            if (!running_.load())
+                return;
+            addnode_state_ = std::move(result);
+            screen_.Post(Event::Custom);
+        });
 }
 
 void PeersTab::trigger_setban(const std::string& addr, bool remove) {
@@ -478,125 +479,110 @@ void PeersTab::trigger_setban(const std::string& addr, bool remove) {
     ban_in_flight_ = true;
     ban_state_     = BanNodeState{.pending = true};
     screen_.Post(Event::Custom);
-    if (ban_thread_.joinable())
-        ban_thread_.join();
-    ban_thread_ = std::thread([this, addr, remove] {
-        BanNodeState result;
-        try {
-            RpcClient   rc(cfg_, auth_);
-            std::string cmd = remove ? "remove" : "add";
-            rc.call("setban", {addr, cmd});
-            result.success        = true;
-            result.result_message = (remove ? "Unbanned " : "Banned ") + addr;
-        } catch (const std::exception& e) {
-            result.result_message = e.what();
-        }
-        result.has_result   = true;
-        ban_in_flight_      = false;
-        banned_list_loaded_ = false;
-        if (!running_.load())
-            return;
-        ban_state_ = std::move(result);
-        screen_.Post(Event::Custom);
-    });
+    std::string cmd = remove ? "remove" : "add";
+    rpc_client().call_async(
+        "setban", {addr, cmd}, [this, addr, remove](std::exception_ptr err, json) {
+            BanNodeState result;
+            try {
+                if (err)
+                    std::rethrow_exception(err);
+                result.success        = true;
+                result.result_message = (remove ? "Unbanned " : "Banned ") + addr;
+            } catch (const std::exception& e) {
+                result.result_message = e.what();
+            }
+            result.has_result   = true;
+            ban_in_flight_      = false;
+            banned_list_loaded_ = false;
+            if (!running_.load())
+                return;
+            ban_state_ = std::move(result);
+            screen_.Post(Event::Custom);
+        });
 }
 
 void PeersTab::fetch_added_nodes() {
     if (added_nodes_loading_.load())
         return;
-    if (added_nodes_thread_.joinable())
-        added_nodes_thread_.join();
     added_nodes_loading_ = true;
-    added_nodes_thread_  = std::thread([this] {
-        std::vector<AddedNodeInfo> result;
-        try {
-            RpcClient rc(cfg_, auth_);
-            auto      ans = rc.call("getaddednodeinfo")["result"];
-            for (const auto& n : ans) {
-                AddedNodeInfo info;
-                info.addednode = n.value("addednode", "");
-                if (n.contains("addresses") && n["addresses"].is_array()) {
-                    for (const auto& a : n["addresses"]) {
-                        if (a.value("connected", false)) {
-                            info.connected = true;
-                            break;
+    rpc_client().call_async(
+        "getaddednodeinfo", json::array(), [this](std::exception_ptr err, const json& reply) {
+            std::vector<AddedNodeInfo> result;
+            try {
+                if (err)
+                    std::rethrow_exception(err);
+                for (const auto& n : reply["result"]) {
+                    AddedNodeInfo info;
+                    info.addednode = n.value("addednode", "");
+                    if (n.contains("addresses") && n["addresses"].is_array()) {
+                        for (const auto& a : n["addresses"]) {
+                            if (a.value("connected", false)) {
+                                info.connected = true;
+                                break;
+                            }
                         }
                     }
+                    result.push_back(std::move(info));
                 }
-                result.push_back(std::move(info));
+            } catch (...) { // NOLINT(bugprone-empty-catch)
             }
-        } catch (...) { // NOLINT(bugprone-empty-catch)
-        }
-        if (!running_.load())
-            return;
-        added_nodes_         = std::move(result);
-        added_nodes_loading_ = false;
-        added_nodes_loaded_  = true;
-        screen_.Post(Event::Custom);
-    });
+            if (!running_.load())
+                return;
+            added_nodes_         = std::move(result);
+            added_nodes_loading_ = false;
+            added_nodes_loaded_  = true;
+            screen_.Post(Event::Custom);
+        });
 }
 
 void PeersTab::fetch_ban_list() {
     if (banned_list_loading_.load())
         return;
-    if (banned_list_thread_.joinable())
-        banned_list_thread_.join();
     banned_list_loading_ = true;
-    banned_list_thread_  = std::thread([this] {
-        std::vector<BannedEntry> result;
-        try {
-            RpcClient rc(cfg_, auth_);
-            auto      bl = rc.call("listbanned")["result"];
-            for (const auto& b : bl) {
-                BannedEntry entry;
-                entry.address      = b.value("address", "");
-                entry.banned_until = b.value("banned_until", 0LL);
-                entry.ban_reason   = b.value("ban_reason", "");
-                result.push_back(std::move(entry));
+    rpc_client().call_async(
+        "listbanned", json::array(), [this](std::exception_ptr err, const json& reply) {
+            std::vector<BannedEntry> result;
+            try {
+                if (err)
+                    std::rethrow_exception(err);
+                for (const auto& b : reply["result"]) {
+                    BannedEntry entry;
+                    entry.address      = b.value("address", "");
+                    entry.banned_until = b.value("banned_until", 0LL);
+                    entry.ban_reason   = b.value("ban_reason", "");
+                    result.push_back(std::move(entry));
+                }
+            } catch (...) { // NOLINT(bugprone-empty-catch)
             }
-        } catch (...) { // NOLINT(bugprone-empty-catch)
-        }
-        if (!running_.load())
-            return;
-        banned_list_         = std::move(result);
-        banned_list_loading_ = false;
-        banned_list_loaded_  = true;
-        screen_.Post(Event::Custom);
-    });
+            if (!running_.load())
+                return;
+            banned_list_         = std::move(result);
+            banned_list_loading_ = false;
+            banned_list_loaded_  = true;
+            screen_.Post(Event::Custom);
+        });
 }
 
 void PeersTab::do_remove_added_node(const std::string& addr) {
-    if (remove_addednode_thread_.joinable())
-        remove_addednode_thread_.join();
-    remove_addednode_thread_ = std::thread([this, addr] {
-        try {
-            RpcClient rc(cfg_, auth_);
-            rc.call("addnode", {addr, std::string("remove")});
-        } catch (...) { // NOLINT(bugprone-empty-catch)
-        }
-        if (!running_.load())
-            return;
-        added_nodes_loaded_  = false;
-        added_nodes_loading_ = false;
-        screen_.Post(Event::Custom);
-    });
+    rpc_client().call_async("addnode", {addr, std::string("remove")},
+                            [this](std::exception_ptr, json) {
+                                if (!running_.load())
+                                    return;
+                                added_nodes_loaded_  = false;
+                                added_nodes_loading_ = false;
+                                screen_.Post(Event::Custom);
+                            });
 }
 
 void PeersTab::do_unban(const std::string& addr) {
-    if (unban_action_thread_.joinable())
-        unban_action_thread_.join();
-    unban_action_thread_ = std::thread([this, addr] {
-        try {
-            RpcClient rc(cfg_, auth_);
-            rc.call("setban", {addr, std::string("remove")});
-        } catch (...) { // NOLINT(bugprone-empty-catch)
-        }
-        if (!running_.load())
-            return;
-        banned_list_loaded_  = false;
-        banned_list_loading_ = false;
-        screen_.Post(Event::Custom);
-    });
+    rpc_client().call_async("setban", {addr, std::string("remove")},
+                            [this](std::exception_ptr, json) {
+                                if (!running_.load())
+                                    return;
+                                banned_list_loaded_  = false;
+                                banned_list_loading_ = false;
+                                screen_.Post(Event::Custom);
+                            });
 }
 
 // ============================================================================
@@ -926,19 +912,6 @@ bool PeersTab::handle_focused_event(const Event& event) {
     return false;
 }
 
-void PeersTab::join() {
-    if (peer_action_thread_.joinable())
-        peer_action_thread_.join();
-    if (addnode_thread_.joinable())
-        addnode_thread_.join();
-    if (ban_thread_.joinable())
-        ban_thread_.join();
-    if (remove_addednode_thread_.joinable())
-        remove_addednode_thread_.join();
-    if (unban_action_thread_.joinable())
-        unban_action_thread_.join();
-    if (added_nodes_thread_.joinable())
-        added_nodes_thread_.join();
-    if (banned_list_thread_.joinable())
-        banned_list_thread_.join();
-}
+// Actions complete on the shared RPC engine, which Application shuts down
+// (running every pending completion) before tabs are joined.
+void PeersTab::join() {}
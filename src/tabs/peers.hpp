@@ -2,7 +2,6 @@
 
 #include <atomic>
 #include <string>
-#include <thread>
 #include <vector>
 
 #include <ftxui/ftxui.hpp>
@@ -13,7 +12,7 @@
 
 class PeersTab : public Tab {
   public:
-    PeersTab(RpcConfig cfg, Guarded<RpcAuth>& auth, ftxui::App& screen, std::atomic<bool>& running,
+    PeersTab(std::shared_ptr<RpcEngine> rpc_engine, ftxui::App& screen, std::atomic<bool>& running,
              Guarded<AppState>& state, int refresh_secs);
     ~PeersTab() override = default;
 
@@ -47,27 +46,20 @@ class PeersTab : public Tab {
 
     int                       peer_detail_sel_ = 0;
     Guarded<PeerActionResult> peer_action_;
-    std::thread               peer_action_thread_;
 
     int                                 addednodes_sel_ = -1;
     Guarded<std::vector<AddedNodeInfo>> added_nodes_;
     std::atomic<bool>                   added_nodes_loaded_{false};
     std::atomic<bool>                   added_nodes_loading_{false};
-    std::thread                         added_nodes_thread_;
     std::string                         addnode_str_;
     Guarded<AddNodeState>               addnode_state_;
     std::atomic<bool>                   addnode_in_flight_{false};
-    std::thread                         addnode_thread_;
-    std::thread                         remove_addednode_thread_;
 
     int                               banlist_sel_ = -1;
     Guarded<std::vector<BannedEntry>> banned_list_;
     std::atomic<bool>                 banned_list_loaded_{false};
     std::atomic<bool>                 banned_list_loading_{false};
-    std::thread                       banned_list_thread_;
     std::string                       ban_str_;
     Guarded<BanNodeState>             ban_state_;
     std::atomic<bool>                 ban_in_flight_{false};
-    std::thread                       ban_thread_;
-    std::thread                       unban_action_thread_;
 };
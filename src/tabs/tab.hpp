@@ -1,6 +1,8 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <utility>
@@ -15,9 +17,9 @@
 
 class Tab {
   public:
-    Tab(RpcConfig cfg, Guarded<RpcAuth>& auth, ftxui::App& screen, std::atomic<bool>& running,
+    Tab(std::shared_ptr<RpcEngine> rpc_engine, ftxui::App& screen, std::atomic<bool>& running,
         Guarded<AppState>& state, int refresh_secs, std::ostream* debug_out = nullptr)
-        : cfg_{std::move(cfg)}, auth_{auth}, screen_{screen}, running_{running}, state_{state},
+        : rpc_engine_{std::move(rpc_engine)}, screen_{screen}, running_{running}, state_{state},
           refresh_secs_{refresh_secs}, debug_out_{debug_out} {}
     virtual ~Tab() = default;
 
@@ -28,13 +30,19 @@ class Tab {
     virtual void           join() = 0;
 
   protected:
-    RpcConfig          cfg_;
-    Guarded<RpcAuth>&  auth_;
-    ftxui::App&        screen_;
-    std::atomic<bool>& running_;
-    Guarded<AppState>& state_;
-    int                refresh_secs_;
-    std::ostream*      debug_out_;
+    std::shared_ptr<RpcEngine> rpc_engine_; // shared by every tab and the poll thread
+    ftxui::App&                screen_;
+    std::atomic<bool>&         running_;
+    Guarded<AppState>&         state_;
+    int                        refresh_secs_;
+    std::ostream*              debug_out_;
+
+    // A client on the shared engine whose requests are counted against this tab
+    // in RpcEngine::queue_depth(). A zero timeout uses the configured one.
+    RpcClient rpc_client(std::chrono::milliseconds timeout = {},
+                         std::shared_ptr<RpcCancelToken> cancel = nullptr) const {
+        return RpcClient(rpc_engine_, {name(), timeout, {}, std::move(cancel)});
+    }
 
     FooterButton refresh_btn(const AppState& snap) const {
         return {snap.refreshing ? " \u21bb refreshing"
@@ -133,10 +133,10 @@ static Element render_tools(const AppState& snap, const BroadcastState& bs, int
     return vbox(std::move(layout)) | flex;
 }
 
-ToolsTab::ToolsTab(RpcConfig cfg, Guarded<RpcAuth>& auth, App& screen, std::atomic<bool>& running,
+ToolsTab::ToolsTab(std::shared_ptr<RpcEngine> rpc_engine, App& screen, std::atomic<bool>& running,
                    Guarded<AppState>& state, int refresh_secs,
                    std::function<void(const std::string&, bool)> trigger_search)
-    : Tab(std::move(cfg), auth, screen, running, state, refresh_secs),
+    : Tab(std::move(rpc_engine), screen, running, state, refresh_secs),
       trigger_search_(std::move(trigger_search)) {}
 
 FooterSpec ToolsTab::footer_buttons(const AppState& /*snap*/) {
@@ -164,34 +164,30 @@ void ToolsTab::trigger_broadcast(const std::string& hex) {
     broadcast_in_flight_ = true;
     broadcast_state_.update([&](auto& bs) { bs = BroadcastState{.hex = hex, .submitting = true}; });
     screen_.Post(Event::Custom);
-    if (broadcast_thread_.joinable())
-        broadcast_thread_.join();
-    broadcast_thread_ = std::thread([this, hex] {
-        BroadcastState result{.hex = hex};
-        try {
-            RpcConfig bcast_cfg       = cfg_;
-            bcast_cfg.timeout_seconds = 30;
-            RpcClient bc(bcast_cfg, auth_);
-            json      res      = bc.call("sendrawtransaction", {hex});
-            result.result_txid = res["result"].get<std::string>();
-            result.success     = true;
-        } catch (const std::exception& e) {
-            result.result_error = e.what();
-            result.success      = false;
-        }
-        result.has_result    = true;
-        broadcast_in_flight_ = false;
-        if (!running_.load())
-            return;
-        broadcast_state_.update([&](auto& bs) { bs = result; });
-        screen_.Post(Event::Custom);
-    });
+    rpc_client(std::chrono::seconds(30)).call_async(
+        "sendrawtransaction", {hex}, [this, hex](std::exception_ptr err, const json& res) {
+            BroadcastState result{.hex = hex};
+            try {
+                if (err)
+                    std::rethrow_exception(err);
+                result.result_txid = res["result"].get<std::string>();
+                result.success     = true;
+            } catch (const std::exception& e) {
+                result.result_error = e.what();
+                result.success      = false;
+            }
+            result.has_result    = true;
+            broadcast_in_flight_ = false;
+            if (!running_.load())
+                return;
+            broadcast_state_.update([&](auto& bs) { bs = result; });
+            screen_.Post(Event::Custom);
+        });
 }
 
 void ToolsTab::do_shutdown() {
     try {
-        RpcClient rpc(cfg_, auth_);
-        rpc.call("stop", {});
+        rpc_client().call("stop", {});
     } catch (...) { // NOLINT(bugprone-empty-catch)
     }
     screen_.ExitLoopClosure()();
@@ -278,7 +274,6 @@ bool ToolsTab::handle_focused_event(const Event& event) {
     return false;
 }
 
-void ToolsTab::join() {
-    if (broadcast_thread_.joinable())
-        broadcast_thread_.join();
-}
+// Broadcasts complete on the shared RPC engine, which Application shuts down
+// (running every pending completion) before tabs are joined.
+void ToolsTab::join() {}
@@ -3,7 +3,6 @@
 #include <atomic>
 #include <functional>
 #include <string>
-#include <thread>
 
 #include <ftxui/ftxui.hpp>
 
@@ -13,7 +12,7 @@
 
 class ToolsTab : public Tab {
   public:
-    ToolsTab(RpcConfig cfg, Guarded<RpcAuth>& auth, ftxui::App& screen, std::atomic<bool>& running,
+    ToolsTab(std::shared_ptr<RpcEngine> rpc_engine, ftxui::App& screen, std::atomic<bool>& running,
              Guarded<AppState>& state, int refresh_secs,
              std::function<void(const std::string&, bool)> trigger_search);
     ~ToolsTab() override = default;
@@ -40,5 +39,4 @@ class ToolsTab : public Tab {
     Guarded<BroadcastState> broadcast_state_;
     std::atomic<bool>       broadcast_in_flight_{false};
     std::string             tools_hex_str_;
-    std::thread             broadcast_thread_;
 };
@@ -163,6 +163,20 @@ TEST_CASE("--port rejects non-numeric value") {
     CHECK(exit_code(binary() + " --port abc" + null_sink()) != 0);
 }
 
+// ---------------------------------------------------------------------------
+// --rpc-connections validation
+// ---------------------------------------------------------------------------
+
+TEST_CASE("--rpc-connections accepts 1..16") {
+    CHECK(exit_code(binary() + " --rpc-connections 1 --version" + null_sink()) == 0);
+    CHECK(exit_code(binary() + " --rpc-connections 16 --version" + null_sink()) == 0);
+}
+
+TEST_CASE("--rpc-connections rejects out-of-range values") {
+    CHECK(exit_code(binary() + " --rpc-connections 0" + null_sink()) != 0);
+    CHECK(exit_code(binary() + " --rpc-connections 17" + null_sink()) != 0);
+}
+
 // ---------------------------------------------------------------------------
 // Network flags
 // ---------------------------------------------------------------------------
@@ -0,0 +1,147 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "consensus.hpp"
+#include "format.hpp"
+
+#include <string>
+
+static std::string from_hex(const std::string& hex) {
+    std::string out;
+    for (size_t i = 0; i + 1 < hex.size(); i += 2)
+        out += static_cast<char>(std::stoi(hex.substr(i, 2), nullptr, 16));
+    return out;
+}
+
+// Mainnet genesis block, as served by /rest/block/<hash>.bin
+static const std::string kGenesis = from_hex(
+    "0100000000000000000000000000000000000000000000000000000000000000000000003ba3edfd7a7b12b27ac72c"
+    "3e67768f617fc81bc3888a51323a9fb8aa4b1e5e4a29ab5f49ffff001d1dac2b7c01010000000100000000000000"
+    "00000000000000000000000000000000000000000000000000ffffffff4d04ffff001d0104455468652054696d65"
+    "732030332f4a616e2f32303039204368616e63656c6c6f72206f6e206272696e6b206f66207365636f6e64206261"
+    "696c6f757420666f722062616e6b73ffffffff0100f2052a01000000434104678afdb0fe5548271967f1a67130b7"
+    "105cd6a828e03909a67962e0ea1f61deb649f6bc3f4cef38c4f35504e51ec112de5c384df7ba0b8d578a4c702b6b"
+    "f11d5fac00000000");
+
+// Version 2, one input, one output, a single two-byte witness item (BIP144).
+static const std::string kSegwitTx = from_hex(
+    "02000000"
+    "0001"
+    "01"
+    "1111111111111111111111111111111111111111111111111111111111111111"
+    "00000000"
+    "00"
+    "ffffffff"
+    "01"
+    "e803000000000000"
+    "0151"
+    "0102aabb"
+    "00000000");
+
+// ============================================================================
+// Blocks
+// ============================================================================
+
+TEST_CASE("decode_block — genesis block") {
+    REQUIRE(kGenesis.size() == 285);
+    const Block blk = decode_block(kGenesis);
+
+    CHECK(blk.header.version == 1);
+    CHECK(blk.header.prev_hash == Hash256{});
+    CHECK(blk.header.merkle_root.hex() ==
+          "4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b");
+    CHECK(blk.header.time == 1231006505);
+    CHECK(blk.header.bits == 0x1d00ffff);
+    CHECK(blk.header.nonce == 2083236893);
+    CHECK(blk.size == 285);
+    CHECK(blk.stripped_size == 285);
+    CHECK(blk.weight() == 1140);
+
+    REQUIRE(blk.txs.size() == 1);
+    const Transaction& cb = blk.txs[0];
+    REQUIRE(cb.vin.size() == 1);
+    CHECK(cb.vin[0].is_coinbase());
+    CHECK(extract_miner(to_hex(cb.vin[0].script_sig)) == "2009 Chancellor on brink");
+    REQUIRE(cb.vout.size() == 1);
+    CHECK(cb.vout[0].value == 5000000000LL);
+    CHECK(cb.vout[0].script_pubkey.size() == 67);
+}
+
+TEST_CASE("decode_block — truncated or trailing data is rejected") {
+    CHECK_THROWS_AS(decode_block(kGenesis.substr(0, kGenesis.size() - 1)), ConsensusError);
+    CHECK_THROWS_AS(decode_block(kGenesis + '\0'), ConsensusError);
+    CHECK_THROWS_AS(decode_block(""), ConsensusError);
+}
+
+TEST_CASE("decode_block — absurd transaction count fails before allocating") {
+    std::string blk = kGenesis.substr(0, 80) + from_hex("ffffffffffffffff7f");
+    CHECK_THROWS_AS(decode_block(blk), ConsensusError);
+}
+
+// ============================================================================
+// Transactions
+// ============================================================================
+
+TEST_CASE("decode_transaction — segwit sizes and weight") {
+    const Transaction tx = decode_transaction(kSegwitTx);
+    CHECK(tx.version == 2);
+    REQUIRE(tx.vin.size() == 1);
+    CHECK_FALSE(tx.vin[0].is_coinbase());
+    CHECK(tx.vin[0].prev_vout == 0);
+    CHECK(tx.vin[0].sequence == 0xffffffff);
+    REQUIRE(tx.vout.size() == 1);
+    CHECK(tx.vout[0].value == 1000);
+    CHECK(tx.vout[0].script_pubkey == "\x51");
+    CHECK(tx.size == 67);
+    CHECK(tx.stripped_size == 61);
+    CHECK(tx.weight() == 250);
+}
+
+TEST_CASE("decode_transaction — unknown serialization flag is rejected") {
+    std::string tx = kSegwitTx;
+    tx[5]          = '\x02';
+    CHECK_THROWS_AS(decode_transaction(tx), ConsensusError);
+}
+
+// ============================================================================
+// Headers
+// ============================================================================
+
+TEST_CASE("decode_headers — concatenated headers") {
+    const std::string two = kGenesis.substr(0, 80) + kGenesis.substr(0, 80);
+    auto              hs  = decode_headers(two);
+    REQUIRE(hs.size() == 2);
+    CHECK(hs[1].nonce == 2083236893);
+    CHECK(decode_headers("").empty());
+    CHECK_THROWS_AS(decode_headers(kGenesis.substr(0, 79)), ConsensusError);
+}
+
+// ============================================================================
+// Hash256 / derived values
+// ============================================================================
+
+TEST_CASE("Hash256 — display hex round-trips") {
+    const std::string hex = "000000000019d6689c085ae165831e934ff763ae46a2a6c172b3f1b60a8ce26f";
+    auto              h   = Hash256::from_hex(hex);
+    REQUIRE(h);
+    CHECK(h->bytes[0] == 0x6f);
+    CHECK(h->bytes[31] == 0x00);
+    CHECK(h->hex() == hex);
+    CHECK_FALSE(Hash256::from_hex(hex.substr(1)));
+    CHECK_FALSE(Hash256::from_hex("zz" + hex.substr(2)));
+}
+
+TEST_CASE("difficulty_from_bits") {
+    CHECK(difficulty_from_bits(0x1d00ffff) == Catch::Approx(1.0));
+    CHECK(difficulty_from_bits(0x1b0404cb) == Catch::Approx(16307.420938523983));
+}
+
+TEST_CASE("bip34_height") {
+    CHECK(bip34_height(from_hex("0300350c")) == 800000);
+    CHECK(bip34_height(from_hex("51")) == 1);
+    CHECK(bip34_height(from_hex("00")) == 0);
+    CHECK_FALSE(bip34_height(from_hex("0180")));  // negative
+    CHECK_FALSE(bip34_height(from_hex("0300")));  // push runs past the script
+    CHECK_FALSE(bip34_height(from_hex("4c0100"))); // not a small push
+    CHECK_FALSE(bip34_height(""));
+}
@@ -71,6 +71,18 @@ TEST_CASE("fmt_bytes — gigabytes") {
     CHECK(fmt_bytes(2500000000LL) == "2.5 GB");
 }
 
+// ============================================================================
+// fmt_latency
+// ============================================================================
+
+TEST_CASE("fmt_latency — picks the unit by magnitude") {
+    using std::chrono::microseconds;
+    CHECK(fmt_latency(microseconds(0)) == "0 \u00b5s");
+    CHECK(fmt_latency(microseconds(999)) == "999 \u00b5s");
+    CHECK(fmt_latency(microseconds(1500)) == "1.5 ms");
+    CHECK(fmt_latency(microseconds(2'340'000)) == "2.34 s");
+}
+
 // ============================================================================
 // fmt_difficulty
 // ============================================================================
@@ -5,6 +5,15 @@
 
 #include "json.hpp"
 
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
 // ============================================================================
 // Construction + type queries
 // ============================================================================
@@ -116,6 +125,39 @@ TEST_CASE("object factory") {
     CHECK(o.empty());
 }
 
+TEST_CASE("nodes are a compact tagged union") { CHECK(sizeof(json) <= 16); }
+
+TEST_CASE("copies are deep, moves leave null") {
+    json a = {{"k", {1, "two"}}};
+    json b = a;
+    b["k"][1] = "changed";
+    CHECK(a["k"][1].get<std::string>() == "two");
+
+    json c = std::move(b);
+    CHECK(b.is_null()); // NOLINT(bugprone-use-after-move)
+    CHECK(c["k"][1].get<std::string>() == "changed");
+
+    c = c["k"]; // from a descendant of the target itself
+    CHECK(c.is_array());
+    CHECK(c[0].get<int>() == 1);
+    c = std::move(c[1]);
+    CHECK(c.get<std::string>() == "changed");
+}
+
+TEST_CASE("null iterates as empty") {
+    json n;
+    int  seen = 0;
+    for (auto& el : n) {
+        (void)el;
+        ++seen;
+    }
+    for (const auto& el : std::as_const(n)) {
+        (void)el;
+        ++seen;
+    }
+    CHECK(seen == 0);
+}
+
 // ============================================================================
 // Initializer-list construction
 // ============================================================================
@@ -296,7 +338,7 @@ TEST_CASE("items() — object key/value iteration") {
 
     std::map<std::string, int> seen;
     for (const auto& [key, val] : o.items())
-        seen[key] = val.get<int>();
+        seen[std::string(key)] = val.get<int>();
 
     CHECK(seen.size() == 3);
     CHECK(seen["alpha"] == 1);
@@ -308,8 +350,8 @@ TEST_CASE("items() — parsed object key/value iteration") {
     auto                     o = json::parse(R"({"x":"foo","y":"bar"})");
     std::vector<std::string> keys;
     for (const auto& [k, v] : o.items())
-        keys.push_back(k);
-    // std::map orders keys alphabetically
+        keys.emplace_back(k);
+    // objects keep their members sorted by key
     CHECK(keys.size() == 2);
     CHECK(keys[0] == "x");
     CHECK(keys[1] == "y");
@@ -323,6 +365,38 @@ TEST_CASE("items() — empty object") {
     CHECK(n == 0);
 }
 
+TEST_CASE("objects stay sorted by key, the last of duplicates winning") {
+    CHECK(json::parse(R"({"b":1,"a":2,"c":{"z":0,"y":1},"b":3})").dump() ==
+          R"({"a":2,"b":3,"c":{"y":1,"z":0}})");
+    CHECK(json({{"k", 1}, {"a", 2}, {"k", 3}}).dump() == R"({"a":2,"k":3})");
+
+    json o;
+    o["m"] = 1;
+    o["c"] = 2;
+    o["x"] = 3;
+    o["c"] = 4;
+    CHECK(o.dump() == R"({"c":4,"m":1,"x":3})");
+
+    json::object_t members;
+    members["b"] = 1;
+    members.insert_or_assign("a", json(2));
+    members.insert_or_assign("b", json(3));
+    CHECK(json(members).dump() == R"({"a":2,"b":3})");
+    CHECK(members.find("a") != members.end());
+    CHECK(members.find("ab") == members.end());
+}
+
+TEST_CASE("object lookups take any string view") {
+    const json       o    = json::parse(R"({"blocks":5,"bestblockhash":"00ff"})");
+    std::string_view text = "blocks, headers";
+    std::string_view key  = text.substr(0, 6); // not NUL-terminated
+    CHECK(o.contains(key));
+    CHECK(o[key].get<int>() == 5);
+    CHECK(o.value(key, 0) == 5);
+    CHECK(o.value(std::string("bestblockhash"), "") == "00ff");
+    CHECK(!o.contains(text.substr(0, 5)));
+}
+
 // ============================================================================
 // parse — primitives
 // ============================================================================
@@ -352,6 +426,33 @@ TEST_CASE("parse float") {
     CHECK(json::parse("2E-1").get<double>() == Catch::Approx(0.2));
 }
 
+TEST_CASE("parse numbers past the range of int64 as doubles") {
+    CHECK(json::parse("9223372036854775807").get<int64_t>() == INT64_MAX);
+    const json big = json::parse("18446744073709551616");
+    CHECK(big.is_number_float());
+    CHECK(big.get<double>() == Catch::Approx(1.8446744073709552e19));
+    CHECK_THROWS_AS(json::parse("-"), json::exception);
+    CHECK_THROWS_AS(json::parse("[1e]"), json::exception);
+}
+
+TEST_CASE("get_sats reads BTC amounts as exact satoshis") {
+    CHECK(json::parse("0.29").get_sats() == 29'000'000); // 0.29 * 1e8 is 28999999.999999996
+    CHECK(json::parse("0.00001234").get_sats() == 1234);
+    CHECK(json::parse("-0.00000001").get_sats() == -1);
+    CHECK(json::parse("20999999.97690000").get_sats() == 2'099'999'997'690'000);
+    CHECK(json::parse("50").get_sats() == 5'000'000'000);
+    CHECK(json::parse_document(R"({"fee":1.1e-7})")["fee"].get_sats() == 11);
+    CHECK_THROWS_AS(json::parse(R"("0.1")").get_sats(), json::exception);
+    CHECK_THROWS_AS(json::parse("1e9").get_sats(), json::exception);
+
+    // Every satoshi amount below 1 BTC survives the round trip through text.
+    for (int64_t sats = 1; sats < 100'000'000; sats += 99'991) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "0.%08lld", static_cast<long long>(sats));
+        CHECK(json::parse(buf).get_sats() == sats);
+    }
+}
+
 TEST_CASE("parse string") {
     CHECK(json::parse(R"("hello")").get<std::string>() == "hello");
     CHECK(json::parse(R"("")").get<std::string>().empty());
@@ -386,6 +487,24 @@ TEST_CASE("parse unicode escape") {
     CHECK(static_cast<unsigned char>(s[1]) == 0xA9);
 }
 
+TEST_CASE("parse long strings and whitespace runs") {
+    // Escapes and whitespace on either side of the 16-byte blocks the
+    // scanners read.
+    for (size_t at = 0; at <= 40; ++at) {
+        const std::string head(at, 'a'), tail(40 - at, 'b');
+        const std::string src = "\"" + head + "\\n" + tail + "\"";
+        CHECK(json::parse(src).get<std::string>() == head + '\n' + tail);
+        CHECK(json::parse_document(src).get<std::string>() == head + '\n' + tail);
+
+        json::incremental_parser p;
+        p.feed(std::string(at, ' ') + "[" + std::string(at, '\n') + "1," +
+               std::string(at, ' ') + "2" + std::string(at, '\t') + "]");
+        CHECK(p.finish().dump() == "[1,2]");
+        CHECK(json::parse(std::string(at, ' ') + "[1," + std::string(at, ' ') + "2]").dump() ==
+              "[1,2]");
+    }
+}
+
 // ============================================================================
 // parse — arrays and objects
 // ============================================================================
@@ -508,6 +627,399 @@ TEST_CASE("dump pretty indents") {
     CHECK(pretty.find("  ") != std::string::npos);
 }
 
+TEST_CASE("dump writes the shortest float that reads back") {
+    CHECK(json(0.1).dump() == "0.1");
+    CHECK(json(0.00001234).dump() == "1.234e-05");
+    CHECK(json(2.0).dump() == "2");
+    CHECK(json(-1.5e300).dump() == "-1.5e+300");
+    CHECK(json(std::nan("")).dump() == "null");
+    for (const double v : {0.29, 1.0 / 3.0, 21e6, 5e-324, 1.7976931348623157e308}) {
+        CAPTURE(v);
+        CHECK(json::parse(json(v).dump()).get<double>() == v);
+    }
+}
+
+TEST_CASE("dump_to appends to what the buffer holds") {
+    std::string out = "[";
+    json({{"hex", std::string(100, 'a') + "\x01\x1f"}, {"n", -12}}).dump_to(out);
+    out += ',';
+    json::dump_string(out, "tab\there");
+    out += ']';
+    const std::string expected =
+        R"([{"hex":")" + std::string(100, 'a') + R"(\u0001\u001f","n":-12},"tab\there"])";
+    CHECK(out == expected);
+}
+
+// ============================================================================
+// incremental_parser
+// ============================================================================
+
+// Parse `src` fed `piece` bytes at a time.
+static json parse_in_pieces(std::string_view src, size_t piece) {
+    json::incremental_parser p;
+    for (size_t i = 0; i < src.size(); i += piece)
+        p.feed(src.substr(i, piece));
+    return p.finish();
+}
+
+TEST_CASE("incremental_parser matches parse() however the text is cut") {
+    const std::string src =
+        R"({"result":{"txs":[{"fee":0.0001234,"vsize":141,"depends":[]},)"
+        R"({"fee":1e-05,"vsize":-2,"note":"a\"b\\c\u00e9"}],"ok":true,"none":null},)"
+        R"( "error" : null , "id" : 12345678901 })";
+    const std::string expected = json::parse(src).dump();
+    for (size_t piece = 1; piece <= src.size(); ++piece)
+        CHECK(parse_in_pieces(src, piece).dump() == expected);
+}
+
+TEST_CASE("incremental_parser completes a trailing number at finish()") {
+    json::incremental_parser p;
+    p.feed(" 4");
+    p.feed("2");
+    CHECK(!p.done());
+    CHECK(p.finish().get<int>() == 42);
+}
+
+TEST_CASE("incremental_parser streams the elements of one member") {
+    std::vector<std::string> seen;
+    json::incremental_parser p;
+    p.stream("result", [&](std::string_view key, json&& v) {
+        seen.push_back(std::string(key) + "=" + v.dump());
+    });
+    const std::string src = R"({"result":{"aa":{"vsize":1},"bb":[2]},"error":{"code":1},"id":1})";
+    for (char c : src)
+        p.feed(std::string_view(&c, 1));
+    json doc = p.finish();
+
+    CHECK(seen == std::vector<std::string>{R"(aa={"vsize":1})", "bb=[2]"});
+    CHECK(doc["result"].is_object());
+    CHECK(doc["result"].empty());
+    CHECK(doc["error"]["code"].get<int>() == 1); // other containers are kept
+}
+
+TEST_CASE("incremental_parser streams a root array") {
+    std::vector<int>         seen;
+    json::incremental_parser p;
+    p.stream("", [&](std::string_view key, json&& v) {
+        CHECK(key.empty());
+        seen.push_back(v.get<int>());
+    });
+    p.feed("[1,2,");
+    CHECK(seen == std::vector<int>{1, 2}); // before the text is complete
+    p.feed("3]");
+    CHECK(p.finish().empty());
+    CHECK(seen == std::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("incremental_parser errors throw json::exception") {
+    for (const char* bad : {"", "{", "[", "tru", "nul", R"("unterminated)", "42 extra",
+                            R"({"k":})", "[1,]", "[1 2]", R"({"k" 1})", "{1:2}", "]", "[}"}) {
+        CAPTURE(bad);
+        CHECK_THROWS_AS(parse_in_pieces(bad, 1), json::exception);
+        CHECK_THROWS_AS(parse_in_pieces(bad, 64), json::exception);
+    }
+}
+
+// ============================================================================
+// parse_document
+// ============================================================================
+
+TEST_CASE("parse_document reads like parse()") {
+    const std::string src =
+        R"({"b":[1,2.5,"x\ty",{"k":null}],"a":{"z":true,"y":false},"a":{"dup":1},"e":"",)"
+        R"("n":-12345678901,"s":"plain"})";
+    const json heap = json::parse(src);
+    const json doc  = json::parse_document(src);
+    CHECK(doc.dump() == heap.dump());
+    CHECK(doc.is_object());
+    CHECK(doc.size() == 5);
+    CHECK(doc["a"]["dup"].get<int>() == 1); // the last of duplicate keys wins
+    CHECK(!doc.contains("missing"));
+    CHECK(doc["missing"].is_null());
+    CHECK(doc["b"][2].get<std::string>() == "x\ty");
+    CHECK(doc["b"].end() - doc["b"].begin() == 4);
+    CHECK(doc.value("n", int64_t{0}) == -12345678901LL);
+    CHECK(doc.value("s", "") == "plain");
+    CHECK(doc.value("e", "?").empty());
+
+    std::vector<std::string> keys;
+    for (const auto& [k, v] : doc.items())
+        keys.emplace_back(k);
+    CHECK(keys == std::vector<std::string>{"a", "b", "e", "n", "s"});
+}
+
+TEST_CASE("parse_document leaves plain strings in the text") {
+    const json       doc = json::parse_document(R"({"s":"plain","t":"esc\"aped"})");
+    const json       copy(doc);
+    std::string_view s = doc["s"].get<std::string_view>();
+    CHECK(s == "plain");
+    CHECK(copy["s"].get<std::string_view>().data() == s.data()); // copies share the document
+    CHECK(json(doc["s"]).get<std::string_view>().data() != s.data()); // a node's copy does not
+    CHECK(doc["t"].get<std::string>() == "esc\"aped");
+}
+
+TEST_CASE("parse_document handles are read-only") {
+    json doc = json::parse_document(R"({"list":[1,2],"name":"n"})");
+    CHECK_THROWS_AS(doc["extra"] = true, json::exception);
+    CHECK_THROWS_AS(doc.begin(), json::exception);
+    json arr = json::parse_document("[1,2,3]");
+    CHECK_THROWS_AS(arr[0] = 10, json::exception);
+    CHECK(doc.dump() == R"({"list":[1,2],"name":"n"})");
+
+    // Reads through a const reference, or off a temporary.
+    int sum = 0;
+    for (const auto& v : std::as_const(arr))
+        sum += v.get<int>();
+    CHECK(sum == 6);
+    CHECK(json::parse_document(R"({"list":[1,2]})")["list"][1].get<int>() == 2);
+    const json list = json::parse_document(R"({"list":[1,2]})")["list"];
+    CHECK(list.dump() == "[1,2]");
+    CHECK(json::parse_document("[[3]]")[0].dump() == "[3]");
+
+    // copy() gives a value that can be changed.
+    json changed       = doc.copy();
+    changed["list"][0] = 10;
+    changed["extra"]   = true;
+    CHECK(changed.dump() == R"({"extra":true,"list":[10,2],"name":"n"})");
+    CHECK(doc.dump() == R"({"list":[1,2],"name":"n"})");
+}
+
+TEST_CASE("share() keeps a part of a document alive") {
+    json part;
+    {
+        const json doc = json::parse_document(R"({"result":{"height":5,"hash":"00ab"}})");
+        part           = doc.share(doc["result"]);
+    }
+    CHECK(part.is_object());
+    CHECK(std::as_const(part)["hash"].get<std::string>() == "00ab");
+    CHECK(part.dump() == R"({"hash":"00ab","height":5})");
+
+    const json heap = json::parse(R"({"a":[1]})");
+    CHECK(heap.share(heap["a"]).dump() == "[1]"); // not a document: a copy
+}
+
+TEST_CASE("parse_document shares key tables between objects of one shape") {
+    const std::string src =
+        R"([{"id":1,"addr":"a","in":true},{"id":2,"addr":"b","in":false},)"
+        R"({"addr":"c","id":3,"in":true},{"id":4,"addr":"d","in":true,"id":5},)"
+        R"({"id":6,"addr":"e","in":false,"id":7},{"id":8,"addr":"f"},)"
+        R"({"i\u0064":9,"addr":"g","in":true}])";
+    const json doc = json::parse_document(src);
+    CHECK(doc.dump() == json::parse(src).dump());
+
+    // Where each object's first key (in key order) points: one table per shape.
+    auto table = [&](size_t i) { return (*doc[i].items().begin()).first.data(); };
+    CHECK(table(1) == table(0));
+    CHECK(table(2) != table(0)); // the same keys in another order
+    CHECK(table(4) == table(3)); // duplicate keys, the same shape
+    CHECK(table(3) != table(0));
+    CHECK(table(5) != table(0));
+    CHECK(table(6) == table(0)); // keys are compared unescaped
+
+    CHECK(doc[1]["id"].get<int>() == 2);
+    CHECK(doc[2]["addr"].get<std::string>() == "c");
+    CHECK(doc[3].size() == 3);
+    CHECK(doc[3]["id"].get<int>() == 5); // the last of duplicate keys wins
+    CHECK(doc[4]["id"].get<int>() == 7);
+    CHECK(doc[4]["addr"].get<std::string>() == "e");
+    CHECK(!doc[5].contains("in"));
+    CHECK(doc[6]["id"].get<int>() == 9);
+}
+
+TEST_CASE("parse_document errors throw json::exception") {
+    CHECK_THROWS_AS(json::parse_document(R"({"a":)"), json::exception);
+    CHECK_THROWS_AS(json::parse_document("[1,]"), json::exception);
+    CHECK_THROWS_AS(json::parse_document("1 2"), json::exception);
+}
+
+// ============================================================================
+// sax_parse / sax_parser
+// ============================================================================
+
+// Writes every event down, one token per event.
+struct EventLog : json::sax_handler {
+    std::string log;
+
+    void null() override { log += "null "; }
+    void boolean(bool v) override { log += v ? "true " : "false "; }
+    void number_integer(int64_t v) override { log += "i" + std::to_string(v) + " "; }
+    void number_float(double v) override { log += "f" + std::to_string(v) + " "; }
+    void string(std::string_view v) override { log += "s:" + std::string(v) + " "; }
+    void key(std::string_view k) override { log += "k:" + std::string(k) + " "; }
+    void start_object() override { log += "{ "; }
+    void end_object() override { log += "} "; }
+    void start_array() override { log += "[ "; }
+    void end_array() override { log += "] "; }
+};
+
+TEST_CASE("sax_parse reports events in document order") {
+    EventLog events;
+    json::sax_parse(R"({"a":[1,2.5,"x\ty"],"b":{},"c":null,"d":false})", events);
+    CHECK(events.log == "{ k:a [ i1 f2.500000 s:x\ty ] k:b { } k:c null k:d false } ");
+}
+
+TEST_CASE("sax_parser reports the same events however the text is cut") {
+    const std::string src = R"([{"k\u00e9y":"v\"al","n":-12},[],true,1e3])";
+    EventLog          whole;
+    json::sax_parse(src, whole);
+    for (size_t piece = 1; piece <= src.size(); ++piece) {
+        EventLog         events;
+        json::sax_parser p(events);
+        for (size_t i = 0; i < src.size(); i += piece)
+            p.feed(std::string_view(src).substr(i, piece));
+        p.finish();
+        CHECK(events.log == whole.log);
+    }
+}
+
+TEST_CASE("sax_parser tracks nesting depth") {
+    struct Depths : json::sax_handler {
+        json::sax_parser*   parser = nullptr;
+        std::vector<size_t> at_numbers;
+        void number_integer(int64_t) override { at_numbers.push_back(parser->depth()); }
+    } depths;
+    json::sax_parser p(depths);
+    depths.parser = &p;
+    p.feed(R"([1,{"a":[2]},3])");
+    p.finish();
+    CHECK(depths.at_numbers == std::vector<size_t>{1, 3, 1});
+}
+
+TEST_CASE("sax_parse errors throw json::exception") {
+    json::sax_handler ignore;
+    for (const char* bad : {"", "[1,]", R"({"a" 1})", "[1 2]", "{}}", "nul"}) {
+        CAPTURE(bad);
+        CHECK_THROWS_AS(json::sax_parse(bad, ignore), json::exception);
+    }
+}
+
+// ============================================================================
+// cursor
+// ============================================================================
+
+TEST_CASE("cursor reads fields like a parsed document") {
+    const std::string text =
+        R"( {"result":{"hash":"00ab","height":884231,"difficulty":1.5e14,"pruned":false,)"
+        R"("tx":["c0","t1","t2"],"fees":{"base":0.00001234},"name":"a\"b","none":null},)"
+        R"("error":null,"id":7} )";
+    const json::cursor reply(text);
+    const json::cursor r = reply["result"];
+    CHECK(r.is_object());
+    CHECK(reply["error"].is_null());
+    CHECK(reply["id"].get<int>() == 7);
+    CHECK(r.value("hash", "") == "00ab");
+    CHECK(r.value("height", 0LL) == 884231);
+    CHECK(r.value("difficulty", 0.0) == 1.5e14);
+    CHECK(r.value("pruned", true) == false);
+    CHECK(r["fees"]["base"].get_sats() == 1234);
+    CHECK(r["tx"][0].get<std::string>() == "c0");
+    CHECK(r["tx"].size() == 3);
+    CHECK(r.value("name", "") == "a\"b"); // escaped key and value
+    CHECK(r.contains("none"));
+    CHECK(r["none"].is_null());
+    CHECK(!r.contains("missing"));
+    CHECK(r["missing"].is_null());
+    CHECK(r["missing"]["deeper"].is_null());
+    CHECK(r.value("missing", 5) == 5);
+    CHECK(r["tx"].raw() == R"(["c0","t1","t2"])");
+    CHECK(r.size() == 8);
+    CHECK(r.to_json().dump() == json::parse(text)["result"].dump());
+
+    std::vector<std::string> txids;
+    for (const auto& tx : r["tx"])
+        txids.push_back(tx.get<std::string>());
+    CHECK(txids == std::vector<std::string>{"c0", "t1", "t2"});
+    CHECK(json::cursor("[]").begin() == json::cursor("[]").end());
+}
+
+TEST_CASE("cursor finds members in any order") {
+    const json::cursor o(R"({"a":1,"b":{"x":[1,{"y":"}"}]},"c":3,"d":4})");
+    // In order, out of order, and the same one twice.
+    for (const char* key : {"a", "b", "c", "d", "b", "a", "d", "d", "c"}) {
+        CAPTURE(key);
+        CHECK(o.contains(key));
+    }
+    CHECK(o["d"].get<int>() == 4);
+    CHECK(o["a"].get<int>() == 1);
+    CHECK(o["b"]["x"][1]["y"].get<std::string>() == "}");
+}
+
+TEST_CASE("cursor reads past damage it does not reach") {
+    const json::cursor o(R"({"a":1,"b":[1,2,"x)");
+    CHECK(o["a"].get<int>() == 1);
+    CHECK_THROWS_AS(o["b"], json::exception);
+    CHECK_THROWS_AS(o["b"].size(), json::exception);
+    CHECK_THROWS_AS(json::cursor(R"({"a":tru})")["a"].get<bool>(), json::exception);
+    CHECK_THROWS_AS(json::cursor(R"({"a" 1})")["a"], json::exception);
+    CHECK_THROWS_AS(json::cursor("[1,2]")[2], json::exception);
+    CHECK_THROWS_AS(json::cursor("  "), json::exception);
+}
+
+// ============================================================================
+// Typed binding
+// ============================================================================
+
+namespace {
+struct Bound {
+    int64_t     n = -1;
+    double      x = -1.0;
+    bool        b = false;
+    std::string s = "unset";
+    int         seen_tags = 0;
+};
+} // namespace
+
+template <> struct json_binding<Bound> {
+    static constexpr std::array fields = {
+        json_member<&Bound::n>("n"),
+        json_member<&Bound::x>("x"),
+        json_member<&Bound::b>("b"),
+        json_member<&Bound::s>("s\"q"),
+        json_field<Bound>{"tags",
+                          [](Bound& o, const json& v) { o.seen_tags = static_cast<int>(v.size()); }},
+    };
+};
+
+TEST_CASE("json_bind reads the members a struct takes, from a document or a text") {
+    const std::string text =
+        R"({"other":{"n":99},"n":42,"x":2,"b":true,"s\"q":"text","tags":[1,2,3],"z":null})";
+    Bound from_doc;
+    json_bind(json::parse(text), from_doc);
+    Bound from_text;
+    json_bind(json::cursor(text), from_text);
+    for (const Bound* o : {&from_doc, &from_text}) {
+        CHECK(o->n == 42);
+        CHECK(o->x == 2.0);
+        CHECK(o->b);
+        CHECK(o->s == "text"); // an escaped name
+        CHECK(o->seen_tags == 3);
+    }
+}
+
+TEST_CASE("json_bind leaves members of another type as they were") {
+    Bound o;
+    json_bind(json::cursor(R"({"n":"42","x":null,"b":1,"s\"q":7})"), o);
+    CHECK(o.n == -1);
+    CHECK(o.x == -1.0);
+    CHECK(!o.b);
+    CHECK(o.s == "unset");
+    json_bind(json::parse("[1]"), o); // not an object
+    CHECK(o.n == -1);
+}
+
+TEST_CASE("json_bind_array reads each element into a fresh struct") {
+    const std::string text = R"([{"n":1},{"x":0.5},7])";
+    for (const auto& all : {json_bind_array<Bound>(json::parse(text)),
+                            json_bind_array<Bound>(json::cursor(text))}) {
+        REQUIRE(all.size() == 3);
+        CHECK(all[0].n == 1);
+        CHECK(all[1].n == -1);
+        CHECK(all[1].x == 0.5);
+        CHECK(all[2].s == "unset");
+    }
+    CHECK(json_bind_array<Bound>(json::cursor("{}")).empty());
+}
+
 // ============================================================================
 // Bitcoin Core RPC response shape (integration-style)
 // ============================================================================
@@ -870,6 +1382,6 @@ TEST_CASE("getdeploymentinfo response shape") {
     // items() iteration collects all deployment names
     std::vector<std::string> names;
     for (const auto& [name, _] : dep.items())
-        names.push_back(name);
+        names.emplace_back(name);
     CHECK(names.size() == 3);
 }
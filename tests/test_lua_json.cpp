@@ -0,0 +1,104 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "json.hpp"
+#include "lua_json.hpp"
+
+#include <memory>
+#include <string>
+
+extern "C" {
+#include "lauxlib.h"
+#include "lua.h"
+}
+
+using LuaPtr = std::unique_ptr<lua_State, decltype(&lua_close)>;
+
+static LuaPtr new_lua() { return {luaL_newstate(), &lua_close}; }
+
+// Whether the values at stack indices `a` and `b` are equal, tables compared
+// member by member.
+static bool same(lua_State* L, int a, int b) {
+    a = lua_absindex(L, a);
+    b = lua_absindex(L, b);
+    if (lua_type(L, a) != lua_type(L, b))
+        return false;
+    if (!lua_istable(L, a))
+        return lua_rawequal(L, a, b) || (lua_isnumber(L, a) && lua_compare(L, a, b, LUA_OPEQ));
+    if (lua_rawlen(L, a) != lua_rawlen(L, b))
+        return false;
+    for (int pass = 0; pass < 2; ++pass) { // every key of a is in b, then every key of b in a
+        const int from = pass ? b : a;
+        const int to   = pass ? a : b;
+        lua_pushnil(L);
+        while (lua_next(L, from)) {
+            lua_pushvalue(L, -2);
+            lua_rawget(L, to);
+            const bool ok = same(L, -1, -2);
+            lua_pop(L, 2);
+            if (!ok) {
+                lua_pop(L, 1);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// push_json_result on `reply` gives what push_json gives on its parsed result.
+static bool pushes_like_push_json(const std::string& reply) {
+    auto       lua = new_lua();
+    lua_State* L   = lua.get();
+    lua_pushinteger(L, 7); // something below, as a coroutine's stack might hold
+    const json parsed = json::parse(reply);
+    push_json(L, parsed["result"]);
+    push_json_result(L, reply);
+    return lua_gettop(L) == 3 && same(L, 2, 3) && lua_tointeger(L, 1) == 7;
+}
+
+TEST_CASE("push_json_result builds the Lua values push_json does") {
+    CHECK(pushes_like_push_json(R"({"result":null,"error":null,"id":1})"));
+    CHECK(pushes_like_push_json(R"({"result":5,"error":null,"id":1})"));
+    CHECK(pushes_like_push_json(R"({"error":null,"id":1,"result":"xé\n"})"));
+    CHECK(pushes_like_push_json(R"({"result":[],"error":null})"));
+    CHECK(pushes_like_push_json(R"({"result":{},"error":null})"));
+    CHECK(pushes_like_push_json(R"({"result":[1,null,[2,[3,{}]],{"a":null,"b":[]}]})"));
+    CHECK(pushes_like_push_json(R"({"result":{"a":1,"b":2,"a":3,"c":{"a":[true,1.5,-2]}}})"));
+
+    auto       lua = new_lua();
+    lua_State* L   = lua.get();
+    push_json_result(L, R"({"error":null,"id":1})");
+    CHECK(lua_gettop(L) == 1);
+    CHECK(lua_isnil(L, 1));
+    CHECK_THROWS_AS(push_json_result(L, R"({"result":[1,2,}],"error":null})"), json::exception);
+}
+
+TEST_CASE("push_json_result builds containers larger than a Lua stack holds") {
+    // More elements than LUAI_MAXSTACK (a million) slots, and more members
+    // than the values a container keeps on the stack before its table is made.
+    std::string big = R"({"result":[)";
+    for (int i = 0; i < 1100000; ++i)
+        big += (i ? "," : "") + std::to_string(i);
+    big += "]}";
+
+    auto       lua = new_lua();
+    lua_State* L   = lua.get();
+    push_json_result(L, big);
+    REQUIRE(lua_gettop(L) == 1);
+    REQUIRE(lua_istable(L, 1));
+    CHECK(lua_rawlen(L, 1) == 1100000);
+    lua_rawgeti(L, 1, 1);
+    CHECK(lua_tointeger(L, -1) == 0);
+    lua_rawgeti(L, 1, 1100000);
+    CHECK(lua_tointeger(L, -1) == 1099999);
+
+    std::string members = R"({"result":{"dup":0)";
+    for (int i = 0; i < 10000; ++i)
+        members += R"(,"k)" + std::to_string(i) + R"(":[)" + std::to_string(i) + "]";
+    members += R"(,"dup":1},"error":null})";
+    CHECK(pushes_like_push_json(members));
+    std::string nested = R"({"result":[)";
+    for (int i = 0; i < 3; ++i)
+        nested += (i ? "," : "") + members.substr(10, members.size() - 10 - 14);
+    nested += "]}";
+    CHECK(pushes_like_push_json(nested));
+}
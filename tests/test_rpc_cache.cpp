@@ -0,0 +1,182 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "rpc_cache.hpp"
+#include "rpc_client.hpp"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+static json reply_of(json result) {
+    return json({{"result", std::move(result)}, {"error", nullptr}});
+}
+
+// Records every delivery made to it.
+struct Sink {
+    std::vector<json>        replies;
+    std::vector<std::string> errors;
+
+    RpcCache::Callback cb() {
+        return [this](std::exception_ptr err, json reply) {
+            if (!err) {
+                replies.push_back(std::move(reply));
+                return;
+            }
+            try {
+                std::rethrow_exception(err);
+            } catch (const std::exception& e) {
+                errors.emplace_back(e.what());
+            }
+        };
+    }
+};
+
+// ============================================================================
+// Single-flight
+// ============================================================================
+
+TEST_CASE("RpcCache — identical calls in flight share one reply") {
+    RpcCache cache;
+    Sink     a, b, other;
+
+    auto lead = cache.join("getnetworkinfo", json::array(), a.cb());
+    REQUIRE(lead);
+    CHECK_FALSE(cache.join("getnetworkinfo", json::array(), b.cb()));
+    CHECK(cache.join("getblockhash", {1}, other.cb())); // different params lead their own call
+
+    cache.resolve(*lead, nullptr, reply_of("net"));
+    REQUIRE(a.replies.size() == 1);
+    REQUIRE(b.replies.size() == 1);
+    CHECK(b.replies[0]["result"].get<std::string>() == "net");
+    CHECK(other.replies.empty());
+
+    auto st = cache.stats();
+    CHECK(st.misses == 2);
+    CHECK(st.coalesced == 1);
+}
+
+TEST_CASE("RpcCache — errors reach every waiter but are not cached") {
+    RpcCache cache;
+    Sink     a, b, c;
+
+    auto lead = cache.join("getmempoolinfo", json::array(), a.cb());
+    REQUIRE(lead);
+    CHECK_FALSE(cache.join("getmempoolinfo", json::array(), b.cb()));
+    cache.resolve(*lead, std::make_exception_ptr(RpcError("Loading block index…")), json());
+    CHECK(a.errors.size() == 1);
+    CHECK(b.errors.size() == 1);
+
+    CHECK(cache.join("getmempoolinfo", json::array(), c.cb()));
+}
+
+TEST_CASE("RpcCache — methods without a policy pass straight through") {
+    RpcCache cache;
+    CHECK_FALSE(cache.handles("sendrawtransaction"));
+    CHECK_FALSE(cache.handles("listbanned"));
+    CHECK(cache.handles("getpeerinfo"));
+    cache.exclude("getpeerinfo");
+    CHECK_FALSE(cache.handles("getpeerinfo"));
+}
+
+TEST_CASE("RpcCache — only a TTL above zero keeps replies") {
+    RpcCache cache;
+    CHECK(cache.keeps("getblockchaininfo"));
+    CHECK_FALSE(cache.keeps("getrawmempool")); // coalesced only
+    CHECK_FALSE(cache.keeps("sendrawtransaction"));
+    cache.set_ttl("getrawmempool", 1s);
+    CHECK(cache.keeps("getrawmempool"));
+}
+
+// ============================================================================
+// TTL
+// ============================================================================
+
+TEST_CASE("RpcCache — a reply is served from memory until its TTL runs out") {
+    RpcCache cache;
+    cache.set_ttl("uptime", 50ms);
+    Sink a, b, c;
+
+    auto lead = cache.join("uptime", json::array(), a.cb());
+    REQUIRE(lead);
+    cache.resolve(*lead, nullptr, reply_of(42));
+
+    CHECK_FALSE(cache.join("uptime", json::array(), b.cb()));
+    REQUIRE(b.replies.size() == 1); // delivered before join returned
+    CHECK(b.replies[0]["result"].get<int>() == 42);
+    CHECK(cache.stats().hits == 1);
+
+    std::this_thread::sleep_for(80ms);
+    CHECK(cache.join("uptime", json::array(), c.cb()));
+}
+
+TEST_CASE("RpcCache — a zero TTL coalesces without caching") {
+    RpcCache cache;
+    Sink     a, b;
+    auto     lead = cache.join("getrawmempool", json::array(), a.cb());
+    REQUIRE(lead);
+    cache.resolve(*lead, nullptr, reply_of(json::array()));
+    CHECK(cache.join("getrawmempool", json::array(), b.cb()));
+}
+
+// ============================================================================
+// Tip invalidation
+// ============================================================================
+
+static void see_tip(RpcCache& cache, const std::string& hash) {
+    Sink sink;
+    auto lead = cache.join("getbestblockhash", json::array(), sink.cb());
+    if (lead)
+        cache.resolve(*lead, nullptr, reply_of(hash));
+    cache.clear(); // only the tip matters here, not the cached getbestblockhash
+}
+
+TEST_CASE("RpcCache — a new tip drops cached replies") {
+    RpcCache cache;
+    Sink     a, b, c;
+    see_tip(cache, "aa");
+
+    auto lead = cache.join("getblockhash", {5}, a.cb());
+    REQUIRE(lead);
+    cache.resolve(*lead, nullptr, reply_of("h5"));
+    CHECK_FALSE(cache.join("getblockhash", {5}, b.cb()));
+
+    // getblockchaininfo carries the tip too.
+    auto info = cache.join("getblockchaininfo", json::array(), a.cb());
+    REQUIRE(info);
+    cache.resolve(*info, nullptr, reply_of({{"bestblockhash", "bb"}}));
+    CHECK(cache.join("getblockhash", {5}, c.cb()));
+
+    // ...and its own reply, which reported the new tip, stays cached.
+    CHECK_FALSE(cache.join("getblockchaininfo", json::array(), c.cb()));
+}
+
+TEST_CASE("RpcCache — a malformed tip still reaches every waiter") {
+    RpcCache cache;
+    Sink     a, b;
+    see_tip(cache, "aa");
+
+    auto lead = cache.join("getblockchaininfo", json::array(), a.cb());
+    REQUIRE(lead);
+    CHECK_FALSE(cache.join("getblockchaininfo", json::array(), b.cb()));
+    cache.resolve(*lead, nullptr, reply_of({{"bestblockhash", 5}}));
+    CHECK(a.replies.size() == 1);
+    CHECK(b.replies.size() == 1);
+    CHECK(a.errors.empty());
+    CHECK(b.errors.empty());
+}
+
+TEST_CASE("RpcCache — a reply sent before a tip change is not cached") {
+    RpcCache cache;
+    Sink     a, b;
+    see_tip(cache, "aa");
+
+    auto stale = cache.join("getblock", {"h"}, a.cb());
+    REQUIRE(stale);
+    see_tip(cache, "bb");
+    cache.resolve(*stale, nullptr, reply_of("old"));
+    CHECK(a.replies.size() == 1);
+    CHECK(cache.join("getblock", {"h"}, b.cb()));
+}
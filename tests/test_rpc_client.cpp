@@ -0,0 +1,963 @@
+#ifndef _WIN32
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "rpc_client.hpp"
+
+#include "rest_client.hpp"
+#include "rpc_cache.hpp"
+#include "rpc_engine.hpp"
+#include "rpc_recording.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Minimal loopback HTTP/1.1 server: answers every POST with the body returned by
+// `reply`, framed as configured, and every GET (REST) with the status and body
+// from `on_get`. Each connection is served on its own thread.
+struct LoopbackServer {
+    enum class Framing { ContentLength, Chunked };
+
+    std::function<std::string(const std::string&)>                 reply;
+    std::function<void(const std::string&)>                         on_headers; // request headers
+    std::function<std::pair<int, std::string>(const std::string&)> on_get;     // target -> reply
+    Framing                                                        framing = Framing::ContentLength;
+    bool close_after_each  = false; // silently drop the socket after every response
+    bool send_conn_close   = false; // advertise "Connection: close"
+    bool drop_second       = false; // close a connection on its second request, unanswered
+    std::atomic<int> accepted{0};
+    std::atomic<int> requests{0};
+    std::atomic<int> active{0};      // requests currently being answered
+    std::atomic<int> peak_active{0}; // high-water mark of `active`
+    int              delay_ms = 0;   // hold every reply this long
+    int              port     = 0;
+
+    explicit LoopbackServer(std::function<std::string(const std::string&)> fn)
+        : reply(std::move(fn)) {
+        listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        int one    = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family      = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        listen(listen_fd_, 8);
+        socklen_t len = sizeof(addr);
+        getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port    = ntohs(addr.sin_port);
+        thread_ = std::thread([this] { serve(); });
+    }
+
+    ~LoopbackServer() {
+        stop_ = true;
+        shutdown(listen_fd_, SHUT_RDWR);
+        close(listen_fd_);
+        thread_.join();
+        for (auto& t : workers_)
+            t.join();
+    }
+
+    RpcConfig config() const {
+        RpcConfig cfg;
+        cfg.port            = port;
+        cfg.timeout_seconds = 5;
+        return cfg;
+    }
+
+  private:
+    int               listen_fd_ = -1;
+    std::atomic<bool> stop_{false};
+    std::thread       thread_;
+    std::vector<std::thread> workers_;
+
+    void serve() {
+        while (!stop_) {
+            int fd = accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0)
+                return;
+            ++accepted;
+            workers_.emplace_back([this, fd] {
+                handle(fd);
+                close(fd);
+            });
+        }
+    }
+
+    void handle(int fd) {
+        std::string buf;
+        char        tmp[4096];
+        for (int served = 0;; ++served) {
+            size_t hdr_end;
+            while ((hdr_end = buf.find("\r\n\r\n")) == std::string::npos) {
+                ssize_t n = recv(fd, tmp, sizeof(tmp), 0);
+                if (n <= 0)
+                    return;
+                buf.append(tmp, static_cast<size_t>(n));
+            }
+            size_t cl_pos = buf.find("Content-Length: ");
+            size_t len    = cl_pos < hdr_end ? std::stoul(buf.substr(cl_pos + 16)) : 0;
+            while (buf.size() < hdr_end + 4 + len) {
+                ssize_t n = recv(fd, tmp, sizeof(tmp), 0);
+                if (n <= 0)
+                    return;
+                buf.append(tmp, static_cast<size_t>(n));
+            }
+            if (on_headers)
+                on_headers(buf.substr(0, hdr_end));
+            std::string body = buf.substr(hdr_end + 4, len);
+            std::string line = buf.substr(0, buf.find("\r\n"));
+            buf.erase(0, hdr_end + 4 + len);
+            ++requests;
+            if (drop_second && served == 1)
+                return;
+
+            if (line.rfind("GET ", 0) == 0 && on_get) {
+                const auto  got = on_get(line.substr(4, line.rfind(' ') - 4));
+                std::string out = "HTTP/1.1 " + std::to_string(got.first) +
+                                  " Status\r\nContent-Length: " +
+                                  std::to_string(got.second.size()) + "\r\n\r\n" + got.second;
+                send(fd, out.data(), out.size(), MSG_NOSIGNAL);
+                continue;
+            }
+
+            int now = ++active;
+            for (int peak = peak_active;
+                 now > peak && !peak_active.compare_exchange_weak(peak, now);) {
+            }
+            if (delay_ms)
+                std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+            std::string payload = reply(body);
+            --active;
+            std::string out     = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n";
+            if (send_conn_close)
+                out += "Connection: close\r\n";
+            if (framing == Framing::Chunked) {
+                out += "Transfer-Encoding: chunked\r\n\r\n";
+                // Split into small chunks so the client must stitch them together.
+                for (size_t i = 0; i < payload.size(); i += 7) {
+                    std::string part = payload.substr(i, 7);
+                    char        sz[16];
+                    std::snprintf(sz, sizeof(sz), "%zx\r\n", part.size());
+                    out += sz + part + "\r\n";
+                }
+                out += "0\r\n\r\n";
+            } else {
+                out += "Content-Length: " + std::to_string(payload.size()) + "\r\n\r\n" + payload;
+            }
+            send(fd, out.data(), out.size(), MSG_NOSIGNAL);
+            if (close_after_each || send_conn_close)
+                return;
+        }
+    }
+};
+
+static std::string echo_method(const std::string& body) {
+    auto req = json::parse(body);
+    return json({{"result", req["method"]}, {"error", nullptr}, {"id", req["id"]}}).dump();
+}
+
+// ============================================================================
+// Keep-alive connection reuse
+// ============================================================================
+
+TEST_CASE("RpcClient reuses one connection across calls") {
+    LoopbackServer srv(echo_method);
+    RpcClient      rpc(srv.config(), {"u", "p"});
+
+    CHECK(rpc.call("getblockchaininfo")["result"].get<std::string>() == "getblockchaininfo");
+    CHECK(rpc.call("getnetworkinfo")["result"].get<std::string>() == "getnetworkinfo");
+    CHECK(rpc.call("getmempoolinfo")["result"].get<std::string>() == "getmempoolinfo");
+
+    CHECK(rpc.connection_stats().fresh == 1);
+    CHECK(rpc.connection_stats().reused == 2);
+    CHECK(srv.accepted == 1);
+}
+
+TEST_CASE("RpcClient decodes chunked responses") {
+    LoopbackServer srv(echo_method);
+    srv.framing = LoopbackServer::Framing::Chunked;
+    RpcClient rpc(srv.config(), {"u", "p"});
+
+    CHECK(rpc.call("getpeerinfo")["result"].get<std::string>() == "getpeerinfo");
+    CHECK(rpc.call("getpeerinfo")["result"].get<std::string>() == "getpeerinfo");
+    CHECK(rpc.connection_stats().fresh == 1);
+}
+
+TEST_CASE("RpcClient reconnects transparently when the server drops an idle socket") {
+    LoopbackServer srv(echo_method);
+    srv.close_after_each = true;
+    RpcClient rpc(srv.config(), {"u", "p"});
+
+    for (int i = 0; i < 3; ++i)
+        CHECK(rpc.call("uptime")["result"].get<std::string>() == "uptime");
+
+    CHECK(srv.requests == 3);
+    CHECK(rpc.connection_stats().fresh == 3);
+}
+
+TEST_CASE("RpcClient resends only read-only calls after a stale keep-alive socket") {
+    // The node closes a reused socket once the request is on it, as when its
+    // idle timeout races the send: nothing comes back, and nothing says
+    // whether the call ran.
+    LoopbackServer srv(echo_method);
+    srv.drop_second = true;
+    RpcClient rpc(srv.config(), {"u", "p"});
+
+    CHECK(rpc.call("uptime")["result"].get<std::string>() == "uptime");
+    CHECK(rpc.call("getblockcount")["result"].get<std::string>() == "getblockcount");
+    CHECK(srv.requests == 3); // dropped, then resent on a fresh connection
+    CHECK(srv.accepted == 2);
+
+    CHECK_THROWS_AS(rpc.call("sendrawtransaction", {"00"}), RpcError);
+    CHECK(srv.requests == 4); // not resent: it may have been broadcast
+    CHECK(rpc.call("uptime")["result"].get<std::string>() == "uptime");
+    CHECK(srv.accepted == 3);
+
+    // A caller that knows its calls are safe to repeat can say so.
+    RpcCallOptions repeatable;
+    repeatable.idempotent = true;
+    RpcClient safe(std::make_shared<RpcEngine>(srv.config(), RpcAuth{"u", "p"}), repeatable);
+    safe.call("uptime");
+    CHECK(safe.call("echo")["result"].get<std::string>() == "echo");
+}
+
+TEST_CASE("RpcClient honours Connection: close") {
+    LoopbackServer srv(echo_method);
+    srv.send_conn_close = true;
+    RpcClient rpc(srv.config(), {"u", "p"});
+
+    rpc.call("uptime");
+    rpc.call("uptime");
+    CHECK(rpc.connection_stats().fresh == 2);
+    CHECK(rpc.connection_stats().reused == 0);
+}
+
+TEST_CASE("RpcClient reads bodies larger than one socket read") {
+    // A raw getblock reply is several megabytes; it spans many recv() calls and
+    // must arrive intact with the connection still reusable afterwards.
+    std::string hex(3 * 1024 * 1024 + 17, 'a');
+    for (size_t i = 0; i < hex.size(); i += 61)
+        hex[i] = "0123456789abcdef"[i % 16];
+    LoopbackServer srv([&](const std::string& body) {
+        auto req = json::parse(body);
+        return json({{"result", hex}, {"error", nullptr}, {"id", req["id"]}}).dump();
+    });
+
+    SECTION("Content-Length") {
+        RpcClient rpc(srv.config(), {"u", "p"});
+        CHECK(rpc.call("getblock", {1})["result"].get<std::string>() == hex);
+        CHECK(rpc.call("getblock", {2})["result"].get<std::string>() == hex);
+        CHECK(rpc.connection_stats().reused == 1);
+    }
+    SECTION("chunked") {
+        hex.resize(200 * 1024);
+        srv.framing = LoopbackServer::Framing::Chunked;
+        RpcClient rpc(srv.config(), {"u", "p"});
+        CHECK(rpc.call("getblock", {1})["result"].get<std::string>() == hex);
+        CHECK(rpc.call("getblock", {2})["result"].get<std::string>() == hex);
+        CHECK(rpc.connection_stats().reused == 1);
+    }
+}
+
+TEST_CASE("RpcClient keeps the connection after an RPC-level error") {
+    LoopbackServer srv([](const std::string&) {
+        return std::string(R"({"result":null,"error":{"code":-5,"message":"nope"},"id":1})");
+    });
+    RpcClient rpc(srv.config(), {"u", "p"});
+
+    CHECK_THROWS_AS(rpc.call("getrawtransaction"), RpcError);
+    CHECK_THROWS_AS(rpc.call("getrawtransaction"), RpcError);
+    CHECK(rpc.connection_stats().fresh == 1);
+    CHECK(srv.accepted == 1);
+}
+
+// ============================================================================
+// Streamed results
+// ============================================================================
+
+TEST_CASE("call_streamed hands over result elements without keeping them") {
+    // A verbose getrawmempool-like result, several times the parser's window.
+    const int n       = 20000;
+    json      entries = json::object();
+    for (int i = 0; i < n; ++i)
+        entries["tx" + std::to_string(100000 + i)] = json({{"vsize", i}, {"fee", 1e-05}});
+    LoopbackServer srv([&](const std::string& body) {
+        auto req = json::parse(body);
+        return json({{"result", entries}, {"error", nullptr}, {"id", req["id"]}}).dump();
+    });
+    SECTION("Content-Length") {}
+    SECTION("chunked") { srv.framing = LoopbackServer::Framing::Chunked; }
+    RpcClient rpc(srv.config(), {"u", "p"});
+
+    for (int round = 0; round < 2; ++round) {
+        int  seen    = 0;
+        bool ordered = true;
+        rpc.call_streamed("getrawmempool", {true}, [&](std::string_view key, json&& v) {
+            ordered = ordered && key == "tx" + std::to_string(100000 + seen) &&
+                      v["vsize"].get<int>() == seen;
+            ++seen;
+        });
+        CHECK(seen == n);
+        CHECK(ordered);
+    }
+    CHECK(rpc.connection_stats().reused == 1);
+
+    auto reply = std::promise<json>();
+    rpc.call_streamed("getrawmempool", {true}, [](std::string_view, json&&) {},
+                      [&](std::exception_ptr err, json r) {
+                          CHECK(!err);
+                          reply.set_value(std::move(r));
+                      });
+    auto r = reply.get_future().get();
+    CHECK(r["result"].is_object());
+    CHECK(r["result"].empty());
+}
+
+TEST_CASE("call_text returns the reply for reading on demand") {
+    LoopbackServer srv([](const std::string& body) {
+        auto req = json::parse(body);
+        if (req["method"].get<std::string>() == "getblock")
+            return json({{"result", {{"height", 5}, {"tx", {"c0", "t1"}}}},
+                         {"error", nullptr},
+                         {"id", req["id"]}})
+                .dump();
+        return std::string(R"({"result":null,"error":{"code":-5,"message":"nope"},"id":1})");
+    });
+    RpcClient rpc(srv.config(), {"u", "p"});
+
+    const std::string  text = rpc.call_text("getblock", {"00ab", 1});
+    const json::cursor blk  = json::cursor(text)["result"];
+    CHECK(blk.value("height", 0) == 5);
+    CHECK(blk["tx"][0].get<std::string>() == "c0");
+    CHECK_THROWS_WITH(rpc.call_text("getrawtransaction"), "nope");
+    CHECK(rpc.engine()->cache().stats().misses == 0); // bypasses the cache
+}
+
+TEST_CASE("call_wallet_text_async hands the reply text to a callback") {
+    LoopbackServer srv([](const std::string& body) {
+        if (json::parse(body)["method"].get<std::string>() == "getbalance")
+            return std::string(R"({"result":1.5,"error":null,"id":1})");
+        return std::string(R"({"result":null,"error":{"code":-18,"message":"no wallet"},"id":1})");
+    });
+    std::mutex  mtx;
+    std::string target;
+    srv.on_headers = [&](const std::string& head) {
+        std::lock_guard lock(mtx);
+        target = head.substr(0, head.find("\r\n"));
+    };
+    RpcClient rpc(srv.config(), {"u", "p"});
+
+    auto call = [&](const std::string& method) {
+        std::promise<std::pair<std::string, std::string>> got; // reply, error
+        rpc.call_wallet_text_async("my wallet", method, json::array(),
+                                   [&got](std::exception_ptr err, std::string reply) {
+                                       std::string error;
+                                       try {
+                                           if (err)
+                                               std::rethrow_exception(err);
+                                       } catch (const RpcError& e) {
+                                           error = e.what();
+                                       }
+                                       got.set_value({std::move(reply), std::move(error)});
+                                   });
+        return got.get_future().get();
+    };
+    auto [reply, error] = call("getbalance");
+    CHECK(json::cursor(reply)["result"].get<double>() == 1.5);
+    CHECK(error.empty());
+    {
+        std::lock_guard lock(mtx);
+        CHECK(target == "POST /wallet/my%20wallet HTTP/1.1");
+    }
+    std::tie(reply, error) = call("getwalletinfo");
+    CHECK(reply.empty());
+    CHECK(error == "no wallet");
+}
+
+TEST_CASE("RpcClient fails a malformed response as it arrives") {
+    LoopbackServer srv([](const std::string& body) {
+        if (json::parse(body)["method"].get<std::string>() == "uptime")
+            return echo_method(body);
+        return std::string(R"({"result":[1,2,}],"error":null,"id":1})");
+    });
+    RpcClient rpc(srv.config(), {"u", "p"});
+
+    std::string msg;
+    try {
+        rpc.call("getpeerinfo");
+    } catch (const RpcError& e) {
+        msg = e.what();
+    }
+    CHECK(msg.find("JSON parse error") != std::string::npos);
+    CHECK(rpc.call("uptime")["result"].get<std::string>() == "uptime");
+}
+
+// ============================================================================
+// JSON-RPC batch
+// ============================================================================
+
+// Answers a batch in reverse order; "fail" methods get a per-element error.
+static std::string batch_reply(const std::string& body) {
+    auto          reqs = json::parse(body);
+    json::array_t out;
+    for (size_t i = reqs.size(); i-- > 0;) {
+        const auto& r = reqs[i];
+        if (r["method"].get<std::string>() == "fail")
+            out.push_back({{"result", nullptr},
+                           {"error", {{"code", -32601}, {"message", "Method not found"}}},
+                           {"id", r["id"]}});
+        else
+            out.push_back({{"result", r["params"][0]}, {"error", nullptr}, {"id", r["id"]}});
+    }
+    return json(std::move(out)).dump();
+}
+
+TEST_CASE("call_batch returns results in request order with per-element errors") {
+    LoopbackServer srv(batch_reply);
+    RpcClient      rpc(srv.config(), {"u", "p"});
+
+    auto res = rpc.call_batch({
+        {"getblockstats", {100}},
+        {"fail", {0}},
+        {"getblockstats", {99}},
+    });
+
+    REQUIRE(res.size() == 3);
+    CHECK(res[0].ok());
+    CHECK(res[0].result.get<int>() == 100);
+    CHECK(!res[1].ok());
+    CHECK(res[1].error == "Method not found");
+    CHECK(res[2].ok());
+    CHECK(res[2].result.get<int>() == 99);
+    CHECK(srv.requests == 1);
+}
+
+TEST_CASE("call_batch ids keep advancing across batches") {
+    LoopbackServer srv(batch_reply);
+    RpcClient      rpc(srv.config(), {"u", "p"});
+
+    rpc.call_batch({{"a", {1}}});
+    auto res = rpc.call_batch({{"b", {2}}, {"c", {3}}});
+    REQUIRE(res.size() == 2);
+    CHECK(res[0].result.get<int>() == 2);
+    CHECK(res[1].result.get<int>() == 3);
+    CHECK(rpc.connection_stats().fresh == 1);
+}
+
+TEST_CASE("call_batch with no calls makes no request") {
+    LoopbackServer srv(batch_reply);
+    RpcClient      rpc(srv.config(), {"u", "p"});
+    CHECK(rpc.call_batch({}).empty());
+    CHECK(srv.requests == 0);
+}
+
+TEST_CASE("call_batch surfaces a whole-batch error object") {
+    LoopbackServer srv([](const std::string&) {
+        return std::string(R"({"result":null,"error":{"code":-32700,"message":"Parse error"}})");
+    });
+    RpcClient rpc(srv.config(), {"u", "p"});
+    CHECK_THROWS_AS(rpc.call_batch({{"uptime"}}), RpcError);
+}
+
+// ============================================================================
+// Asynchronous engine
+// ============================================================================
+
+TEST_CASE("call_async keeps several requests in flight at once") {
+    LoopbackServer srv(echo_method);
+    srv.delay_ms = 100;
+    RpcClient rpc(std::make_shared<RpcEngine>(srv.config(), RpcAuth{"u", "p"}, 4));
+
+    const auto                     start = std::chrono::steady_clock::now();
+    std::vector<std::future<json>> futs;
+    for (int i = 0; i < 4; ++i)
+        futs.push_back(rpc.call_async("m" + std::to_string(i)));
+    for (int i = 0; i < 4; ++i)
+        CHECK(futs[i].get()["result"].get<std::string>() == "m" + std::to_string(i));
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    CHECK(srv.peak_active == 4);
+    CHECK(elapsed < std::chrono::milliseconds(350)); // serial would take 400ms
+}
+
+TEST_CASE("RpcEngine caps in-flight requests and queues the rest") {
+    LoopbackServer srv(echo_method);
+    srv.delay_ms = 20;
+    auto      engine = std::make_shared<RpcEngine>(srv.config(), RpcAuth{"u", "p"}, 2);
+    RpcClient rpc(engine);
+
+    std::vector<std::future<json>> futs;
+    for (int i = 0; i < 10; ++i)
+        futs.push_back(rpc.call_async("uptime"));
+    CHECK(engine->in_flight() + engine->queued() <= 10);
+    for (auto& f : futs)
+        CHECK(f.get()["result"].get<std::string>() == "uptime");
+
+    CHECK(srv.peak_active <= 2);
+    CHECK(srv.requests == 10);
+    CHECK(rpc.connection_stats().fresh == 2);
+    CHECK(rpc.connection_stats().reused == 8);
+}
+
+TEST_CASE("call_async callback receives the reply or the RPC error") {
+    LoopbackServer srv([](const std::string& body) {
+        auto req = json::parse(body);
+        if (req["method"].get<std::string>() == "bad")
+            return json({{"result", nullptr},
+                         {"error", {{"code", -1}, {"message", "boom"}}},
+                         {"id", req["id"]}})
+                .dump();
+        return echo_method(body);
+    });
+    RpcClient rpc(srv.config(), {"u", "p"});
+
+    std::promise<std::string> ok, bad;
+    rpc.call_async("good", json::array(), [&](std::exception_ptr err, const json& reply) {
+        ok.set_value(err ? "error" : reply["result"].get<std::string>());
+    });
+    rpc.call_async("bad", json::array(), [&](std::exception_ptr err, json) {
+        try {
+            if (err)
+                std::rethrow_exception(err);
+            bad.set_value("no error");
+        } catch (const RpcError& e) {
+            bad.set_value(e.what());
+        }
+    });
+    CHECK(ok.get_future().get() == "good");
+    CHECK(bad.get_future().get() == "boom");
+}
+
+TEST_CASE("clients sharing an engine get distinct request ids") {
+    std::mutex       mtx;
+    std::vector<int> ids;
+    LoopbackServer   srv([&](const std::string& body) {
+        auto req = json::parse(body);
+        {
+            std::lock_guard lock(mtx);
+            ids.push_back(req["id"].get<int>());
+        }
+        return echo_method(body);
+    });
+    auto      engine = std::make_shared<RpcEngine>(srv.config(), RpcAuth{"u", "p"});
+    RpcClient a(engine);
+    RpcClient b(engine);
+
+    auto fa = a.call_async("a");
+    auto fb = b.call_async("b");
+    fa.get();
+    fb.get();
+    REQUIRE(ids.size() == 2);
+    CHECK(ids[0] != ids[1]);
+}
+
+TEST_CASE("clients sharing an engine coalesce identical read-only calls") {
+    LoopbackServer srv(echo_method);
+    srv.delay_ms = 100;
+    auto      engine = std::make_shared<RpcEngine>(srv.config(), RpcAuth{"u", "p"});
+    RpcClient a(engine);
+    RpcClient b(engine);
+
+    auto fa = a.call_async("getnetworkinfo");
+    auto fb = b.call_async("getnetworkinfo");
+    CHECK(fa.get()["result"].get<std::string>() == "getnetworkinfo");
+    CHECK(fb.get()["result"].get<std::string>() == "getnetworkinfo");
+    CHECK(srv.requests == 1);
+
+    // Answered from the cache while the reply is fresh; writes always go out.
+    CHECK(a.call("getnetworkinfo")["result"].get<std::string>() == "getnetworkinfo");
+    CHECK(srv.requests == 1);
+    a.call("setban");
+    a.call("setban");
+    CHECK(srv.requests == 3);
+    CHECK(engine->cache().stats().coalesced == 1);
+    CHECK(engine->cache().stats().hits == 1);
+}
+
+TEST_CASE("call_batch sends only the elements the cache cannot answer") {
+    std::vector<size_t> sizes;
+    LoopbackServer      srv([&](const std::string& body) {
+        sizes.push_back(json::parse(body).size());
+        return batch_reply(body);
+    });
+    RpcClient rpc(srv.config(), {"u", "p"});
+
+    rpc.call_batch({{"getblockhash", {7}}});
+    auto res = rpc.call_batch({{"getblockhash", {7}}, {"getblockhash", {8}}});
+    REQUIRE(res.size() == 2);
+    CHECK(res[0].result.get<int>() == 7);
+    CHECK(res[1].result.get<int>() == 8);
+    REQUIRE(sizes.size() == 2);
+    CHECK(sizes[1] == 1);
+
+    // Fully cached: no request at all.
+    CHECK(rpc.call_batch({{"getblockhash", {8}}})[0].result.get<int>() == 8);
+    CHECK(srv.requests == 2);
+}
+
+TEST_CASE("RpcEngine fails requests when the node is unreachable") {
+    int port = 0;
+    {
+        LoopbackServer srv(echo_method);
+        port = srv.port;
+    }
+    RpcConfig cfg;
+    cfg.port            = port;
+    cfg.timeout_seconds = 5;
+    RpcClient rpc(cfg, {"u", "p"});
+    CHECK_THROWS_AS(rpc.call("uptime"), RpcError);
+}
+
+TEST_CASE("RpcEngine times out a request the node never answers") {
+    LoopbackServer srv(echo_method);
+    srv.delay_ms        = 1500;
+    RpcConfig cfg       = srv.config();
+    cfg.timeout_seconds = 1;
+    RpcClient rpc(cfg, {"u", "p"});
+
+    std::string msg;
+    try {
+        rpc.call("uptime");
+    } catch (const RpcError& e) {
+        msg = e.what();
+    }
+    CHECK(msg.find("timeout") != std::string::npos);
+}
+
+TEST_CASE("RpcEngine reports queue depth per tag") {
+    LoopbackServer srv(echo_method);
+    srv.delay_ms = 100;
+    auto      engine = std::make_shared<RpcEngine>(srv.config(), RpcAuth{"u", "p"}, 1);
+    RpcClient peers(engine, {"Peers"});
+    RpcClient lua(engine, {"wallet"});
+
+    auto a = peers.call_async("uptime");
+    auto b = peers.call_async("uptime");
+    auto c = lua.call_async("uptime");
+
+    auto depth = engine->queue_depth();
+    CHECK(depth["Peers"].queued + depth["Peers"].in_flight == 2);
+    CHECK(depth["wallet"].queued + depth["wallet"].in_flight == 1);
+    CHECK(engine->in_flight() <= 1);
+
+    a.get();
+    b.get();
+    c.get();
+    CHECK(engine->queue_depth().empty());
+}
+
+TEST_CASE("RpcEngine records latency and bytes per tag and method") {
+    LoopbackServer srv([](const std::string& body) {
+        return body.front() == '[' ? batch_reply(body) : echo_method(body);
+    });
+    auto      engine = std::make_shared<RpcEngine>(srv.config(), RpcAuth{"u", "p"}, 1);
+    RpcClient poll(engine, {"poll"});
+
+    poll.call("uptime");
+    poll.call("uptime");
+    poll.call_batch({{"getblockhash", {2}}, {"getblockheader", {"00"}}, {"getblockhash", {1}}});
+
+    auto snap = engine->stats().snapshot();
+    REQUIRE(snap.contains({"poll", "uptime"}));
+    const auto& uptime = snap.at({"poll", "uptime"});
+    CHECK(uptime.calls == 2);
+    CHECK(uptime.errors == 0);
+    CHECK(uptime.bytes_sent > 0);
+    CHECK(uptime.bytes_received > 0);
+    CHECK(uptime.phase(RpcPhase::Connect).count() == 1); // the second call reused the socket
+    CHECK(uptime.phase(RpcPhase::FirstByte).count() == 2);
+    CHECK(uptime.phase(RpcPhase::Parse).count() == 2);
+    CHECK(snap.contains({"poll", "[getblockhash,getblockheader]"}));
+}
+
+TEST_CASE("RpcEngine::set_auth applies to later requests") {
+    std::mutex               mtx;
+    std::vector<std::string> auth_lines;
+    LoopbackServer           srv(echo_method);
+    srv.on_headers = [&](const std::string& head) {
+        auto pos = head.find("Authorization: Basic ");
+        std::lock_guard lock(mtx);
+        auth_lines.push_back(head.substr(pos + 21, head.find("\r\n", pos) - pos - 21));
+    };
+    auto      engine = std::make_shared<RpcEngine>(srv.config(), RpcAuth{"u", "p"});
+    RpcClient rpc(engine);
+
+    rpc.call("uptime");
+    engine->set_auth({"__cookie__", "secret"});
+    rpc.call("uptime");
+
+    REQUIRE(auth_lines.size() == 2);
+    CHECK(auth_lines[0] == "dTpw"); // base64("u:p")
+    CHECK(auth_lines[1] == "X19jb29raWVfXzpzZWNyZXQ=");
+}
+
+TEST_CASE("RpcEngine::shutdown runs pending completions before returning") {
+    LoopbackServer srv(echo_method);
+    srv.delay_ms = 300;
+    auto      engine = std::make_shared<RpcEngine>(srv.config(), RpcAuth{"u", "p"}, 1);
+    RpcClient rpc(engine);
+
+    std::atomic<int> failed{0};
+    for (int i = 0; i < 3; ++i)
+        rpc.call_async("uptime", json::array(), [&](std::exception_ptr err, json) {
+            if (err)
+                ++failed;
+        });
+    engine->shutdown();
+    CHECK(failed == 3);
+    CHECK_THROWS_AS(rpc.call("uptime"), RpcError);
+}
+
+// ============================================================================
+// Deadlines and cancellation
+// ============================================================================
+
+TEST_CASE("RpcCancelToken wakes waiters and runs callbacks once") {
+    RpcCancelToken token;
+    CHECK_FALSE(token.wait_for(std::chrono::milliseconds(10)));
+
+    int       fired = 0;
+    const int key   = 0;
+    token.on_cancel(&key, [&] { ++fired; });
+    token.on_cancel(&key, [&] { fired += 10; }); // replaces the first
+    const int other = 0;
+    token.on_cancel(&other, [&] { fired += 100; });
+    token.forget(&other);
+
+    std::thread canceller([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        token.cancel();
+    });
+    const auto start = std::chrono::steady_clock::now();
+    CHECK(token.wait_for(std::chrono::seconds(5)));
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(2));
+    canceller.join();
+    CHECK(token.cancelled());
+    CHECK(fired == 10);
+
+    token.on_cancel(&key, [&] { ++fired; }); // already cancelled: runs right away
+    CHECK(fired == 11);
+}
+
+TEST_CASE("RpcEngine fails queued and in-flight requests as soon as they are cancelled") {
+    LoopbackServer srv(echo_method);
+    srv.delay_ms = 600;
+    auto      engine = std::make_shared<RpcEngine>(srv.config(), RpcAuth{"u", "p"}, 1);
+    auto      token  = std::make_shared<RpcCancelToken>();
+    RpcClient rpc(engine, {"t", {}, {}, token});
+
+    auto in_flight = rpc.call_async("uptime");
+    auto queued    = rpc.call_async("echo");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    const auto start = std::chrono::steady_clock::now();
+    token->cancel();
+    CHECK_THROWS_AS(in_flight.get(), RpcCancelled);
+    CHECK_THROWS_AS(queued.get(), RpcCancelled);
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(300));
+    CHECK_THROWS_AS(rpc.call("uptime"), RpcCancelled);
+    CHECK(engine->queue_depth().empty());
+    CHECK(srv.requests == 1);
+
+    // The engine carries on for everyone else.
+    RpcClient other(engine);
+    CHECK(other.call("uptime")["result"].get<std::string>() == "uptime");
+}
+
+TEST_CASE("RpcEngine applies millisecond timeouts and absolute deadlines") {
+    LoopbackServer srv(echo_method);
+    srv.delay_ms = 600;
+    auto engine  = std::make_shared<RpcEngine>(srv.config(), RpcAuth{"u", "p"}, 1);
+
+    SECTION("per-attempt timeout") {
+        RpcClient   rpc(engine, {"t", std::chrono::milliseconds(150)});
+        std::string msg;
+        const auto  start = std::chrono::steady_clock::now();
+        try {
+            rpc.call("uptime");
+        } catch (const RpcError& e) {
+            msg = e.what();
+        }
+        CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(500));
+        CHECK(msg.find("150ms") != std::string::npos);
+    }
+
+    SECTION("a deadline also bounds time spent queued") {
+        const auto  deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(150);
+        RpcClient   busy(engine);
+        auto        blocker = busy.call_async("uptime");
+        RpcClient   rpc(engine, {"t", {}, deadline});
+        std::string msg;
+        try {
+            rpc.call("echo");
+        } catch (const RpcError& e) {
+            msg = e.what();
+        }
+        CHECK(msg.find("queued") != std::string::npos);
+        CHECK(blocker.get()["result"].get<std::string>() == "uptime");
+    }
+}
+
+TEST_CASE("cancelling one caller leaves others sharing the call unaffected") {
+    LoopbackServer srv(echo_method);
+    srv.delay_ms = 300;
+    auto      engine = std::make_shared<RpcEngine>(srv.config(), RpcAuth{"u", "p"});
+    auto      token  = std::make_shared<RpcCancelToken>();
+    RpcClient quitter(engine, {"a", {}, {}, token});
+    RpcClient stayer(engine, {"b"});
+
+    auto gone = quitter.call_async("getnetworkinfo");
+    auto kept = stayer.call_async("getnetworkinfo");
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    token->cancel();
+    CHECK_THROWS_AS(gone.get(), RpcCancelled);
+    CHECK(kept.get()["result"].get<std::string>() == "getnetworkinfo");
+    CHECK(srv.requests == 1);
+}
+
+TEST_CASE("call_batch_async fails with RpcCancelled when cancelled") {
+    LoopbackServer srv(batch_reply);
+    srv.delay_ms = 600;
+    auto      token = std::make_shared<RpcCancelToken>();
+    RpcClient rpc(std::make_shared<RpcEngine>(srv.config(), RpcAuth{"u", "p"}),
+                  {"t", {}, {}, token});
+
+    auto fut = rpc.call_batch_async({{"a", {1}}, {"getblockhash", {2}}});
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    token->cancel();
+    CHECK(fut.wait_for(std::chrono::milliseconds(300)) == std::future_status::ready);
+    CHECK_THROWS_AS(fut.get(), RpcCancelled);
+}
+
+// ============================================================================
+// REST
+// ============================================================================
+
+TEST_CASE("RestClient fetches binary endpoints over the shared engine") {
+    std::vector<std::string> targets;
+    std::mutex               mtx;
+    LoopbackServer           srv(echo_method);
+    srv.on_get = [&](const std::string& target) -> std::pair<int, std::string> {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            targets.push_back(target);
+        }
+        if (target == "/rest/blockhashbyheight/7.bin")
+            return {200, std::string(31, '\0') + '\x01'};
+        if (target == "/rest/mempool/info.json")
+            return {200, R"({"loaded":true,"size":3})"};
+        if (target == "/rest/chaininfo.json")
+            return {200, R"({"chain":"main","blocks":840000,"headers":840001})"};
+        return {404, target + " not found\r\n"};
+    };
+    auto       engine = std::make_shared<RpcEngine>(srv.config(), RpcAuth{"u", "p"});
+    RestClient rest(engine);
+
+    CHECK(rest.blockhash_by_height(7) ==
+          "0100000000000000000000000000000000000000000000000000000000000000");
+    CHECK(rest.mempool_info()["size"].get<int>() == 3);
+    CHECK(rest.block_count() == 840000);
+
+    // A REST-level "not found" carries a message: the interface itself is up.
+    const std::string missing(64, 'a');
+    CHECK_THROWS_AS(rest.block(missing), RpcHttpError);
+    CHECK(rest.available());
+
+    // The JSON-RPC client on the same engine shares the connection.
+    RpcClient rpc(engine);
+    CHECK(rpc.call("getblockcount")["result"].get<std::string>() == "getblockcount");
+    CHECK(srv.accepted == 1);
+
+    std::lock_guard<std::mutex> lock(mtx);
+    CHECK(targets.back() == "/rest/block/" + missing + ".bin");
+}
+
+TEST_CASE("RestClient stops asking once the node shows REST is disabled") {
+    LoopbackServer srv(echo_method);
+    srv.on_get = [](const std::string&) { return std::pair<int, std::string>{404, ""}; };
+    RestClient rest(std::make_shared<RpcEngine>(srv.config(), RpcAuth{"u", "p"}));
+    RestClient copy = rest;
+
+    CHECK_THROWS_AS(rest.blockhash_by_height(1), RestUnavailable);
+    CHECK_FALSE(rest.available());
+    CHECK_FALSE(copy.available());
+
+    CHECK_THROWS_AS(copy.headers(5, std::string(64, '0')), RestUnavailable);
+    CHECK(srv.requests == 1);
+}
+
+TEST_CASE("RestClient rejects malformed hashes without a request") {
+    LoopbackServer srv(echo_method);
+    RestClient     rest(std::make_shared<RpcEngine>(srv.config(), RpcAuth{"u", "p"}));
+
+    CHECK_THROWS_AS(rest.block("../../etc"), RpcError);
+    CHECK(srv.requests == 0);
+}
+
+// ============================================================================
+// Record / replay
+// ============================================================================
+
+TEST_CASE("RpcEngine replays a recorded session without the node") {
+    const auto path = std::filesystem::temp_directory_path() /
+                      ("btui_rpc_recording_" + std::to_string(getpid()));
+    std::filesystem::remove(path);
+
+    int port = 0;
+    {
+        LoopbackServer srv([](const std::string& body) {
+            return body.front() == '[' ? batch_reply(body) : echo_method(body);
+        });
+        srv.on_get = [](const std::string& target) -> std::pair<int, std::string> {
+            return {200, "bin:" + target};
+        };
+        port          = srv.port;
+        auto recorder = std::make_shared<RpcRecorder>(path.string());
+        auto engine   = std::make_shared<RpcEngine>(srv.config(), RpcAuth{"u", "p"});
+        engine->record_to(recorder);
+        RpcClient rpc(engine, {"poll"});
+        rpc.call("uptime");
+        rpc.call_batch({{"getblockhash", {5}}, {"getblockhash", {6}}});
+        CHECK(engine->get("/rest/block/aa.bin").get() == "bin:/rest/block/aa.bin");
+        engine->shutdown();
+        CHECK(recorder->count() == 3);
+    }
+
+    // The node is gone; the same calls are answered from the recording.
+    RpcConfig cfg;
+    cfg.port            = port;
+    cfg.timeout_seconds = 5;
+    auto engine         = std::make_shared<RpcEngine>(cfg, RpcAuth{"u", "p"});
+    auto replay         = RpcReplay::load(path.string(), 0.0);
+    engine->replay_from(replay);
+    RpcClient rpc(engine, {"replay"});
+
+    CHECK(rpc.call("uptime")["result"].get<std::string>() == "uptime");
+    auto res = rpc.call_batch({{"getblockhash", {6}}, {"getblockhash", {5}}});
+    REQUIRE(res.size() == 2);
+    CHECK(res[0].result.get<int>() == 6);
+    CHECK(res[1].result.get<int>() == 5);
+    CHECK(engine->get("/rest/block/aa.bin").get() == "bin:/rest/block/aa.bin");
+    CHECK_THROWS_AS(rpc.call("getblockcount"), RpcError); // never recorded
+    CHECK(replay->misses() == 1);
+    CHECK(engine->connection_stats().fresh == 0);
+    CHECK(engine->stats().snapshot().contains({"replay", "uptime"}));
+
+    engine->shutdown();
+    std::filesystem::remove(path);
+}
+
+#endif // _WIN32
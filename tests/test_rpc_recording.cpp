@@ -0,0 +1,181 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "rpc_recording.hpp"
+
+#include "json.hpp"
+#include "rpc_client.hpp"
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+static RpcExchange post(const std::string& request, const std::string& response,
+                        int status = 200, std::chrono::microseconds duration = 1ms) {
+    RpcExchange ex;
+    ex.tag      = "poll";
+    ex.endpoint = "/";
+    ex.request  = request;
+    ex.status   = status;
+    ex.response = response;
+    ex.duration = duration;
+    return ex;
+}
+
+static RpcExchange rest_get(const std::string& endpoint, int status, const std::string& body) {
+    RpcExchange ex;
+    ex.is_get   = true;
+    ex.endpoint = endpoint;
+    ex.status   = status;
+    ex.response = body;
+    return ex;
+}
+
+// ============================================================================
+// File format
+// ============================================================================
+
+TEST_CASE("RPC recordings round-trip, binary bodies included") {
+    std::vector<RpcExchange> in = {
+        post(R"({"id":1,"method":"getblockcount","params":[]})",
+             R"({"result":900000,"error":null,"id":1})"),
+        rest_get("/rest/block/00.bin", 200, std::string("\0\n\r\nP 1 2", 9)),
+    };
+    in[0].offset = 1500us;
+
+    std::stringstream file;
+    write_rpc_session_header(file);
+    for (const auto& ex : in)
+        write_rpc_exchange(file, ex);
+    write_rpc_session_header(file); // a second session appended to the same file
+    write_rpc_exchange(file, in[0]);
+
+    const auto out = read_rpc_recording(file);
+    REQUIRE(out.size() == 3);
+    CHECK(!out[0].is_get);
+    CHECK(out[0].tag == "poll");
+    CHECK(out[0].request == in[0].request);
+    CHECK(out[0].response == in[0].response);
+    CHECK(out[0].offset == 1500us);
+    CHECK(out[0].duration == 1ms);
+    CHECK(out[1].is_get);
+    CHECK(out[1].endpoint == "/rest/block/00.bin");
+    CHECK(out[1].response == in[1].response);
+    CHECK(out[2].request == in[0].request);
+}
+
+TEST_CASE("RPC recordings drop a record cut short at the end") {
+    std::stringstream file;
+    write_rpc_session_header(file);
+    write_rpc_exchange(file, post("{}", R"({"result":1})"));
+    write_rpc_exchange(file, post("{}", R"({"result":2})"));
+    std::string data = file.str();
+    data.resize(data.size() - 5);
+
+    std::istringstream truncated(data);
+    CHECK(read_rpc_recording(truncated).size() == 1);
+}
+
+TEST_CASE("RPC recordings reject malformed records") {
+    std::istringstream junk("bitcoin-tui-rpc-recording 1 0\nnot a record\n");
+    CHECK_THROWS_AS(read_rpc_recording(junk), RpcError);
+
+    std::istringstream future("bitcoin-tui-rpc-recording 99 0\n");
+    CHECK_THROWS_AS(read_rpc_recording(future), RpcError);
+
+    std::istringstream overlong("P 0 0 200 0 1 2 2\n/{}{}xx\n");
+    CHECK_THROWS_AS(read_rpc_recording(overlong), RpcError);
+}
+
+// ============================================================================
+// RpcReplay
+// ============================================================================
+
+TEST_CASE("RpcReplay answers under the caller's id, in recorded order") {
+    RpcReplay replay({
+        post(R"({"id":7,"method":"getblockcount","params":[]})",
+             R"({"result":100,"error":null,"id":7})"),
+        post(R"({"id":9,"method":"getblockcount","params":[]})",
+             R"({"result":101,"error":null,"id":9})"),
+    });
+    CHECK(replay.calls() == 2);
+
+    auto first = json::parse(
+        replay.answer(false, "/", R"({"id":42,"method":"getblockcount","params":[]})").body);
+    CHECK(first["result"].get<int>() == 100);
+    CHECK(first["id"].get<int>() == 42);
+
+    auto second = replay.answer(false, "/", R"({"id":43,"method":"getblockcount","params":[]})");
+    CHECK(second.status == 200);
+    CHECK(json::parse(second.body)["result"].get<int>() == 101);
+
+    // Past the end of the recording the last answer repeats.
+    auto third = replay.answer(false, "/", R"({"id":44,"method":"getblockcount","params":[]})");
+    CHECK(json::parse(third.body)["result"].get<int>() == 101);
+    CHECK(replay.misses() == 0);
+}
+
+TEST_CASE("RpcReplay matches batch elements one call at a time") {
+    RpcReplay replay({post(
+        R"([{"id":1,"method":"getblockhash","params":[5]},)"
+        R"({"id":2,"method":"getblockhash","params":[6]},)"
+        R"({"id":3,"method":"bad","params":[]}])",
+        R"([{"result":null,"error":{"code":-32601,"message":"Method not found"},"id":3},)"
+        R"({"result":"66","error":null,"id":2},{"result":"55","error":null,"id":1}])")});
+    CHECK(replay.calls() == 3);
+
+    // A different subset, in a different order, under new ids.
+    auto a = replay.answer(false, "/",
+                           R"([{"id":20,"method":"bad","params":[]},)"
+                           R"({"id":21,"method":"getblockhash","params":[5]},)"
+                           R"({"id":22,"method":"getblockhash","params":[7]}])");
+    CHECK(a.status == 200);
+    auto replies = json::parse(a.body);
+    REQUIRE(replies.size() == 3);
+    CHECK(replies[0]["id"].get<int>() == 20);
+    CHECK(replies[0]["error"]["message"].get<std::string>() == "Method not found");
+    CHECK(replies[1]["id"].get<int>() == 21);
+    CHECK(replies[1]["result"].get<std::string>() == "55");
+    CHECK(replies[2]["id"].get<int>() == 22);
+    CHECK(replies[2]["error"]["code"].get<int>() == -32601);
+    CHECK(replay.misses() == 1);
+}
+
+TEST_CASE("RpcReplay keeps params and endpoints apart") {
+    RpcReplay replay({
+        post(R"({"id":1,"method":"getbalance","params":[]})",
+             R"({"result":1.5,"error":null,"id":1})"),
+    });
+    auto other_params = replay.answer(false, "/", R"({"id":2,"method":"getbalance","params":[1]})");
+    CHECK(other_params.status == 500);
+    auto other_wallet =
+        replay.answer(false, "/wallet/w", R"({"id":3,"method":"getbalance","params":[]})");
+    CHECK(other_wallet.status == 500);
+    CHECK(replay.misses() == 2);
+}
+
+TEST_CASE("RpcReplay scales recorded latency by the replay speed") {
+    const auto rec = post(R"({"id":1,"method":"uptime","params":[]})",
+                          R"({"result":5,"error":null,"id":1})", 200, 40ms);
+    const auto ask = R"({"id":2,"method":"uptime","params":[]})";
+    CHECK(RpcReplay({rec}, 1.0).answer(false, "/", ask).delay == 40ms);
+    CHECK(RpcReplay({rec}, 4.0).answer(false, "/", ask).delay == 10ms);
+    CHECK(RpcReplay({rec}, 0.0).answer(false, "/", ask).delay == 0ms);
+}
+
+TEST_CASE("RpcReplay serves REST bodies and 404s what it never saw") {
+    RpcReplay with_rest({rest_get("/rest/chaininfo.json", 200, "{}")});
+    CHECK(with_rest.answer(true, "/rest/chaininfo.json", "").body == "{}");
+    auto missing = with_rest.answer(true, "/rest/block/aa.bin", "");
+    CHECK(missing.status == 404);
+    CHECK(!missing.body.empty()); // REST is up, the object is not
+
+    // No REST traffic recorded: answer like a node without -rest (bare 404).
+    RpcReplay rpc_only({post(R"({"id":1,"method":"uptime","params":[]})",
+                             R"({"result":5,"error":null,"id":1})")});
+    auto disabled = rpc_only.answer(true, "/rest/chaininfo.json", "");
+    CHECK(disabled.status == 404);
+    CHECK(disabled.body.empty());
+}
@@ -0,0 +1,100 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "rpc_stats.hpp"
+
+#include <chrono>
+#include <string>
+
+using namespace std::chrono_literals;
+
+// ============================================================================
+// LatencyHistogram
+// ============================================================================
+
+TEST_CASE("LatencyHistogram — empty histogram reports zero") {
+    LatencyHistogram h;
+    CHECK(h.count() == 0);
+    CHECK(h.total() == 0us);
+    CHECK(h.max() == 0us);
+    CHECK(h.percentile(0.5) == 0us);
+}
+
+TEST_CASE("LatencyHistogram — percentiles land within a factor of two") {
+    LatencyHistogram h;
+    for (int i = 0; i < 90; ++i)
+        h.add(100us);
+    for (int i = 0; i < 10; ++i)
+        h.add(5000us);
+
+    CHECK(h.count() == 100);
+    CHECK(h.total() == 90 * 100us + 10 * 5000us);
+    CHECK(h.max() == 5000us);
+    CHECK(h.percentile(0.5) >= 100us);
+    CHECK(h.percentile(0.5) < 200us);
+    CHECK(h.percentile(0.9) < 200us);
+    CHECK(h.percentile(0.99) >= 5000us);
+    CHECK(h.percentile(1.0) == 5000us); // capped at the largest sample
+}
+
+TEST_CASE("LatencyHistogram — samples past the last bucket are still counted") {
+    LatencyHistogram h;
+    h.add(std::chrono::hours(1));
+    h.add(-5us); // clock went backwards: treated as zero
+    CHECK(h.count() == 2);
+    CHECK(h.max() == std::chrono::hours(1));
+    CHECK(h.percentile(1.0) == std::chrono::hours(1));
+}
+
+// ============================================================================
+// RpcStats
+// ============================================================================
+
+static RpcTiming timing(std::chrono::microseconds wall, bool failed = false) {
+    RpcTiming t;
+    t.wall                 = wall;
+    t.bytes_sent           = 100;
+    t.bytes_received       = 1000;
+    t.failed               = failed;
+    t[RpcPhase::FirstByte] = wall / 2;
+    return t;
+}
+
+TEST_CASE("RpcStats — groups by caller and method") {
+    RpcStats stats;
+    stats.record("poll", "getblockchaininfo", timing(2ms));
+    stats.record("poll", "getblockchaininfo", timing(4ms, true));
+    stats.record("Mempool", "getblockchaininfo", timing(1ms));
+    stats.record_parse("poll", "getblockchaininfo", 50us);
+
+    auto snap = stats.snapshot();
+    REQUIRE(snap.size() == 2);
+    const auto& poll = snap.at({"poll", "getblockchaininfo"});
+    CHECK(poll.calls == 2);
+    CHECK(poll.errors == 1);
+    CHECK(poll.bytes_sent == 200);
+    CHECK(poll.bytes_received == 2000);
+    CHECK(poll.wall.max() == 4ms);
+    CHECK(poll.phase(RpcPhase::FirstByte).count() == 2);
+    CHECK(poll.phase(RpcPhase::Connect).count() == 0);
+    CHECK(poll.phase(RpcPhase::Parse).count() == 1);
+    CHECK(snap.at({"Mempool", "getblockchaininfo"}).calls == 1);
+
+    stats.reset();
+    CHECK(stats.snapshot().empty());
+}
+
+TEST_CASE("RpcStats — report lists the slowest rows first") {
+    RpcStats stats;
+    stats.record("poll", "getblockcount", timing(100us));
+    stats.record("Lua", "getblock", timing(3s));
+
+    const std::string report = stats.report();
+    CHECK(report.starts_with("caller"));
+    const auto slow = report.find("getblock ");
+    const auto fast = report.find("getblockcount");
+    REQUIRE(slow != std::string::npos);
+    REQUIRE(fast != std::string::npos);
+    CHECK(slow < fast);
+    CHECK(report.find("3.00 s") != std::string::npos);
+    CHECK(report.find("1.0 KB") != std::string::npos);
+}
@@ -155,3 +155,82 @@ TEST_CASE("is_height — non-digit characters") {
     CHECK_FALSE(is_height("12 34"));
     CHECK_FALSE(is_height("-1"));
 }
+
+// ============================================================================
+// RPC result bindings
+// ============================================================================
+
+TEST_CASE("PeerInfo binds a getpeerinfo element") {
+    const auto peers = json_bind_array<PeerInfo>(json::parse(R"([{
+        "id": 7, "addr": "203.0.113.5:8333", "network": "ipv4",
+        "servicesnames": ["NETWORK", "WITNESS"], "bytessent": 123456789012,
+        "bytesrecv": 42, "conntime": 1700000000, "pingtime": 0.0125, "version": 70016,
+        "subver": "/Satoshi:27.0.0/", "inbound": true, "bip152_hb_to": true,
+        "synced_blocks": 884231, "addr_processed": 10, "connection_type": "inbound",
+        "transport_protocol_type": "v2"
+    }, {"id": 8}])"));
+    REQUIRE(peers.size() == 2);
+    const PeerInfo& p = peers[0];
+    CHECK(p.id == 7);
+    CHECK(p.addr == "203.0.113.5:8333");
+    CHECK(p.services == "NETWORK, WITNESS");
+    CHECK(p.bytes_sent == 123456789012);
+    CHECK(p.ping_ms == 12.5);
+    CHECK(p.min_ping_ms == -1.0); // not reported yet
+    CHECK(p.inbound);
+    CHECK(p.bip152_hb_to);
+    CHECK(!p.bip152_hb_from);
+    CHECK(p.transport == "v2");
+    CHECK(peers[1].id == 8);
+    CHECK(peers[1].ping_ms == -1.0);
+}
+
+TEST_CASE("TxVin and TxVout bind getrawtransaction inputs and outputs") {
+    const json::cursor tx(R"({"vin":[{"coinbase":"03a0","sequence":4294967295},
+                                     {"txid":"ab","vout":3,"sequence":1}],
+                              "vout":[{"value":0.29,"n":0,"scriptPubKey":
+                                        {"type":"witness_v0_keyhash","address":"bc1qxyz"}},
+                                      {"value":0,"n":1,"scriptPubKey":{"type":"nulldata"}}]})");
+    const auto vin = json_bind_array<TxVin>(tx["vin"]);
+    REQUIRE(vin.size() == 2);
+    CHECK(vin[0].is_coinbase);
+    CHECK(vin[0].txid.empty());
+    CHECK(!vin[1].is_coinbase);
+    CHECK(vin[1].txid == "ab");
+    CHECK(vin[1].vout == 3);
+
+    const auto vout = json_bind_array<TxVout>(tx["vout"]);
+    REQUIRE(vout.size() == 2);
+    CHECK(vout[0].sats == 29000000);
+    CHECK(vout[0].value == 29000000 / 1e8);
+    CHECK(vout[0].type == "witness_v0_keyhash");
+    CHECK(vout[0].address == "bc1qxyz");
+    CHECK(vout[1].type == "nulldata");
+    CHECK(vout[1].address.empty());
+}
+
+TEST_CASE("BlockStat and SoftFork bind their RPC results") {
+    BlockStat b;
+    json_bind(json::parse(R"({"blockhash":"00ff","height":5,"time":1231006505,"total_size":0,
+                              "total_weight":0,"txs":1,"avgfee":0})"),
+              b);
+    CHECK(b.height == 5);
+    CHECK(b.txs == 1);
+    CHECK(b.time == 1231006505);
+    CHECK(b.hash == "00ff");
+
+    SoftFork f;
+    json_bind(json::parse(R"({"type":"bip9","active":false,"bip9":{"bit":2,
+        "start_time":1619222400,"timeout":1628640000,"min_activation_height":709632,
+        "status":"started","since":681408,
+        "statistics":{"period":2016,"threshold":1815,"elapsed":100,"count":90}}})"),
+              f);
+    CHECK(f.type == "bip9");
+    CHECK(!f.active);
+    CHECK(f.height == -1);
+    CHECK(f.bip9_status == "started");
+    CHECK(f.bip9_since == 681408);
+    CHECK(f.bip9_min_activation == 709632);
+    CHECK(f.bip9_period == 2016);
+    CHECK(f.bip9_count == 90);
+}